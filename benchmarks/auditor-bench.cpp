@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "auditor.hpp"
+#include "merkle-tree.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Latency of the checks made by an auditor: Auditor::doesExist and Auditor::isConsistent
+ *
+ * The proofs are taken from a tree of the given size before the timing starts, for leaves and
+ * old tree sizes drawn at random, so that only the checks are timed.
+ */
+class AuditorBenchmark
+{
+public:
+  AuditorBenchmark(size_t nLeaves, size_t nChecks)
+    : m_nLeaves(std::max<size_t>(nLeaves, 1))
+    , m_nChecks(nChecks)
+    , m_dir(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("delorean-auditor-bench-%%%%%%%%"))
+    , m_loggerName("/benchmark/logger/tree")
+  {
+  }
+
+  ~AuditorBenchmark()
+  {
+    boost::filesystem::remove_all(m_dir);
+  }
+
+  void
+  run()
+  {
+    Db db;
+    db.open(m_dir.string());
+    MerkleTree tree(m_loggerName, db);
+
+    std::vector<Sha256Digest> leafHashes;
+    std::vector<Sha256Digest> rootHashes(1, Node::getEmptyHash());
+    for (uint64_t i = 0; i < m_nLeaves; i++) {
+      leafHashes.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+      tree.addLeaf(i, leafHashes.back());
+      rootHashes.push_back(tree.getRootHash());
+    }
+    tree.savePendingTree();
+
+    std::mt19937 random;
+    std::uniform_int_distribution<NonNegativeInteger> seqNoDistribution(0, m_nLeaves - 1);
+
+    std::vector<NonNegativeInteger> seqNos;
+    std::vector<std::vector<shared_ptr<Data>>> existenceProofs;
+    std::vector<std::vector<shared_ptr<Data>>> consistencyProofs;
+    for (size_t i = 0; i < m_nChecks; i++) {
+      seqNos.push_back(seqNoDistribution(random));
+      existenceProofs.push_back(tree.getExistenceProof(seqNos.back(), m_nLeaves));
+      consistencyProofs.push_back(tree.getConsistencyProof(seqNos.back() + 1, m_nLeaves));
+    }
+
+    size_t nExisting = 0;
+    printLatency("Auditor::doesExist", m_nChecks, timedExecute([&] {
+      for (size_t i = 0; i < m_nChecks; i++)
+        nExisting += Auditor::doesExist(seqNos[i], leafHashes[seqNos[i]],
+                                        m_nLeaves, rootHashes[m_nLeaves],
+                                        existenceProofs[i], m_loggerName);
+    }));
+
+    size_t nConsistent = 0;
+    printLatency("Auditor::isConsistent", m_nChecks, timedExecute([&] {
+      for (size_t i = 0; i < m_nChecks; i++)
+        nConsistent += Auditor::isConsistent(seqNos[i] + 1, rootHashes[seqNos[i] + 1],
+                                             m_nLeaves, rootHashes[m_nLeaves],
+                                             consistencyProofs[i], m_loggerName);
+    }));
+
+    // the claims checked together against the proofs of all of them
+    std::vector<shared_ptr<Data>> allProofs;
+    std::vector<Auditor::Claim> claims;
+    std::set<Name> proofNames;
+    for (size_t i = 0; i < m_nChecks; i++) {
+      claims.push_back(Auditor::Claim{seqNos[i], leafHashes[seqNos[i]]});
+      for (const auto& proof : existenceProofs[i]) {
+        if (proofNames.insert(proof->getName()).second)
+          allProofs.push_back(proof);
+      }
+    }
+
+    size_t nClaimed = 0;
+    printLatency("Auditor::doExist", m_nChecks, timedExecute([&] {
+      Auditor::ProofSet proofSet;
+      if (!proofSet.load(allProofs, m_loggerName))
+        return;
+
+      auto results = Auditor::doExist(claims, m_nLeaves, rootHashes[m_nLeaves], proofSet);
+      nClaimed = std::count(results.begin(), results.end(), true);
+    }));
+
+    if (nExisting != m_nChecks || nConsistent != m_nChecks || nClaimed != m_nChecks)
+      std::cerr << "ERROR: " << nExisting << " existing, " << nConsistent << " consistent, "
+                << nClaimed << " claimed of " << m_nChecks << " checks" << std::endl;
+  }
+
+private:
+  size_t m_nLeaves;
+  size_t m_nChecks;
+  boost::filesystem::path m_dir;
+  Name m_loggerName;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nLeaves = 100000;
+  size_t nChecks = 10000;
+  if (argc > 1)
+    nLeaves = boost::lexical_cast<size_t>(argv[1]);
+  if (argc > 2)
+    nChecks = boost::lexical_cast<size_t>(argv[2]);
+
+  ndn::delorean::benchmarks::AuditorBenchmark(nLeaves, nChecks).run();
+  return 0;
+}
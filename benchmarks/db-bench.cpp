@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "db.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+
+#include <sqlite3.h>
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Per-call latency of Db inserts and lookups
+ *
+ * The "cached" numbers go through Db, which reuses statements prepared in Db::open.  The
+ * "uncached" numbers run the same SQL on a second database of the same schema, preparing and
+ * finalizing the statement on every call, which is what Db used to do.
+ */
+class DbBenchmark
+{
+public:
+  explicit
+  DbBenchmark(size_t nLeaves)
+    : m_nLeaves(nLeaves)
+    , m_dir(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("delorean-db-bench-%%%%%%%%"))
+  {
+    m_db.open((m_dir / "cached").string());
+
+    Db schema;
+    schema.open((m_dir / "uncached").string());
+    sqlite3_open((m_dir / "uncached" / "sig-logger.db").c_str(), &m_rawDb);
+
+    ndn::DigestSha256 sig;
+    m_subtree.setName(Name("/logger/tree/5/0/complete/digest"));
+    m_subtree.setContent(make_shared<ndn::Buffer>(32 * 32));
+    m_subtree.setSignature(sig);
+    m_subtree.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+    m_subtree.wireEncode();
+  }
+
+  ~DbBenchmark()
+  {
+    sqlite3_close(m_rawDb);
+    boost::filesystem::remove_all(m_dir);
+  }
+
+  void
+  run()
+  {
+    Name dataName("/benchmark/data/name/with/some/components");
+
+    printLatency("insertLeafData (cached)", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++)
+        m_db.insertLeafData(Leaf(dataName, i, i, 0));
+    }));
+
+    printLatency("insertLeafData (uncached)", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++)
+        runUncached("INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo, timestamp, isCert)"
+                    " VALUES (?, ?, ?, ?, 0)", i, &dataName.wireEncode());
+    }));
+
+    printLatency("getLeaf (cached)", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++)
+        m_db.getLeaf(i);
+    }));
+
+    printLatency("getLeaf (uncached)", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++)
+        runUncached("SELECT dataName, signerSeqNo, timestamp, cert FROM leaves WHERE dataSeqNo=?",
+                    i, nullptr);
+    }));
+
+    size_t nTrees = m_nLeaves / 32;
+
+    printLatency("insertSubTreeData (cached)", nTrees, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < nTrees; i++)
+        m_db.insertSubTreeData(5, i * 32, m_subtree);
+    }));
+
+    printLatency("insertSubTreeData (uncached)", nTrees, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < nTrees; i++)
+        runUncached("INSERT INTO cTrees (level, seqNo, data) VALUES (5, ?, ?)",
+                    i * 32, &m_subtree.wireEncode());
+    }));
+
+    printLatency("getSubTreeData (cached)", nTrees, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < nTrees; i++)
+        m_db.getSubTreeData(5, i * 32);
+    }));
+
+    printLatency("getSubTreeData (uncached)", nTrees, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < nTrees; i++)
+        runUncached("SELECT data FROM cTrees WHERE level=5 AND seqNo=?", i * 32, nullptr);
+    }));
+  }
+
+private:
+  void
+  runUncached(const char* sql, const NonNegativeInteger& seqNo, const Block* block)
+  {
+    sqlite3_stmt* statement;
+    sqlite3_prepare_v2(m_rawDb, sql, -1, &statement, nullptr);
+    sqlite3_bind_int64(statement, 1, seqNo);
+    if (block != nullptr) {
+      sqlite3_bind_blob(statement, 2, block->wire(), block->size(), SQLITE_TRANSIENT);
+      if (sqlite3_bind_parameter_count(statement) > 2) {
+        sqlite3_bind_int64(statement, 3, 0);
+        sqlite3_bind_int64(statement, 4, seqNo);
+      }
+    }
+    while (sqlite3_step(statement) == SQLITE_ROW)
+      ;
+    sqlite3_finalize(statement);
+  }
+
+private:
+  size_t m_nLeaves;
+  boost::filesystem::path m_dir;
+  Db m_db;
+  sqlite3* m_rawDb;
+  Data m_subtree;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nLeaves = 10000;
+  if (argc > 1)
+    nLeaves = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::DbBenchmark(nLeaves).run();
+  return 0;
+}
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "db.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Append and lookup latency of Db under different SQLite pragma profiles
+ *
+ * Each profile opens a fresh database with the given `db` config section, appends leaves
+ * one at a time (every append commits, as group-commit-size is left at 1) and then reads
+ * them back together with the complete subtrees written along the way.
+ */
+class DbPragmaBenchmark
+{
+public:
+  explicit
+  DbPragmaBenchmark(size_t nLeaves)
+    : m_nLeaves(nLeaves)
+    , m_dir(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("delorean-db-pragma-bench-%%%%%%%%"))
+  {
+    ndn::DigestSha256 sig;
+    m_subtree.setName(Name("/logger/tree/5/0/complete/digest"));
+    m_subtree.setContent(make_shared<ndn::Buffer>(32 * 32));
+    m_subtree.setSignature(sig);
+    m_subtree.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+    m_subtree.wireEncode();
+  }
+
+  ~DbPragmaBenchmark()
+  {
+    boost::filesystem::remove_all(m_dir);
+  }
+
+  void
+  run()
+  {
+    conf::ConfigSection defaults;
+    runProfile("default", defaults);
+
+    conf::ConfigSection wal;
+    wal.put("journal-mode", "wal");
+    wal.put("synchronous", "normal");
+    runProfile("wal", wal);
+
+    conf::ConfigSection walMmap = wal;
+    walMmap.put("cache-size", "-65536");
+    walMmap.put("mmap-size", "268435456");
+    runProfile("wal+mmap", walMmap);
+
+    conf::ConfigSection walMmapGroup = walMmap;
+    walMmapGroup.put("group-commit-size", "64");
+    runProfile("wal+mmap+group", walMmapGroup);
+  }
+
+private:
+  void
+  runProfile(const std::string& profile, const conf::ConfigSection& config)
+  {
+    Db db;
+    db.open((m_dir / profile).string(), config);
+
+    Name dataName("/benchmark/data/name/with/some/components");
+    size_t nTrees = m_nLeaves / 32;
+
+    printLatency(profile + ": append", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++) {
+        db.insertLeafData(Leaf(dataName, i, i, 0));
+        if ((i + 1) % 32 == 0)
+          db.insertSubTreeData(5, i - 31, m_subtree);
+      }
+      if (db.hasPendingCommit())
+        db.commit();
+    }));
+
+    printLatency(profile + ": getLeaf", m_nLeaves, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < m_nLeaves; i++)
+        db.getLeaf(i);
+    }));
+
+    printLatency(profile + ": getSubTreeData", nTrees, timedExecute([&] {
+      for (NonNegativeInteger i = 0; i < nTrees; i++)
+        db.getSubTreeData(5, i * 32);
+    }));
+  }
+
+private:
+  size_t m_nLeaves;
+  boost::filesystem::path m_dir;
+  Data m_subtree;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nLeaves = 10000;
+  if (argc > 1)
+    nLeaves = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::DbPragmaBenchmark(nLeaves).run();
+  return 0;
+}
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "leaf.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Latency of Leaf::getHash and Leaf::encode
+ *
+ * The first Leaf::getHash encodes the leaf, the encoding is cached for the next calls, so the
+ * two cases are timed apart.
+ */
+class LeafBenchmark
+{
+public:
+  explicit
+  LeafBenchmark(size_t nLeaves)
+  {
+    Name dataName("/benchmark/producer/data/with/a/realistic/length");
+    Name loggerName("/benchmark/logger/leaf");
+    for (size_t i = 0; i < nLeaves; i++)
+      m_leaves.emplace_back(Name(dataName).appendNumber(i), 1500000000 + i, i, i / 2, loggerName);
+  }
+
+  void
+  run()
+  {
+    std::vector<Sha256Digest> hashes(m_leaves.size());
+    printLatency("Leaf::getHash (encoding)", m_leaves.size(), timedExecute([&] {
+      for (size_t i = 0; i < m_leaves.size(); i++)
+        hashes[i] = m_leaves[i].getHash();
+    }));
+
+    printLatency("Leaf::getHash (encoded)", m_leaves.size(), timedExecute([&] {
+      for (size_t i = 0; i < m_leaves.size(); i++)
+        hashes[i] = m_leaves[i].getHash();
+    }));
+
+    size_t nBytes = 0;
+    printLatency("Leaf::encode", m_leaves.size(), timedExecute([&] {
+      for (const auto& leaf : m_leaves)
+        nBytes += leaf.encode()->wireEncode().size();
+    }));
+
+    if (nBytes == 0)
+      std::cerr << "ERROR: no leaf was encoded" << std::endl;
+  }
+
+private:
+  std::vector<Leaf> m_leaves;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nLeaves = 100000;
+  if (argc > 1)
+    nLeaves = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::LeafBenchmark(nLeaves).run();
+  return 0;
+}
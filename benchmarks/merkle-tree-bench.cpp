@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "merkle-tree.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Per-leaf latency of MerkleTree::addLeaf and MerkleTree::addLeaves
+ *
+ * MerkleTree::addLeaf is timed on trees of growing sizes, from 1000 leaves up by powers of
+ * ten, and MerkleTree::addLeaves on the largest one.  Each tree is backed by its own database,
+ * so that the completed subtrees are persisted in all cases.  The batch size is the number of
+ * leaves passed to each addLeaves call.
+ */
+class MerkleTreeBenchmark
+{
+public:
+  MerkleTreeBenchmark(size_t nLeaves, size_t batchSize)
+    : m_nLeaves(nLeaves)
+    , m_batchSize(batchSize)
+    , m_dir(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("delorean-merkle-tree-bench-%%%%%%%%"))
+  {
+    for (uint64_t i = 0; i < m_nLeaves; i++)
+      m_hashes.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+  }
+
+  ~MerkleTreeBenchmark()
+  {
+    boost::filesystem::remove_all(m_dir);
+  }
+
+  void
+  run()
+  {
+    // the work per leaf grows with the height of the tree and the size of the database
+    Sha256Digest rootHash1;
+    for (size_t nLeaves = std::min<size_t>(1000, m_nLeaves); ; nLeaves *= 10) {
+      nLeaves = std::min(nLeaves, m_nLeaves);
+      rootHash1 = addLeaf(nLeaves);
+      if (nLeaves == m_nLeaves)
+        break;
+    }
+
+    Db db2;
+    db2.open((m_dir / "batch").string());
+    MerkleTree tree2(Name("/benchmark/logger"), db2);
+
+    std::vector<std::vector<Sha256Digest>> batches;
+    for (size_t i = 0; i < m_nLeaves; i += m_batchSize)
+      batches.emplace_back(m_hashes.begin() + i,
+                           m_hashes.begin() + std::min(i + m_batchSize, m_nLeaves));
+
+    printLatency("MerkleTree::addLeaves", m_nLeaves, timedExecute([&] {
+      NonNegativeInteger seqNo = 0;
+      for (const auto& batch : batches) {
+        tree2.addLeaves(seqNo, batch);
+        seqNo += batch.size();
+      }
+    }));
+
+    if (rootHash1 != tree2.getRootHash())
+      std::cerr << "ERROR: root hashes of the two trees differ" << std::endl;
+  }
+
+private:
+  /**
+   * @brief Time MerkleTree::addLeaf on a new tree of @p nLeaves leaves
+   *
+   * @return the root hash of the tree
+   */
+  Sha256Digest
+  addLeaf(size_t nLeaves)
+  {
+    Db db;
+    db.open((m_dir / ("single-" + std::to_string(nLeaves))).string());
+    MerkleTree tree(Name("/benchmark/logger"), db);
+
+    printLatency("MerkleTree::addLeaf, " + std::to_string(nLeaves) + " leaves", nLeaves,
+                 timedExecute([&] {
+      for (size_t i = 0; i < nLeaves; i++)
+        tree.addLeaf(i, m_hashes[i]);
+    }));
+
+    return tree.getRootHash();
+  }
+
+private:
+  size_t m_nLeaves;
+  size_t m_batchSize;
+  boost::filesystem::path m_dir;
+  std::vector<Sha256Digest> m_hashes;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nLeaves = 100000;
+  size_t batchSize = 1000;
+  if (argc > 1)
+    nLeaves = boost::lexical_cast<size_t>(argv[1]);
+  if (argc > 2)
+    batchSize = boost::lexical_cast<size_t>(argv[2]);
+
+  ndn::delorean::benchmarks::MerkleTreeBenchmark(nLeaves, std::max<size_t>(batchSize, 1)).run();
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "node.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Latency of Node construction and of Node::computeHash
+ *
+ * Nodes are created the way the subtrees create them, with and without a hash, and the
+ * results are kept so that the construction cannot be optimized away.
+ */
+class NodeBenchmark
+{
+public:
+  explicit
+  NodeBenchmark(size_t nNodes)
+    : m_nNodes(nNodes)
+  {
+  }
+
+  void
+  run()
+  {
+    uint64_t one = 1;
+    Sha256Digest hash = computeSha256Digest(reinterpret_cast<const uint8_t*>(&one), sizeof(one));
+
+    std::vector<Node> nodes;
+    nodes.reserve(m_nNodes);
+    printLatency("Node::Node", m_nNodes, timedExecute([&] {
+      for (size_t i = 0; i < m_nNodes; i++)
+        nodes.emplace_back(i, 0, i + 1);
+    }));
+
+    std::vector<Node> hashedNodes;
+    hashedNodes.reserve(m_nNodes);
+    printLatency("Node::Node with hash", m_nNodes, timedExecute([&] {
+      for (size_t i = 0; i < m_nNodes; i++)
+        hashedNodes.emplace_back(i, 0, i + 1, hash);
+    }));
+
+    std::vector<NodePtr> nodePtrs;
+    nodePtrs.reserve(m_nNodes);
+    printLatency("make_shared<Node>", m_nNodes, timedExecute([&] {
+      for (size_t i = 0; i < m_nNodes; i++)
+        nodePtrs.push_back(make_shared<Node>(i, 0, i + 1, hash));
+    }));
+
+    Sha256Digest result = hash;
+    printLatency("Node::computeHash", m_nNodes, timedExecute([&] {
+      for (size_t i = 0; i < m_nNodes; i++)
+        result = Node::computeHash(Node::Index(i << 1, 1), result, hash);
+    }));
+
+    if (nodes.size() + hashedNodes.size() + nodePtrs.size() != 3 * m_nNodes || result == hash)
+      std::cerr << "ERROR: unexpected results" << std::endl;
+  }
+
+private:
+  size_t m_nNodes;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nNodes = 1000000;
+  if (argc > 1)
+    nNodes = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::NodeBenchmark(nNodes).run();
+  return 0;
+}
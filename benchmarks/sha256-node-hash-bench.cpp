@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "util/sha256-node-hash.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Per-hash latency of each node hash kernel supported by this CPU
+ *
+ * The jobs are hashed in batches of the given size, which is the number of nodes on one level
+ * of a subtree for small batches, and of a tree rebuild or of a large append for big ones.
+ */
+class Sha256NodeHashBenchmark
+{
+public:
+  explicit
+  Sha256NodeHashBenchmark(size_t nHashes)
+    : m_nHashes(nHashes)
+    , m_children(2)
+  {
+    m_children[1] = computeSha256Digest(m_children[0].data(), m_children[0].size());
+  }
+
+  void
+  run()
+  {
+    for (auto kernel : {Sha256Kernel::SCALAR, Sha256Kernel::LIBRARY, Sha256Kernel::SHA_NI,
+                        Sha256Kernel::AVX2, Sha256Kernel::AVX512}) {
+      if (!isSha256KernelSupported(kernel))
+        continue;
+
+      for (size_t batchSize : {1, 16, 1024}) {
+        std::vector<Sha256Digest> results(batchSize);
+        std::vector<Sha256NodeHashJob> jobs;
+        for (size_t i = 0; i < batchSize; i++)
+          jobs.push_back({1, 2 * i, &m_children[0], &m_children[1], &results[i]});
+
+        size_t nBatches = std::max<size_t>(m_nHashes / batchSize, 1);
+        printLatency(getKernelName(kernel) + ", batch " + std::to_string(batchSize),
+                     nBatches * batchSize, timedExecute([&] {
+          for (size_t i = 0; i < nBatches; i++)
+            computeNodeHashes(jobs.data(), jobs.size(), kernel);
+        }));
+      }
+    }
+  }
+
+private:
+  static std::string
+  getKernelName(Sha256Kernel kernel)
+  {
+    switch (kernel) {
+    case Sha256Kernel::LIBRARY:
+      return "library";
+    case Sha256Kernel::SHA_NI:
+      return "SHA-NI";
+    case Sha256Kernel::AVX2:
+      return "AVX2";
+    case Sha256Kernel::AVX512:
+      return "AVX-512";
+    default:
+      return "scalar";
+    }
+  }
+
+private:
+  size_t m_nHashes;
+  std::vector<Sha256Digest> m_children;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nHashes = 1000000;
+  if (argc > 1)
+    nHashes = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::Sha256NodeHashBenchmark(nHashes).run();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "sub-tree-binary.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Throughput of SubTreeBinary::addLeaf, updateLeaf, encode and decode
+ *
+ * The leaves are created up front, so that only the work done by the subtree is timed.
+ * Running the same benchmark on an older tree gives the before/after comparison.
+ */
+class SubTreeBinaryBenchmark
+{
+public:
+  explicit
+  SubTreeBinaryBenchmark(size_t nSubTrees)
+    : m_nSubTrees(nSubTrees)
+  {
+    uint64_t one = 1;
+    Sha256Digest hash = computeSha256Digest(reinterpret_cast<const uint8_t*>(&one), sizeof(one));
+
+    size_t nLeaves = 1 << SubTreeBinary::STEP;
+    for (size_t i = 0; i < nLeaves; i++)
+      m_leaves.push_back(make_shared<Node>(nLeaves + i, 0, nLeaves + i + 1, hash));
+  }
+
+  void
+  run()
+  {
+    Name loggerName("/benchmark/logger/tree");
+    Node::Index peakIndex(m_leaves.size(), SubTreeBinary::STEP);
+
+    size_t nComplete = 0;
+    std::vector<SubTreeBinary> subTrees;
+    subTrees.reserve(m_nSubTrees);
+    for (size_t i = 0; i < m_nSubTrees; i++)
+      subTrees.emplace_back(loggerName, peakIndex,
+                            [&] (const Node::Index&) { nComplete++; },
+                            [] (const Node::Index&, const NonNegativeInteger&,
+                                const Sha256Digest&) {});
+
+    printLatency("SubTreeBinary::addLeaf", m_nSubTrees * m_leaves.size(), timedExecute([&] {
+      for (auto& subTree : subTrees)
+        for (const auto& leaf : m_leaves)
+          subTree.addLeaf(leaf);
+    }));
+
+    printLatency("SubTreeBinary::encode", m_nSubTrees, timedExecute([&] {
+      for (const auto& subTree : subTrees)
+        subTree.encode();
+    }));
+
+    printLatency("SubTreeBinary::getNode", m_nSubTrees * m_leaves.size(), timedExecute([&] {
+      for (const auto& subTree : subTrees)
+        for (const auto& leaf : m_leaves)
+          subTree.getNode(leaf->getIndex());
+    }));
+
+    std::vector<shared_ptr<Data>> datas;
+    for (const auto& subTree : subTrees)
+      datas.push_back(subTree.encode());
+
+    std::vector<SubTreeBinary> decodedTrees;
+    decodedTrees.reserve(m_nSubTrees);
+    for (size_t i = 0; i < m_nSubTrees; i++)
+      decodedTrees.emplace_back(loggerName, [] (const Node::Index&) {},
+                                [] (const Node::Index&, const NonNegativeInteger&,
+                                    const Sha256Digest&) {});
+
+    printLatency("SubTreeBinary::decode", m_nSubTrees, timedExecute([&] {
+      for (size_t i = 0; i < m_nSubTrees; i++)
+        decodedTrees[i].decode(*datas[i]);
+    }));
+
+    // a parent subtree, each of whose leaves is updated as its child subtree grows
+    Node::Index parentIndex(0, 2 * SubTreeBinary::STEP);
+    NonNegativeInteger childRange = static_cast<NonNegativeInteger>(1) << SubTreeBinary::STEP;
+    std::vector<SubTreeBinary> parentTrees;
+    parentTrees.reserve(m_nSubTrees);
+    for (size_t i = 0; i < m_nSubTrees; i++)
+      parentTrees.emplace_back(loggerName, parentIndex,
+                               [] (const Node::Index&) {},
+                               [] (const Node::Index&, const NonNegativeInteger&,
+                                   const Sha256Digest&) {});
+
+    const size_t nUpdatesPerLeaf = 4;
+    const Sha256Digest& hash = m_leaves.front()->getHash();
+    printLatency("SubTreeBinary::updateLeaf",
+                 m_nSubTrees * m_leaves.size() * nUpdatesPerLeaf, timedExecute([&] {
+      for (auto& parentTree : parentTrees)
+        for (size_t i = 0; i < m_leaves.size(); i++)
+          for (size_t j = 1; j <= nUpdatesPerLeaf; j++)
+            parentTree.updateLeaf(i * childRange + j * childRange / nUpdatesPerLeaf, hash);
+    }));
+
+    if (nComplete != m_nSubTrees)
+      std::cerr << "ERROR: " << nComplete << " of " << m_nSubTrees << " subtrees completed"
+                << std::endl;
+  }
+
+private:
+  size_t m_nSubTrees;
+  std::vector<NodePtr> m_leaves;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nSubTrees = 10000;
+  if (argc > 1)
+    nSubTrees = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::SubTreeBinaryBenchmark(nSubTrees).run();
+  return 0;
+}
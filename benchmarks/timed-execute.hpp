@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_BENCHMARKS_TIMED_EXECUTE_HPP
+#define NDN_DELOREAN_BENCHMARKS_TIMED_EXECUTE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Execute @p f and return the wall clock time it took
+ */
+template<typename F>
+time::nanoseconds
+timedExecute(const F& f)
+{
+  auto before = time::steady_clock::now();
+  f();
+  auto after = time::steady_clock::now();
+  return after - before;
+}
+
+/**
+ * @brief The options shared by all the benchmarks
+ */
+struct OutputOptions
+{
+  /// print one JSON object per line rather than a table
+  bool isJson;
+  /// the name of the benchmark program, which identifies the results in JSON output
+  std::string suite;
+};
+
+inline OutputOptions&
+getOutputOptions()
+{
+  static OutputOptions options{false, ""};
+  return options;
+}
+
+/**
+ * @brief Take the options shared by all the benchmarks out of @p argv
+ *
+ * With --json, the results are printed as JSON lines, which can be collected and compared
+ * across releases.  The other arguments are left in order for the benchmark to parse.
+ *
+ * @return the number of arguments left in @p argv
+ */
+inline int
+parseOutputOptions(int argc, char** argv)
+{
+  OutputOptions& options = getOutputOptions();
+  if (argc > 0) {
+    std::string program = argv[0];
+    options.suite = program.substr(program.find_last_of('/') + 1);
+  }
+
+  int nArgs = argc > 0 ? 1 : 0;
+  for (int i = nArgs; i < argc; i++) {
+    if (std::string(argv[i]) == "--json")
+      options.isJson = true;
+    else
+      argv[nArgs++] = argv[i];
+  }
+  return nArgs;
+}
+
+/**
+ * @brief Print the per-call latency of an operation repeated @p nCalls times
+ */
+inline void
+printLatency(const std::string& name, size_t nCalls, const time::nanoseconds& total)
+{
+  const OutputOptions& options = getOutputOptions();
+  int64_t latency = nCalls == 0 ? 0 : total.count() / nCalls;
+
+  if (options.isJson) {
+    // the names are plain ASCII without quotes, so they need no escaping
+    std::cout << "{\"suite\": \"" << options.suite << "\", \"benchmark\": \"" << name
+              << "\", \"ns_per_call\": " << latency << ", \"calls\": " << nCalls
+              << ", \"total_ns\": " << total.count() << "}" << std::endl;
+    return;
+  }
+
+  std::cout << std::left << std::setw(40) << name
+            << std::right << std::setw(12) << latency << " ns/call"
+            << std::setw(12) << nCalls << " calls" << std::endl;
+}
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_BENCHMARKS_TIMED_EXECUTE_HPP
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timed-execute.hpp"
+#include "verification-queue.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/filesystem.hpp>
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+namespace benchmarks {
+
+/**
+ * @brief Throughput of signature verification through VerificationQueue
+ *
+ * The same signed Data is verified with an increasing number of threads, the verdicts being
+ * delivered in order on the calling thread, as the logger does.  The speedup is relative to
+ * one thread.
+ */
+class VerificationQueueBenchmark
+{
+public:
+  explicit
+  VerificationQueueBenchmark(size_t nData)
+    : m_dir(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("delorean-verification-bench-%%%%%%%%"))
+    , m_keyChain(std::string("pib-sqlite3:").append(m_dir.string()),
+                 std::string("tpm-file:").append(m_dir.string()))
+  {
+    Name identity("/benchmark/signer");
+    m_keyChain.createIdentity(identity);
+    m_cert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(identity));
+
+    for (size_t i = 0; i < nData; i++) {
+      auto data = make_shared<Data>(Name("/benchmark/data").appendNumber(i));
+      data->setContent(make_shared<ndn::Buffer>(256));
+      m_keyChain.signByIdentity(*data, identity);
+      m_data.push_back(data);
+    }
+  }
+
+  ~VerificationQueueBenchmark()
+  {
+    boost::filesystem::remove_all(m_dir);
+  }
+
+  void
+  run()
+  {
+    size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    time::nanoseconds oneThreadTime(0);
+    for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+      size_t nValid = 0;
+      auto total = timedExecute([&] { nValid = verifyAll(nThreads); });
+      if (nThreads == 1)
+        oneThreadTime = total;
+
+      printLatency("verify, " + std::to_string(nThreads) + " threads", m_data.size(), total);
+      if (getOutputOptions().isJson)
+        continue;
+
+      std::cout << std::left << std::setw(40) << "  speedup"
+                << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+                << static_cast<double>(oneThreadTime.count()) / total.count()
+                << std::setw(12) << nValid << " valid" << std::endl;
+    }
+  }
+
+private:
+  size_t
+  verifyAll(size_t nThreads)
+  {
+    boost::asio::io_service io;
+    VerificationQueue queue(io, nThreads);
+
+    size_t nDelivered = 0;
+    size_t nValid = 0;
+    for (const auto& data : m_data) {
+      queue.submit([this, data] {
+          return ndn::Validator::verifySignature(*data, m_cert->getPublicKeyInfo()) ? 1 : 0;
+        },
+        [&] (int verdict) {
+          nDelivered++;
+          nValid += verdict;
+        });
+    }
+
+    while (nDelivered < m_data.size()) {
+      io.poll();
+      io.reset();
+      std::this_thread::yield();
+    }
+
+    return nValid;
+  }
+
+private:
+  boost::filesystem::path m_dir;
+  ndn::KeyChain m_keyChain;
+  shared_ptr<ndn::IdentityCertificate> m_cert;
+  std::vector<shared_ptr<Data>> m_data;
+};
+
+} // namespace benchmarks
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  argc = ndn::delorean::benchmarks::parseOutputOptions(argc, argv);
+
+  size_t nData = 2000;
+  if (argc > 1)
+    nData = boost::lexical_cast<size_t>(argv[1]);
+
+  ndn::delorean::benchmarks::VerificationQueueBenchmark(nData).run();
+  return 0;
+}
@@ -20,221 +20,360 @@
  */
 
 #include "auditor.hpp"
+#include "response-batch.hpp"
+#include "util/sha256-node-hash.hpp"
 
-#include <ndn-cxx/util/digest.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include <limits>
+#include <thread>
 
 namespace ndn {
 namespace delorean {
 
-bool
-Auditor::doesExist(const NonNegativeInteger& seqNo,
-                   ndn::ConstBufferPtr hash,
-                   const NonNegativeInteger& rootNextSeqNo,
-                   ndn::ConstBufferPtr rootHash,
-                   const std::vector<shared_ptr<Data>>& proofs,
-                   const Name& loggerName)
-{
-  BOOST_ASSERT(rootHash != nullptr);
-  BOOST_ASSERT(hash != nullptr);
+namespace {
 
-  std::map<Node::Index, ConstSubTreeBinaryPtr> trees;
+/**
+ * @brief Get the level of the root of a tree with @p nextSeqNo leaves
+ */
+size_t
+getRootLevel(const NonNegativeInteger& nextSeqNo)
+{
+  size_t rootLevel = 0;
+  NonNegativeInteger seqNo = nextSeqNo - 1;
+  while (seqNo != 0) {
+    rootLevel++;
+    seqNo = seqNo >> 1;
+  }
+  return rootLevel;
+}
 
-  if (!loadProof(trees, proofs, loggerName))
-    return false;
+/**
+ * @brief Decode one proof, nullptr if it is malformed
+ */
+SubTreeBinaryPtr
+decodeProof(const Data& proof, const Name& loggerName)
+{
+  try {
+    auto subtree =
+      make_shared<SubTreeBinary>(loggerName,
+                                 [] (const Node::Index& idx) {},
+                                 [] (const Node::Index&,
+                                     const NonNegativeInteger& seqNo,
+                                     const Sha256Digest& hash) {});
+    subtree->decode(proof);
+    return subtree;
+  }
+  catch (SubTreeBinary::Error&) {
+    return nullptr;
+  }
+  catch (Node::Error&) {
+    return nullptr;
+  }
+  catch (tlv::Error&) {
+    return nullptr;
+  }
+}
 
-  // std::cerr << "Loaded" << std::endl;
+} // namespace
 
-  size_t rootLevel = 0;
-  NonNegativeInteger tmpSeqNo = rootNextSeqNo - 1;
-  while (tmpSeqNo != 0) {
-    rootLevel++;
-    tmpSeqNo = tmpSeqNo >> 1;
+bool
+Auditor::ProofSet::load(const std::vector<shared_ptr<Data>>& proofs, const Name& loggerName,
+                        size_t nThreads)
+{
+  m_trees.clear();
+
+  // each thread decodes every nThreads-th proof into its own slots
+  std::vector<SubTreeBinaryPtr> trees(proofs.size());
+  auto decode = [&] (size_t first, size_t stride) {
+    for (size_t i = first; i < proofs.size(); i += stride)
+      trees[i] = decodeProof(*proofs[i], loggerName);
+  };
+
+  nThreads = std::min(nThreads, proofs.size());
+  if (nThreads <= 1)
+    decode(0, 1);
+  else {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nThreads; i++)
+      threads.emplace_back(decode, i, nThreads);
+    for (auto& thread : threads)
+      thread.join();
   }
 
-  if (rootLevel == 0) { // only one node
-    // std::cerr << "one level" << std::endl;
-    if (seqNo != 0)
+  for (const auto& tree : trees) {
+    if (tree == nullptr || !m_trees.insert(std::make_pair(tree->getPeakIndex(), tree)).second) {
+      m_trees.clear();
       return false;
-
-    auto it = trees.find(Node::Index(0, SubTreeBinary::SUB_TREE_DEPTH - 1));
-    if (it != trees.end()) {
-      // std::cerr << "find subtree" << std::endl;
-      auto node = it->second->getNode(Node::Index(0, 0));
-      if (node != nullptr && *node->getHash() == *hash && *hash == *rootHash)
-        return true;
-      else
-        return false;
     }
-    else
-      return false;
   }
+  return true;
+}
 
+ConstSubTreeBinaryPtr
+Auditor::ProofSet::find(const Node::Index& peakIndex) const
+{
+  auto it = m_trees.find(peakIndex);
+  if (it == m_trees.end())
+    return nullptr;
+  return it->second;
+}
 
-  NonNegativeInteger childSeqMask = 1;
-  NonNegativeInteger childSeqNo = seqNo;
-  size_t childLevel = 0;
-  ndn::ConstBufferPtr childHash = hash;
+bool
+Auditor::doesExist(const NonNegativeInteger& seqNo,
+                   const Sha256Digest& hash,
+                   const NonNegativeInteger& rootNextSeqNo,
+                   const Sha256Digest& rootHash,
+                   const std::vector<shared_ptr<Data>>& proofs,
+                   const Name& loggerName)
+{
+  ProofSet proofSet;
+  if (!proofSet.load(proofs, loggerName))
+    return false;
 
-  NonNegativeInteger parentSeqMask = (~0ul) << 1;
-  NonNegativeInteger parentSeqNo = childSeqNo & parentSeqMask;
-  size_t parentLevel = 1;
+  return doesExist(seqNo, hash, rootNextSeqNo, rootHash, proofSet);
+}
 
-  Node::Index treePeakIndex(0, 0);
-  ConstSubTreeBinaryPtr subTree;
+bool
+Auditor::doesExist(const NonNegativeInteger& seqNo,
+                   const Sha256Digest& hash,
+                   const NonNegativeInteger& rootNextSeqNo,
+                   const Sha256Digest& rootHash,
+                   const ProofSet& proofSet)
+{
+  return doExist({Claim{seqNo, hash}}, rootNextSeqNo, rootHash, proofSet).front();
+}
 
-  do { // get parent hash
-    Node::Index tmpIndex =
-      SubTreeBinary::toSubTreePeakIndex(Node::Index(childSeqNo, childLevel));
+std::vector<bool>
+Auditor::doExist(const std::vector<Claim>& claims,
+                 const NonNegativeInteger& rootNextSeqNo,
+                 const Sha256Digest& rootHash,
+                 const ProofSet& proofSet)
+{
+  std::vector<bool> results(claims.size(), false);
+  size_t rootLevel = getRootLevel(rootNextSeqNo);
 
-    // std::cerr << "peak: " << tmpIndex.level << ", " << tmpIndex.seqNo << std::endl;
-    if (tmpIndex != treePeakIndex) {
-      treePeakIndex = tmpIndex;
-      auto it = trees.find(treePeakIndex);
-      if (it != trees.end() && it->second != nullptr) {
-        subTree = it->second;
-      }
-      else
-        return false;
+  if (rootLevel == 0) { // only one node
+    auto subTree = proofSet.find(Node::Index(0, SubTreeBinary::STEP));
+    auto node = subTree != nullptr ? subTree->getNode(Node::Index(0, 0)) : nullptr;
+    for (size_t i = 0; i < claims.size(); i++) {
+      results[i] = claims[i].seqNo == 0 && node != nullptr &&
+                   node->getHash() == claims[i].hash && claims[i].hash == rootHash;
     }
+    return results;
+  }
 
-    // std::cerr << "Hey" << std::endl;
-    // right child or left child
-    ndn::util::Sha256 sha256;
-    if (childSeqMask & seqNo) { // right child
-      // std::cerr << "right" << std::endl;
-      // std::cerr << parentSeqNo << ", " << childLevel << std::endl;
-      auto leftChild = subTree->getNode(Node::Index(parentSeqNo, childLevel));
-      if (leftChild == nullptr && leftChild->getHash() == nullptr)
-        return false;
+  // the node each path has reached at the current level, claims with the same node share a path
+  struct Path
+  {
+    NonNegativeInteger seqNo;
+    Sha256Digest hash;
+  };
+  static const size_t NO_PATH = std::numeric_limits<size_t>::max();
+
+  std::vector<Path> paths;
+  std::vector<size_t> claimPaths(claims.size(), NO_PATH);
+  std::map<std::pair<NonNegativeInteger, Sha256Digest>, size_t> pathIndex;
+  for (size_t i = 0; i < claims.size(); i++) {
+    if (claims[i].seqNo >= rootNextSeqNo)
+      continue;
+
+    auto key = std::make_pair(claims[i].seqNo, claims[i].hash);
+    auto it = pathIndex.find(key);
+    if (it == pathIndex.end()) {
+      it = pathIndex.insert(std::make_pair(key, paths.size())).first;
+      paths.push_back(Path{claims[i].seqNo, claims[i].hash});
+    }
+    claimPaths[i] = it->second;
+  }
 
-      // std::cerr << "found node" << std::endl;
-      sha256 << parentLevel << parentSeqNo;
-      sha256.update(leftChild->getHash()->buf(), leftChild->getHash()->size());
-      sha256.update(childHash->buf(), childHash->size());
+  for (size_t level = 0; level < rootLevel; level++) {
+    NonNegativeInteger interval = static_cast<NonNegativeInteger>(1) << level;
+
+    // the siblings are kept apart, so that the jobs can point at them
+    std::vector<Sha256Digest> siblings(paths.size());
+    std::vector<Sha256Digest> parents(paths.size());
+    std::vector<size_t> parentPaths(paths.size(), NO_PATH);
+    std::vector<Sha256NodeHashJob> jobs;
+    jobs.reserve(paths.size());
+
+    Node::Index treePeakIndex(0, 0);
+    ConstSubTreeBinaryPtr subTree;
+    for (size_t i = 0; i < paths.size(); i++) {
+      const Path& path = paths[i];
+      Node::Index peakIndex = SubTreeBinary::toSubTreePeakIndex(Node::Index(path.seqNo, level));
+      if (subTree == nullptr || peakIndex != treePeakIndex) {
+        treePeakIndex = peakIndex;
+        subTree = proofSet.find(treePeakIndex);
+      }
+      if (subTree == nullptr)
+        continue;
+
+      NonNegativeInteger parentSeqNo = (path.seqNo >> (level + 1)) << (level + 1);
+      Sha256NodeHashJob job{level + 1, parentSeqNo, nullptr, nullptr, &parents[i]};
+      if (path.seqNo != parentSeqNo) { // right child
+        auto leftChild = subTree->getNode(Node::Index(parentSeqNo, level));
+        if (leftChild == nullptr || !leftChild->hasHash())
+          continue;
+        siblings[i] = leftChild->getHash();
+        job.left = &siblings[i];
+        job.right = &path.hash;
+      }
+      else { // left child
+        siblings[i] = Node::getEmptyHash();
+        if (rootNextSeqNo > path.seqNo + interval) {
+          auto rightChild = subTree->getNode(Node::Index(path.seqNo + interval, level));
+          if (rightChild == nullptr || !rightChild->hasHash())
+            continue;
+          siblings[i] = rightChild->getHash();
+        }
+        job.left = &path.hash;
+        job.right = &siblings[i];
+      }
+      jobs.push_back(job);
+      parentPaths[i] = 0;
     }
-    else { // left child
-      // std::cerr << "left" << std::endl;
-      ndn::ConstBufferPtr rightChildHash = Node::getEmptyHash();
-      if (rootNextSeqNo > childSeqNo + (1 << childLevel)) {
-        // std::cerr << childSeqNo + (1 << childLevel) << ", " << childLevel << std::endl;
-        auto rightChild = subTree->getNode(Node::Index(childSeqNo + (1 << childLevel), childLevel));
-        if (rightChild == nullptr || rightChild->getHash() == nullptr)
-          return false;
-        rightChildHash = rightChild->getHash();
-        // std::cerr << "left done" << std::endl;
+    computeNodeHashes(jobs.data(), jobs.size());
+
+    // join the paths that have reached the same parent with the same hash
+    std::vector<Path> nextPaths;
+    pathIndex.clear();
+    for (size_t i = 0; i < paths.size(); i++) {
+      if (parentPaths[i] == NO_PATH)
+        continue;
+
+      NonNegativeInteger parentSeqNo = (paths[i].seqNo >> (level + 1)) << (level + 1);
+      auto key = std::make_pair(parentSeqNo, parents[i]);
+      auto it = pathIndex.find(key);
+      if (it == pathIndex.end()) {
+        it = pathIndex.insert(std::make_pair(key, nextPaths.size())).first;
+        nextPaths.push_back(Path{parentSeqNo, parents[i]});
       }
-
-      sha256 << parentLevel << parentSeqNo;
-      sha256.update(childHash->buf(), childHash->size());
-      sha256.update(rightChildHash->buf(), rightChildHash->size());
+      parentPaths[i] = it->second;
     }
 
-    childSeqMask = childSeqMask << 1;
-    childSeqNo = parentSeqNo;
-    childLevel = parentLevel;
-    childHash = sha256.computeDigest();
-
-    parentSeqMask = parentSeqMask << 1;
-    parentSeqNo = childSeqNo & parentSeqMask;
-    parentLevel++;
-
-  } while (childLevel < rootLevel);
+    for (auto& claimPath : claimPaths) {
+      if (claimPath != NO_PATH)
+        claimPath = parentPaths[claimPath];
+    }
+    paths.swap(nextPaths);
+  }
 
-  // std::cerr << "done" << std::endl;
+  for (size_t i = 0; i < claims.size(); i++)
+    results[i] = claimPaths[i] != NO_PATH && paths[claimPaths[i]].hash == rootHash;
 
-  return (*childHash == *rootHash);
+  return results;
 }
 
 bool
 Auditor::isConsistent(const NonNegativeInteger& oldRootNextSeqNo,
-                      ndn::ConstBufferPtr oldRootHash,
+                      const Sha256Digest& oldRootHash,
                       const NonNegativeInteger& newRootNextSeqNo,
-                      ndn::ConstBufferPtr newRootHash,
+                      const Sha256Digest& newRootHash,
                       const std::vector<shared_ptr<Data>>& proofs,
                       const Name& loggerName)
 {
-  BOOST_ASSERT(oldRootHash != nullptr);
-  BOOST_ASSERT(newRootHash != nullptr);
-
-  if (oldRootNextSeqNo > newRootNextSeqNo)
+  ProofSet proofSet;
+  if (!proofSet.load(proofs, loggerName))
     return false;
 
-  std::map<Node::Index, ConstSubTreeBinaryPtr> trees;
-  if (!loadProof(trees, proofs, loggerName))
-    return false;
+  return isConsistent(oldRootNextSeqNo, oldRootHash, newRootNextSeqNo, newRootHash, proofSet);
+}
 
-  // std::cerr << "1" << std::endl;
+bool
+Auditor::isConsistent(const NonNegativeInteger& oldRootNextSeqNo,
+                      const Sha256Digest& oldRootHash,
+                      const NonNegativeInteger& newRootNextSeqNo,
+                      const Sha256Digest& newRootHash,
+                      const ProofSet& proofSet)
+{
+  if (oldRootNextSeqNo > newRootNextSeqNo)
+    return false;
 
   // get boundary leaf:
   NonNegativeInteger leafSeqNo = oldRootNextSeqNo - 1;
-  NonNegativeInteger treeSeqNo = leafSeqNo & ((~0) << (SubTreeBinary::SUB_TREE_DEPTH - 1));
-  auto it = trees.find(Node::Index(treeSeqNo, SubTreeBinary::SUB_TREE_DEPTH - 1));
-  if (it == trees.end())
+  NonNegativeInteger treeSeqNo = (leafSeqNo >> SubTreeBinary::STEP) << SubTreeBinary::STEP;
+  auto subTree = proofSet.find(Node::Index(treeSeqNo, SubTreeBinary::STEP));
+  if (subTree == nullptr)
     return false;
 
-  auto leaf = it->second->getNode(Node::Index(leafSeqNo, 0));
-  if (leaf == nullptr || leaf->getHash() == nullptr)
+  auto leaf = subTree->getNode(Node::Index(leafSeqNo, 0));
+  if (leaf == nullptr || !leaf->hasHash())
     return false;
 
-  if (!doesExist(leafSeqNo, leaf->getHash(), oldRootNextSeqNo, oldRootHash,
-                 proofs, loggerName))
+  if (!doesExist(leafSeqNo, leaf->getHash(), oldRootNextSeqNo, oldRootHash, proofSet))
     return false;
 
-  // std::cerr << "2" << std::endl;
+  if (oldRootNextSeqNo == newRootNextSeqNo)
+    return oldRootHash == newRootHash;
 
-  if (oldRootNextSeqNo == newRootNextSeqNo) {
-    if (*oldRootHash == *newRootHash)
-      return true;
-    else
-      return false;
-  }
+  return doesExist(leafSeqNo, leaf->getHash(), newRootNextSeqNo, newRootHash, proofSet);
+}
 
-  // std::cerr << "3" << std::endl;
+bool
+Auditor::loadProofBundle(const Block& content, std::vector<shared_ptr<Data>>& proofs)
+{
+  try {
+    Block bundle = content;
+    bundle.parse();
 
-  if (!doesExist(leafSeqNo, leaf->getHash(), newRootNextSeqNo, newRootHash,
-                 proofs, loggerName))
-    return false;
+    for (const auto& element : bundle.elements()) {
+      if (element.type() != ndn::tlv::Data)
+        return false;
 
-  // std::cerr << "4" << std::endl;
+      proofs.push_back(make_shared<Data>(element));
+    }
+  }
+  catch (tlv::Error&) {
+    return false;
+  }
 
   return true;
 }
 
 bool
-Auditor::loadProof(std::map<Node::Index, ConstSubTreeBinaryPtr>& trees,
-                   const std::vector<shared_ptr<Data>>& proofs,
-                   const Name& loggerName)
+Auditor::isResponseAuthentic(const Data& responseData, const ndn::PublicKey& key,
+                             LoggerResponse& response)
 {
   try {
-    for (auto proof : proofs) {
-      // std::cerr << proof->getName() << std::endl;
-      auto subtree =
-        make_shared<SubTreeBinary>(loggerName,
-                                   [] (const Node::Index& idx) {},
-                                   [] (const Node::Index&,
-                                       const NonNegativeInteger& seqNo,
-                                       ndn::ConstBufferPtr hash) {});
-      subtree->decode(*proof);
-
-      // std::cerr << subtree->getPeakIndex().level << ", " << subtree->getPeakIndex().seqNo << std::endl;
-      if (trees.find(subtree->getPeakIndex()) == trees.end())
-        trees[subtree->getPeakIndex()] = subtree;
-      else
-        return false;
-    }
+    response.wireDecode(responseData.getContent().blockFromValue());
+
+    if (!response.hasBatchProof())
+      return ndn::Validator::verifySignature(responseData, key);
+
+    auto root = response.getBatchRoot();
+    if (!ndn::Validator::verifySignature(*root, key))
+      return false;
+
+    Sha256Digest rootHash;
+    if (!toSha256Digest(root->getContent().value(), root->getContent().value_size(), rootHash))
+      return false;
+
+    Sha256Digest leafHash = response.computeBatchLeafHash(responseData.getName());
+    return ResponseBatch::computeRootHash(leafHash, response.getBatchIndex(),
+                                          response.getBatchPath()) == rootHash;
   }
-  catch (SubTreeBinary::Error& e) {
-    // std::cerr << e.what() << std::endl;
+  catch (tlv::Error&) {
     return false;
   }
-  catch (Node::Error& e) {
-    // std::cerr << e.what() << std::endl;
+  catch (LoggerResponse::Error&) {
     return false;
   }
-  catch (tlv::Error&) {
+  catch (ResponseBatch::Error&) {
     return false;
   }
+}
+
+bool
+Auditor::loadProof(std::map<Node::Index, ConstSubTreeBinaryPtr>& trees,
+                   const std::vector<shared_ptr<Data>>& proofs,
+                   const Name& loggerName)
+{
+  ProofSet proofSet;
+  if (!proofSet.load(proofs, loggerName))
+    return false;
 
+  trees = proofSet.getTrees();
   return true;
 }
 
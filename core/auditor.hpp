@@ -25,32 +25,133 @@
 #include "common.hpp"
 #include "node.hpp"
 #include "sub-tree-binary.hpp"
+#include "logger-response.hpp"
 #include "util/non-negative-integer.hpp"
-#include <ndn-cxx/encoding/buffer.hpp>
+#include "util/sha256-digest.hpp"
+#include <map>
 #include <vector>
 
+#include <ndn-cxx/security/public-key.hpp>
+
 namespace ndn {
 namespace delorean {
 
 class Auditor
 {
+public:
+  /**
+   * @brief The subtrees of a proof, decoded once and checked against any number of claims
+   */
+  class ProofSet
+  {
+  public:
+    /**
+     * @brief Decode @p proofs on @p nThreads threads, 0 decodes them on the calling thread
+     *
+     * @return false if a proof is malformed, or if two proofs have the same peak
+     */
+    bool
+    load(const std::vector<shared_ptr<Data>>& proofs, const Name& loggerName,
+         size_t nThreads = 0);
+
+    /**
+     * @brief Get the subtree whose peak is @p peakIndex, nullptr if there is none
+     */
+    ConstSubTreeBinaryPtr
+    find(const Node::Index& peakIndex) const;
+
+    const std::map<Node::Index, ConstSubTreeBinaryPtr>&
+    getTrees() const
+    {
+      return m_trees;
+    }
+
+  private:
+    std::map<Node::Index, ConstSubTreeBinaryPtr> m_trees;
+  };
+
+  /**
+   * @brief A leaf claimed to be in the log
+   */
+  struct Claim
+  {
+    NonNegativeInteger seqNo;
+    Sha256Digest hash;
+  };
+
 public:
   static bool
   doesExist(const NonNegativeInteger& seqNo,
-            ndn::ConstBufferPtr hash,
+            const Sha256Digest& hash,
             const NonNegativeInteger& rootNextSeqNo,
-            ndn::ConstBufferPtr rootHash,
+            const Sha256Digest& rootHash,
             const std::vector<shared_ptr<Data>>& proofs,
             const Name& loggerName);
 
+  static bool
+  doesExist(const NonNegativeInteger& seqNo,
+            const Sha256Digest& hash,
+            const NonNegativeInteger& rootNextSeqNo,
+            const Sha256Digest& rootHash,
+            const ProofSet& proofSet);
+
+  /**
+   * @brief Check many claims against one root in a single pass
+   *
+   * The paths of all the claims are walked up together, level by level.  The nodes of a level
+   * are hashed in one batch, and claims whose paths have joined are only hashed once above.
+   *
+   * @return whether each claim is in the tree, in the order of @p claims
+   */
+  static std::vector<bool>
+  doExist(const std::vector<Claim>& claims,
+          const NonNegativeInteger& rootNextSeqNo,
+          const Sha256Digest& rootHash,
+          const ProofSet& proofSet);
+
   static bool
   isConsistent(const NonNegativeInteger& seqNo,
-               ndn::ConstBufferPtr hash,
+               const Sha256Digest& hash,
                const NonNegativeInteger& rootNextSeqNo,
-               ndn::ConstBufferPtr rootHash,
+               const Sha256Digest& rootHash,
                const std::vector<shared_ptr<Data>>& proofs,
                const Name& loggerName);
 
+  /**
+   * @brief Check consistency with a proof set decoded once for both roots
+   */
+  static bool
+  isConsistent(const NonNegativeInteger& oldRootNextSeqNo,
+               const Sha256Digest& oldRootHash,
+               const NonNegativeInteger& newRootNextSeqNo,
+               const Sha256Digest& newRootHash,
+               const ProofSet& proofSet);
+
+  /**
+   * @brief Append the subtrees carried by one segment of a proof bundle to @p proofs
+   *
+   * A proof bundle is served by the logger under /<logger>/proof, the content of each segment
+   * is a sequence of subtree Data packets.
+   *
+   * @return false if the content is malformed
+   */
+  static bool
+  loadProofBundle(const Block& content, std::vector<shared_ptr<Data>>& proofs);
+
+  /**
+   * @brief Check that a log response comes from the logger
+   *
+   * The response Data is either signed by the logger, or carries a batch proof: then the batch
+   * root Data must be signed by the logger, and the inclusion path must lead from the response
+   * to the root hash in its content.
+   *
+   * @param key the public key the logger signs its responses with
+   * @param[out] response the decoded response
+   */
+  static bool
+  isResponseAuthentic(const Data& responseData, const ndn::PublicKey& key,
+                      LoggerResponse& response);
+
 NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   static bool
   loadProof(std::map<Node::Index, ConstSubTreeBinaryPtr>& trees,
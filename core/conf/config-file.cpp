@@ -71,6 +71,12 @@ ConfigFile::parse()
       m_dbDir = absolute(section.second.data(), path(m_filename).parent_path()).string();
       hasDbDir = true;
     }
+    else if (boost::iequals(section.first, "db")) {
+      m_dbConfig = section.second;
+    }
+    else if (boost::iequals(section.first, "pipeline")) {
+      m_pipelineConfig = section.second;
+    }
     else if (boost::iequals(section.first, "policy")) {
       m_policy = section.second;
       hasPolicy = true;
@@ -54,6 +54,24 @@ public:
     return m_dbDir;
   }
 
+  /**
+   * @brief Get the optional db section, empty if the config file does not have one
+   */
+  const ConfigSection&
+  getDbConfig() const
+  {
+    return m_dbConfig;
+  }
+
+  /**
+   * @brief Get the optional pipeline section, empty if the config file does not have one
+   */
+  const ConfigSection&
+  getPipelineConfig() const
+  {
+    return m_pipelineConfig;
+  }
+
   const ConfigSection&
   getPolicy() const
   {
@@ -70,6 +88,8 @@ private:
   std::string m_filename;
   Name m_loggerName;
   std::string m_dbDir;
+  ConfigSection m_dbConfig;
+  ConfigSection m_pipelineConfig;
   ConfigSection m_policy;
   ConfigSection m_validatorRule;
 };
@@ -24,6 +24,8 @@
 #include <sqlite3.h>
 #include <string>
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 
 namespace ndn {
 namespace delorean {
@@ -69,7 +71,14 @@ static const std::string INITIALIZATION =
   "    cert                  BLOB                \n"
   "  );                                          \n"
   "CREATE UNIQUE INDEX IF NOT EXISTS             \n"
-  "  leavesIndex ON leaves(dataSeqNo);           \n";
+  "  leavesIndex ON leaves(dataSeqNo);           \n"
+  "                                              \n"
+  "CREATE TABLE IF NOT EXISTS                    \n"
+  "  frontier(                                   \n"
+  "    id                    INTEGER PRIMARY KEY,\n"
+  "    nextLeafSeqNo         INTEGER NOT NULL,   \n"
+  "    data                  BLOB NOT NULL       \n"
+  "  );                                          \n";
 
 
 /**
@@ -94,18 +103,314 @@ sqlite3_column_block(sqlite3_stmt* statement, int column)
   return Block(sqlite3_column_blob(statement, column), sqlite3_column_bytes(statement, column));
 }
 
+/**
+ * A utility function to prepare a statement which is cached by Db for its whole lifetime.
+ */
+static sqlite3_stmt*
+prepareStatement(sqlite3* db, const char* sql)
+{
+  sqlite3_stmt* statement = nullptr;
+  if (sqlite3_prepare_v2(db, sql, -1, &statement, nullptr) != SQLITE_OK)
+    throw Db::Error(std::string("Cannot prepare statement: ") + sqlite3_errmsg(db));
+
+  return statement;
+}
+
+/**
+ * @brief Reset a cached statement when leaving the scope
+ *
+ * The statement is reset and its bindings are cleared, so that it is ready to be rebound
+ * by the next call and does not keep any read transaction open.
+ */
+class StatementResetter : noncopyable
+{
+public:
+  explicit
+  StatementResetter(sqlite3_stmt* statement)
+    : m_statement(statement)
+  {
+  }
+
+  ~StatementResetter()
+  {
+    if (m_statement != nullptr) {
+      sqlite3_reset(m_statement);
+      sqlite3_clear_bindings(m_statement);
+    }
+  }
+
+private:
+  sqlite3_stmt* m_statement;
+};
+
+/**
+ * A utility function to look up a subtree, first among the complete ones, then the pending ones.
+ * @p isComplete tells which one was found.
+ */
+static shared_ptr<Data>
+selectSubTree(sqlite3_stmt* selectCompleteTreeStmt, sqlite3_stmt* selectPendingTreeStmt,
+              size_t level, const NonNegativeInteger& seqNo, bool& isComplete)
+{
+  {
+    StatementResetter resetter(selectCompleteTreeStmt);
+    sqlite3_bind_int(selectCompleteTreeStmt, 1, level);
+    sqlite3_bind_int64(selectCompleteTreeStmt, 2, seqNo);
+
+    isComplete = true;
+    if (sqlite3_step(selectCompleteTreeStmt) == SQLITE_ROW)
+      return make_shared<Data>(sqlite3_column_block(selectCompleteTreeStmt, 0));
+  }
+
+  isComplete = false;
+
+  StatementResetter resetter(selectPendingTreeStmt);
+  sqlite3_bind_int(selectPendingTreeStmt, 1, level);
+  sqlite3_bind_int64(selectPendingTreeStmt, 2, seqNo);
+
+  shared_ptr<Data> result;
+  if (sqlite3_step(selectPendingTreeStmt) == SQLITE_ROW)
+    result = make_shared<Data>(sqlite3_column_block(selectPendingTreeStmt, 0));
+
+  return result;
+}
+
+/**
+ * A utility function to look up a leaf and its certificate.
+ */
+static std::pair<shared_ptr<Leaf>, shared_ptr<Data>>
+selectLeaf(sqlite3_stmt* selectLeafStmt, const NonNegativeInteger& seqNo)
+{
+  StatementResetter resetter(selectLeafStmt);
+
+  sqlite3_bind_int64(selectLeafStmt, 1, seqNo);
+
+  if (sqlite3_step(selectLeafStmt) == SQLITE_ROW) {
+    auto leaf = make_shared<Leaf>(Name(sqlite3_column_block(selectLeafStmt, 0)),
+                                  sqlite3_column_int64(selectLeafStmt, 2),
+                                  seqNo,
+                                  sqlite3_column_int64(selectLeafStmt, 1));
+
+    shared_ptr<Data> data;
+    if (sqlite3_column_bytes(selectLeafStmt, 3) != 0) {
+      data = make_shared<Data>(sqlite3_column_block(selectLeafStmt, 3));
+    }
+    return std::make_pair(leaf, data);
+  }
+  else {
+    return std::make_pair(nullptr, nullptr);
+  }
+}
+
+/**
+ * A utility function to walk a range of leaves with a single cursor.
+ */
+static size_t
+selectLeafRange(sqlite3_stmt* selectLeafRangeStmt,
+                const NonNegativeInteger& first, const NonNegativeInteger& last,
+                const Db::LeafCallback& callback)
+{
+  StatementResetter resetter(selectLeafRangeStmt);
+
+  sqlite3_bind_int64(selectLeafRangeStmt, 1, first);
+  sqlite3_bind_int64(selectLeafRangeStmt, 2, last);
+
+  static const Block EMPTY_CERT;
+  Leaf leaf(Name(), 0, 0, 0);
+  size_t nLeaves = 0;
+  while (sqlite3_step(selectLeafRangeStmt) == SQLITE_ROW) {
+    // rows come in ascending dataSeqNo, so the new dataSeqNo is never below the old signerSeqNo
+    leaf.setDataSeqNo(sqlite3_column_int64(selectLeafRangeStmt, 0));
+    leaf.setDataName(Name(sqlite3_column_block(selectLeafRangeStmt, 1)));
+    leaf.setSignerSeqNo(sqlite3_column_int64(selectLeafRangeStmt, 2));
+    leaf.setTimestamp(sqlite3_column_int64(selectLeafRangeStmt, 3));
+
+    if (sqlite3_column_bytes(selectLeafRangeStmt, 4) != 0)
+      callback(leaf, sqlite3_column_block(selectLeafRangeStmt, 4));
+    else
+      callback(leaf, EMPTY_CERT);
+
+    nLeaves++;
+  }
+
+  return nLeaves;
+}
+
+/**
+ * A utility function to walk a range of leaves with a single cursor, encoding each of them from
+ * its columns.
+ */
+static size_t
+selectEncodedLeafRange(sqlite3_stmt* selectLeafRangeStmt,
+                       const NonNegativeInteger& first, const NonNegativeInteger& last,
+                       const Db::EncodedLeafCallback& callback)
+{
+  StatementResetter resetter(selectLeafRangeStmt);
+
+  sqlite3_bind_int64(selectLeafRangeStmt, 1, first);
+  sqlite3_bind_int64(selectLeafRangeStmt, 2, last);
+
+  std::vector<uint8_t> wire;
+  size_t nLeaves = 0;
+  while (sqlite3_step(selectLeafRangeStmt) == SQLITE_ROW) {
+    // the blob must be fetched before its size
+    auto dataName = static_cast<const uint8_t*>(sqlite3_column_blob(selectLeafRangeStmt, 1));
+    size_t dataNameSize = sqlite3_column_bytes(selectLeafRangeStmt, 1);
+
+    Leaf::wireEncodeRow(wire, dataName, dataNameSize,
+                        sqlite3_column_int64(selectLeafRangeStmt, 3),
+                        sqlite3_column_int64(selectLeafRangeStmt, 0),
+                        sqlite3_column_int64(selectLeafRangeStmt, 2));
+    callback(wire.data(), wire.size());
+
+    nLeaves++;
+  }
+
+  return nLeaves;
+}
+
+static const char* SELECT_COMPLETE_TREE = "SELECT data FROM cTrees WHERE level=? AND seqNo=?";
+static const char* SELECT_PENDING_TREE = "SELECT data FROM pTrees WHERE level=? AND seqNo=?";
+static const char* SELECT_LEAF = "SELECT dataName, signerSeqNo, timestamp, cert\
+                                  FROM leaves WHERE dataSeqNo=?";
+static const char* SELECT_LEAF_RANGE = "SELECT dataSeqNo, dataName, signerSeqNo, timestamp, cert\
+                                        FROM leaves WHERE dataSeqNo>=? AND dataSeqNo<?\
+                                        ORDER BY dataSeqNo";
+
+/// milliseconds a connection waits for a lock held by another connection of the pool
+static const int BUSY_TIMEOUT = 5000;
+
+struct Db::ReadConnection : noncopyable
+{
+  ReadConnection()
+    : db(nullptr)
+    , selectCompleteTreeStmt(nullptr)
+    , selectPendingTreeStmt(nullptr)
+    , selectLeafStmt(nullptr)
+    , selectLeafRangeStmt(nullptr)
+  {
+  }
+
+  ~ReadConnection()
+  {
+    sqlite3_finalize(selectCompleteTreeStmt);
+    sqlite3_finalize(selectPendingTreeStmt);
+    sqlite3_finalize(selectLeafStmt);
+    sqlite3_finalize(selectLeafRangeStmt);
+    sqlite3_close(db);
+  }
+
+  sqlite3* db;
+  sqlite3_stmt* selectCompleteTreeStmt;
+  sqlite3_stmt* selectPendingTreeStmt;
+  sqlite3_stmt* selectLeafStmt;
+  sqlite3_stmt* selectLeafRangeStmt;
+};
+
+/**
+ * @brief Take an idle read connection from the pool, waiting for one if necessary,
+ *        and give it back when leaving the scope
+ */
+class Db::ReadConnectionGuard : noncopyable
+{
+public:
+  explicit
+  ReadConnectionGuard(Db& db)
+    : m_db(db)
+  {
+    std::unique_lock<std::mutex> lock(m_db.m_readersMutex);
+    m_db.m_readerReleased.wait(lock, [this] { return !m_db.m_idleReaders.empty(); });
+    m_reader = m_db.m_idleReaders.back();
+    m_db.m_idleReaders.pop_back();
+  }
+
+  ~ReadConnectionGuard()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_db.m_readersMutex);
+      m_db.m_idleReaders.push_back(m_reader);
+    }
+    m_db.m_readerReleased.notify_one();
+  }
+
+  ReadConnection*
+  operator->() const
+  {
+    return m_reader;
+  }
+
+private:
+  Db& m_db;
+  ReadConnection* m_reader;
+};
+
+Db::Db()
+  : m_db(nullptr)
+  , m_insertCompleteTreeStmt(nullptr)
+  , m_replaceCompleteTreeStmt(nullptr)
+  , m_insertPendingTreeStmt(nullptr)
+  , m_selectCompleteTreeStmt(nullptr)
+  , m_selectPendingTreeStmt(nullptr)
+  , m_selectPendingTreesStmt(nullptr)
+  , m_insertLeafStmt(nullptr)
+  , m_insertCertLeafStmt(nullptr)
+  , m_selectLeafStmt(nullptr)
+  , m_selectLeafRangeStmt(nullptr)
+  , m_selectNextLeafSeqNoStmt(nullptr)
+  , m_insertFrontierStmt(nullptr)
+  , m_selectFrontierStmt(nullptr)
+  , m_nextLeafSeqNo(0)
+  , m_nextCommittedLeafSeqNo(0)
+  , m_groupCommitSize(1)
+  , m_groupCommitWindow(10)
+  , m_isInTransaction(false)
+  , m_nGroupedAppends(0)
+  , m_nReadConnections(0)
+{
+}
+
+Db::~Db()
+{
+  m_idleReaders.clear();
+  m_readers.clear();
+
+  // make the last group durable, but nobody is left to be notified
+  if (m_isInTransaction)
+    sqlite3_exec(m_db, "COMMIT", nullptr, nullptr, nullptr);
+
+  // sqlite3_finalize is a harmless no-op on nullptr
+  sqlite3_finalize(m_insertCompleteTreeStmt);
+  sqlite3_finalize(m_replaceCompleteTreeStmt);
+  sqlite3_finalize(m_insertPendingTreeStmt);
+  sqlite3_finalize(m_selectCompleteTreeStmt);
+  sqlite3_finalize(m_selectPendingTreeStmt);
+  sqlite3_finalize(m_selectPendingTreesStmt);
+  sqlite3_finalize(m_insertLeafStmt);
+  sqlite3_finalize(m_insertCertLeafStmt);
+  sqlite3_finalize(m_selectLeafStmt);
+  sqlite3_finalize(m_selectLeafRangeStmt);
+  sqlite3_finalize(m_selectNextLeafSeqNoStmt);
+  sqlite3_finalize(m_insertFrontierStmt);
+  sqlite3_finalize(m_selectFrontierStmt);
+
+  sqlite3_close(m_db);
+}
+
 void
-Db::open(const std::string& dbDir)
+Db::open(const std::string& dbDir, const conf::ConfigSection& config)
 {
   // Determine the path of logger database
   if (dbDir == "")
     throw Error("Db: empty db path");
 
+  loadConfig(config);
+
   boost::filesystem::path dir = boost::filesystem::path(dbDir);
   boost::filesystem::create_directories(dir);
 
+  std::string dbFile = (dir / "sig-logger.db").string();
+
   // Open database
-  int result = sqlite3_open_v2((dir / "sig-logger.db").c_str(), &m_db,
+  int result = sqlite3_open_v2(dbFile.c_str(), &m_db,
                                SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
 #ifdef NDN_DELOREAN_DISABLE_SQLITE3_FS_LOCKING
                                "unix-dotfile"
@@ -117,6 +422,8 @@ Db::open(const std::string& dbDir)
   if (result != SQLITE_OK)
     throw Error("SigLogger DB cannot be opened/created: " + dbDir);
 
+  applyPragmas();
+
   // initialize SigLogger specific tables
   char* errorMessage = nullptr;
   result = sqlite3_exec(m_db, INITIALIZATION.c_str(), nullptr, nullptr, &errorMessage);
@@ -125,7 +432,139 @@ Db::open(const std::string& dbDir)
     throw Error("SigLogger DB cannot be initialized");
   }
 
-  getMaxLeafSeq();
+  // prepare the statements once, they are reset and rebound on every call
+  m_insertCompleteTreeStmt =
+    prepareStatement(m_db, "INSERT INTO cTrees (level, seqNo, data) VALUES (?, ?, ?)");
+  m_replaceCompleteTreeStmt =
+    prepareStatement(m_db, "INSERT OR REPLACE INTO cTrees (level, seqNo, data) VALUES (?, ?, ?)");
+  m_insertPendingTreeStmt =
+    prepareStatement(m_db, "INSERT OR REPLACE INTO pTrees (level, seqNo, data, nextLeafSeqNo)\
+                            VALUES (?, ?, ?, ?)");
+  m_selectCompleteTreeStmt = prepareStatement(m_db, SELECT_COMPLETE_TREE);
+  m_selectPendingTreeStmt = prepareStatement(m_db, SELECT_PENDING_TREE);
+  m_selectPendingTreesStmt =
+    prepareStatement(m_db, "SELECT data FROM pTrees ORDER BY level DESC");
+  m_insertLeafStmt =
+    prepareStatement(m_db, "INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo, timestamp, isCert)\
+                            VALUES (?, ?, ?, ?, 0)");
+  m_insertCertLeafStmt =
+    prepareStatement(m_db, "INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo, timestamp, isCert, cert)\
+                            VALUES (?, ?, ?, ?, 1, ?)");
+  m_selectLeafStmt = prepareStatement(m_db, SELECT_LEAF);
+  m_selectLeafRangeStmt = prepareStatement(m_db, SELECT_LEAF_RANGE);
+  // a lookup in leavesIndex, where count() would scan the whole table
+  m_selectNextLeafSeqNoStmt =
+    prepareStatement(m_db, "SELECT max(dataSeqNo) + 1 FROM leaves");
+  // there is at most one frontier, always in the row with id 0
+  m_insertFrontierStmt =
+    prepareStatement(m_db, "INSERT OR REPLACE INTO frontier (id, nextLeafSeqNo, data)\
+                            VALUES (0, ?, ?)");
+  m_selectFrontierStmt =
+    prepareStatement(m_db, "SELECT nextLeafSeqNo, data FROM frontier WHERE id=0");
+
+  loadNextLeafSeqNo();
+
+  openReadConnections(dbFile);
+}
+
+void
+Db::openReadConnections(const std::string& dbFile)
+{
+  // without wal, the writer needs readers to go away before it can commit
+  if (m_nReadConnections > 0)
+    sqlite3_busy_timeout(m_db, BUSY_TIMEOUT);
+
+  for (size_t i = 0; i < m_nReadConnections; i++) {
+    std::unique_ptr<ReadConnection> reader(new ReadConnection);
+
+    // each connection is used by one thread at a time, the pool does the locking
+    int result = sqlite3_open_v2(dbFile.c_str(), &reader->db,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+#ifdef NDN_DELOREAN_DISABLE_SQLITE3_FS_LOCKING
+                                 "unix-dotfile"
+#else
+                                 nullptr
+#endif
+                                 );
+    if (result != SQLITE_OK)
+      throw Error("SigLogger DB cannot be opened for reading: " + dbFile);
+
+    // wait, rather than fail, while the writer holds an exclusive lock to commit
+    sqlite3_busy_timeout(reader->db, BUSY_TIMEOUT);
+
+    // cache and mmap sizes are per connection, the other pragmas are up to the writer
+    for (const auto& pragma : m_pragmas) {
+      if (pragma.first == "cache_size" || pragma.first == "mmap_size") {
+        std::string sql = "PRAGMA " + pragma.first + "=" + pragma.second;
+        sqlite3_exec(reader->db, sql.c_str(), nullptr, nullptr, nullptr);
+      }
+    }
+
+    reader->selectCompleteTreeStmt = prepareStatement(reader->db, SELECT_COMPLETE_TREE);
+    reader->selectPendingTreeStmt = prepareStatement(reader->db, SELECT_PENDING_TREE);
+    reader->selectLeafStmt = prepareStatement(reader->db, SELECT_LEAF);
+    reader->selectLeafRangeStmt = prepareStatement(reader->db, SELECT_LEAF_RANGE);
+
+    m_idleReaders.push_back(reader.get());
+    m_readers.push_back(std::move(reader));
+  }
+}
+
+void
+Db::commit()
+{
+  std::vector<CommitCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    if (!m_isInTransaction)
+      return;
+
+    execute("COMMIT");
+    m_isInTransaction = false;
+    m_nGroupedAppends = 0;
+    m_nextCommittedLeafSeqNo = m_nextLeafSeqNo;
+    callbacks.swap(m_commitCallbacks);
+  }
+
+  // callbacks may write again
+  for (const auto& callback : callbacks)
+    callback();
+}
+
+void
+Db::whenCommitted(const CommitCallback& callback)
+{
+  if (m_isInTransaction)
+    m_commitCallbacks.push_back(callback);
+  else
+    callback();
+}
+
+void
+Db::runInTransaction(const function<void()>& writes)
+{
+  if (m_isInTransaction) {
+    writes();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    execute("BEGIN");
+    m_isInTransaction = true;
+  }
+
+  try {
+    writes();
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    sqlite3_exec(m_db, "ROLLBACK", nullptr, nullptr, nullptr);
+    m_isInTransaction = false;
+    throw;
+  }
+
+  commit();
 }
 
 bool
@@ -133,75 +572,83 @@ Db::insertSubTreeData(size_t level, const NonNegativeInteger& seqNo,
                       const Data& data,
                       bool isFull, const NonNegativeInteger& nextLeafSeqNo)
 {
-  sqlite3_stmt* statement;
-  if (isFull) {
-    sqlite3_prepare_v2(m_db,
-                       "INSERT INTO cTrees (level, seqNo, data) VALUES (?, ?, ?)",
-                       -1, &statement, nullptr);
-  }
-  else {
-    sqlite3_prepare_v2(m_db,
-                       "INSERT OR REPLACE INTO pTrees (level, seqNo, data, nextLeafSeqNo)\
-                        VALUES (?, ?, ?, ?)",
-                       -1, &statement, nullptr);
-  }
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  beginWrite();
+
+  return storeSubTreeData(m_insertCompleteTreeStmt, level, seqNo, data, isFull, nextLeafSeqNo);
+}
+
+bool
+Db::replaceSubTreeData(size_t level, const NonNegativeInteger& seqNo,
+                       const Data& data,
+                       bool isFull, const NonNegativeInteger& nextLeafSeqNo)
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  beginWrite();
+
+  if (!storeSubTreeData(m_replaceCompleteTreeStmt, level, seqNo, data, isFull, nextLeafSeqNo))
+    return false;
+
+  // until the commit, the lookups through the read connections still see the replaced subtree
+  if (isFull)
+    whenCommitted([this, level, seqNo] { m_subTreeCache.erase(level, seqNo); });
+  return true;
+}
+
+bool
+Db::storeSubTreeData(sqlite3_stmt* completeStatement, size_t level,
+                     const NonNegativeInteger& seqNo, const Data& data,
+                     bool isFull, const NonNegativeInteger& nextLeafSeqNo)
+{
+  sqlite3_stmt* statement = isFull ? completeStatement : m_insertPendingTreeStmt;
+  StatementResetter resetter(statement);
+
   sqlite3_bind_int(statement, 1, level);
-  sqlite3_bind_int(statement, 2, seqNo);
-  sqlite3_bind_block(statement, 3, data.wireEncode(), SQLITE_TRANSIENT);
+  sqlite3_bind_int64(statement, 2, seqNo);
+  sqlite3_bind_block(statement, 3, data.wireEncode(), SQLITE_STATIC);
   if (!isFull)
-    sqlite3_bind_int(statement, 4, nextLeafSeqNo);
+    sqlite3_bind_int64(statement, 4, nextLeafSeqNo);
 
   int result = sqlite3_step(statement);
-  sqlite3_finalize(statement);
-
-  if (result == SQLITE_OK)
-    return true;
-  return false;
+  return result == SQLITE_OK || result == SQLITE_DONE;
 }
 
 shared_ptr<Data>
 Db::getSubTreeData(size_t level, const NonNegativeInteger& seqNo)
 {
-  sqlite3_stmt* statement;
-  sqlite3_prepare_v2(m_db,
-                     "SELECT data FROM cTrees WHERE level=? AND seqNo=?",
-                     -1, &statement, nullptr);
-  sqlite3_bind_int(statement, 1, level);
-  sqlite3_bind_int(statement, 2, seqNo);
-
-  if (sqlite3_step(statement) == SQLITE_ROW) {
-    auto result = make_shared<Data>(sqlite3_column_block(statement, 0));
-    sqlite3_finalize(statement);
-    return result;
+  shared_ptr<Data> data = m_subTreeCache.find(level, seqNo);
+  if (data != nullptr)
+    return data;
+
+  bool isComplete = false;
+  if (!m_readers.empty()) {
+    ReadConnectionGuard reader(*this);
+    data = selectSubTree(reader->selectCompleteTreeStmt, reader->selectPendingTreeStmt,
+                         level, seqNo, isComplete);
+  }
+  else {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    data = selectSubTree(m_selectCompleteTreeStmt, m_selectPendingTreeStmt, level, seqNo,
+                         isComplete);
   }
 
-  sqlite3_prepare_v2(m_db,
-                     "SELECT data FROM pTrees WHERE level=? AND seqNo=?",
-                     -1, &statement, nullptr);
-  sqlite3_bind_int(statement, 1, level);
-  sqlite3_bind_int(statement, 2, seqNo);
-
-  shared_ptr<Data> result;
-  if (sqlite3_step(statement) == SQLITE_ROW)
-    result = make_shared<Data>(sqlite3_column_block(statement, 0));
+  // a pending subtree keeps changing, only the complete ones can be cached
+  if (data != nullptr && isComplete && m_subTreeCache.getCapacity() > 0)
+    m_subTreeCache.insert(level, seqNo, data);
 
-  sqlite3_finalize(statement);
-  return result;
+  return data;
 }
 
 std::vector<shared_ptr<Data>>
 Db::getPendingSubTrees()
 {
-  sqlite3_stmt* statement;
-  sqlite3_prepare_v2(m_db,
-                     "SELECT data FROM pTrees ORDER BY level DESC",
-                     -1, &statement, nullptr);
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  StatementResetter resetter(m_selectPendingTreesStmt);
 
   std::vector<shared_ptr<Data>> datas;
-  while (sqlite3_step(statement) == SQLITE_ROW)
-    datas.push_back(make_shared<Data>(sqlite3_column_block(statement, 0)));
+  while (sqlite3_step(m_selectPendingTreesStmt) == SQLITE_ROW)
+    datas.push_back(make_shared<Data>(sqlite3_column_block(m_selectPendingTreesStmt, 0)));
 
-  sqlite3_finalize(statement);
   return datas;
 }
 
@@ -211,26 +658,29 @@ Db::insertLeafData(const Leaf& leaf)
   if (leaf.getDataSeqNo() != m_nextLeafSeqNo)
     return false;
 
-  sqlite3_stmt* statement;
-  sqlite3_prepare_v2(m_db,
-                     "INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo, timestamp, isCert)\
-                      VALUES (?, ?, ?, ?, 0)",
-                     -1, &statement, nullptr);
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    beginWrite();
 
-  sqlite3_bind_int(statement, 1, leaf.getDataSeqNo());
-  sqlite3_bind_block(statement, 2, leaf.getDataName().wireEncode(), SQLITE_TRANSIENT);
-  sqlite3_bind_int(statement, 3, leaf.getSignerSeqNo());
-  sqlite3_bind_int(statement, 4, leaf.getTimestamp());
+    StatementResetter resetter(m_insertLeafStmt);
 
-  int result = sqlite3_step(statement);
-  sqlite3_finalize(statement);
+    sqlite3_bind_int64(m_insertLeafStmt, 1, leaf.getDataSeqNo());
+    sqlite3_bind_block(m_insertLeafStmt, 2, leaf.getDataName().wireEncode(), SQLITE_STATIC);
+    sqlite3_bind_int64(m_insertLeafStmt, 3, leaf.getSignerSeqNo());
+    sqlite3_bind_int64(m_insertLeafStmt, 4, leaf.getTimestamp());
+
+    int result = sqlite3_step(m_insertLeafStmt);
+    if (result != SQLITE_OK && result != SQLITE_DONE)
+      return false;
 
-  if (result == SQLITE_OK || result == SQLITE_DONE) {
     m_nextLeafSeqNo++;
-    return true;
+    if (!m_isInTransaction)
+      m_nextCommittedLeafSeqNo = m_nextLeafSeqNo;
   }
 
-  return false;
+  // may commit the group, which takes the writer lock again
+  endLeafWrite();
+  return true;
 }
 
 bool
@@ -239,73 +689,263 @@ Db::insertLeafData(const Leaf& leaf, const Data& data)
   if (leaf.getDataSeqNo() != m_nextLeafSeqNo)
     return false;
 
-  sqlite3_stmt* statement;
-  sqlite3_prepare_v2(m_db,
-                     "INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo, timestamp, isCert, cert)\
-                      VALUES (?, ?, ?, ?, 1, ?)",
-                     -1, &statement, nullptr);
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    beginWrite();
 
-  sqlite3_bind_int(statement, 1, leaf.getDataSeqNo());
-  sqlite3_bind_block(statement, 2, leaf.getDataName().wireEncode(), SQLITE_TRANSIENT);
-  sqlite3_bind_int(statement, 3, leaf.getSignerSeqNo());
-  sqlite3_bind_int(statement, 4, leaf.getTimestamp());
-  sqlite3_bind_block(statement, 5, data.wireEncode(), SQLITE_TRANSIENT);
+    StatementResetter resetter(m_insertCertLeafStmt);
 
-  int result = sqlite3_step(statement);
-  sqlite3_finalize(statement);
+    sqlite3_bind_int64(m_insertCertLeafStmt, 1, leaf.getDataSeqNo());
+    sqlite3_bind_block(m_insertCertLeafStmt, 2, leaf.getDataName().wireEncode(), SQLITE_STATIC);
+    sqlite3_bind_int64(m_insertCertLeafStmt, 3, leaf.getSignerSeqNo());
+    sqlite3_bind_int64(m_insertCertLeafStmt, 4, leaf.getTimestamp());
+    sqlite3_bind_block(m_insertCertLeafStmt, 5, data.wireEncode(), SQLITE_STATIC);
+
+    int result = sqlite3_step(m_insertCertLeafStmt);
+    if (result != SQLITE_OK && result != SQLITE_DONE)
+      return false;
 
-  if (result == SQLITE_OK || result == SQLITE_DONE) {
     m_nextLeafSeqNo++;
-    return true;
+    if (!m_isInTransaction)
+      m_nextCommittedLeafSeqNo = m_nextLeafSeqNo;
   }
 
-  return false;
+  // may commit the group, which takes the writer lock again
+  endLeafWrite();
+  return true;
 }
 
 std::pair<shared_ptr<Leaf>, shared_ptr<Data>>
-Db::getLeaf(const NonNegativeInteger& seqNo)
+Db::getLeaf(const NonNegativeInteger& seqNo, bool isUncommittedVisible)
 {
-  sqlite3_stmt* statement;
-  sqlite3_prepare_v2(m_db,
-                     "SELECT dataName, signerSeqNo, timestamp, cert\
-                      FROM leaves WHERE dataSeqNo=?",
-                     -1, &statement, nullptr);
+  if (!m_readers.empty() && !isUncommittedVisible) {
+    ReadConnectionGuard reader(*this);
+    return selectLeaf(reader->selectLeafStmt, seqNo);
+  }
 
-  sqlite3_bind_int(statement, 1, seqNo);
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  return selectLeaf(m_selectLeafStmt, seqNo);
+}
 
-  if (sqlite3_step(statement) == SQLITE_ROW) {
-    auto leaf = make_shared<Leaf>(Name(sqlite3_column_block(statement, 0)),
-                                  sqlite3_column_int(statement, 2),
-                                  seqNo,
-                                  sqlite3_column_int(statement, 1));
+size_t
+Db::getLeafRange(const NonNegativeInteger& first, const NonNegativeInteger& last,
+                 const LeafCallback& callback)
+{
+  if (!m_readers.empty()) {
+    ReadConnectionGuard reader(*this);
+    return selectLeafRange(reader->selectLeafRangeStmt, first, last, callback);
+  }
 
-    shared_ptr<Data> data;
-    if (sqlite3_column_bytes(statement, 3) != 0) {
-      data = make_shared<Data>(sqlite3_column_block(statement, 3));
-    }
-    sqlite3_finalize(statement);
-    return std::make_pair(leaf, data);
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  return selectLeafRange(m_selectLeafRangeStmt, first, last, callback);
+}
+
+size_t
+Db::getEncodedLeafRange(const NonNegativeInteger& first, const NonNegativeInteger& last,
+                        const EncodedLeafCallback& callback)
+{
+  if (!m_readers.empty()) {
+    ReadConnectionGuard reader(*this);
+    return selectEncodedLeafRange(reader->selectLeafRangeStmt, first, last, callback);
   }
-  else {
-    sqlite3_finalize(statement);
-    return std::make_pair(nullptr, nullptr);
+
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  return selectEncodedLeafRange(m_selectLeafRangeStmt, first, last, callback);
+}
+
+bool
+Db::insertFrontier(const Frontier& frontier)
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  beginWrite();
+
+  StatementResetter resetter(m_insertFrontierStmt);
+
+  sqlite3_bind_int64(m_insertFrontierStmt, 1, frontier.getNextLeafSeqNo());
+  sqlite3_bind_block(m_insertFrontierStmt, 2, frontier.wireEncode(), SQLITE_STATIC);
+
+  int result = sqlite3_step(m_insertFrontierStmt);
+  return result == SQLITE_OK || result == SQLITE_DONE;
+}
+
+shared_ptr<Frontier>
+Db::getFrontier()
+{
+  auto frontier = getLastFrontier();
+  if (frontier == nullptr || frontier->getNextLeafSeqNo() != m_nextLeafSeqNo)
+    return nullptr;
+
+  return frontier;
+}
+
+shared_ptr<Frontier>
+Db::getLastFrontier()
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  StatementResetter resetter(m_selectFrontierStmt);
+
+  if (sqlite3_step(m_selectFrontierStmt) != SQLITE_ROW ||
+      static_cast<NonNegativeInteger>(sqlite3_column_int64(m_selectFrontierStmt, 0)) >
+        m_nextLeafSeqNo)
+    return nullptr;
+
+  auto frontier = make_shared<Frontier>();
+  try {
+    frontier->wireDecode(sqlite3_column_block(m_selectFrontierStmt, 1));
+  }
+  catch (Frontier::Error&) {
+    return nullptr;
   }
+  catch (ndn::tlv::Error&) {
+    return nullptr;
+  }
+
+  if (frontier->getNextLeafSeqNo() > m_nextLeafSeqNo)
+    return nullptr;
+
+  return frontier;
+}
+
+void
+Db::loadNextLeafSeqNo()
+{
+  getMaxLeafSeq();
+  m_nextCommittedLeafSeqNo = m_nextLeafSeqNo;
 }
 
 const NonNegativeInteger&
 Db::getMaxLeafSeq()
 {
-  sqlite3_stmt* statement;
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  StatementResetter resetter(m_selectNextLeafSeqNoStmt);
 
-  sqlite3_prepare_v2(m_db, "SELECT count(dataSeqNo) FROM leaves", -1, &statement, nullptr);
-  if (sqlite3_step(statement) == SQLITE_ROW)
-    m_nextLeafSeqNo = sqlite3_column_int(statement, 0);
+  // max() is NULL, which reads as 0, if there is no leaf yet
+  if (sqlite3_step(m_selectNextLeafSeqNoStmt) == SQLITE_ROW)
+    m_nextLeafSeqNo = sqlite3_column_int64(m_selectNextLeafSeqNoStmt, 0);
   else
     throw Error("getMaxLeafSeq: db error");
 
-  sqlite3_finalize(statement);
   return m_nextLeafSeqNo;
 }
 
+void
+Db::loadConfig(const conf::ConfigSection& config)
+{
+  for (const auto& option : config) {
+    try {
+      if (boost::iequals(option.first, "group-commit-size")) {
+        m_groupCommitSize = boost::lexical_cast<size_t>(option.second.data());
+        if (m_groupCommitSize == 0)
+          throw Error("Db: group-commit-size must be positive");
+      }
+      else if (boost::iequals(option.first, "group-commit-window")) {
+        m_groupCommitWindow =
+          time::milliseconds(boost::lexical_cast<uint32_t>(option.second.data()));
+      }
+      else if (boost::iequals(option.first, "journal-mode")) {
+        std::string mode = boost::to_lower_copy(option.second.data());
+        if (mode != "delete" && mode != "truncate" && mode != "persist" &&
+            mode != "memory" && mode != "wal" && mode != "off")
+          throw Error("Db: unknown journal-mode " + option.second.data());
+        m_pragmas.push_back(std::make_pair("journal_mode", mode));
+      }
+      else if (boost::iequals(option.first, "synchronous")) {
+        std::string level = boost::to_lower_copy(option.second.data());
+        if (level != "off" && level != "normal" && level != "full" && level != "extra")
+          throw Error("Db: unknown synchronous level " + option.second.data());
+        m_pragmas.push_back(std::make_pair("synchronous", level));
+      }
+      else if (boost::iequals(option.first, "cache-size")) {
+        int64_t cacheSize = boost::lexical_cast<int64_t>(option.second.data());
+        m_pragmas.push_back(std::make_pair("cache_size", std::to_string(cacheSize)));
+      }
+      else if (boost::iequals(option.first, "mmap-size")) {
+        int64_t mmapSize = boost::lexical_cast<int64_t>(option.second.data());
+        if (mmapSize < 0)
+          throw Error("Db: mmap-size must not be negative");
+        m_pragmas.push_back(std::make_pair("mmap_size", std::to_string(mmapSize)));
+      }
+      else if (boost::iequals(option.first, "read-connections")) {
+        m_nReadConnections = boost::lexical_cast<size_t>(option.second.data());
+      }
+      else if (boost::iequals(option.first, "subtree-cache-size")) {
+        m_subTreeCache.setCapacity(boost::lexical_cast<size_t>(option.second.data()));
+      }
+      else if (boost::iequals(option.first, "page-size")) {
+        uint32_t pageSize = boost::lexical_cast<uint32_t>(option.second.data());
+        if (pageSize < 512 || pageSize > 65536 || (pageSize & (pageSize - 1)) != 0)
+          throw Error("Db: page-size must be a power of two between 512 and 65536");
+        // page_size must precede journal_mode=wal, otherwise it cannot take effect
+        m_pragmas.insert(m_pragmas.begin(), std::make_pair("page_size", std::to_string(pageSize)));
+      }
+      else
+        throw Error("Db: unrecognized option " + option.first);
+    }
+    catch (boost::bad_lexical_cast&) {
+      throw Error("Db: invalid value of " + option.first + ": " + option.second.data());
+    }
+  }
+}
+
+void
+Db::beginWrite()
+{
+  if (m_groupCommitSize <= 1 || m_isInTransaction)
+    return;
+
+  execute("BEGIN");
+  m_isInTransaction = true;
+}
+
+void
+Db::endLeafWrite()
+{
+  if (!m_isInTransaction)
+    return;
+
+  m_nGroupedAppends++;
+  if (m_nGroupedAppends < m_groupCommitSize)
+    return;
+
+  try {
+    commit();
+  }
+  catch (Error&) {
+    // the group stays open with its callbacks, the next append or commit() retries it
+  }
+}
+
+void
+Db::execute(const std::string& sql)
+{
+  char* errorMessage = nullptr;
+  if (sqlite3_exec(m_db, sql.c_str(), nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+    std::string reason = errorMessage != nullptr ? errorMessage : "unknown error";
+    sqlite3_free(errorMessage);
+    throw Error("Db: cannot execute " + sql + ": " + reason);
+  }
+}
+
+void
+Db::applyPragmas()
+{
+  for (const auto& pragma : m_pragmas) {
+    if (pragma.first != "journal_mode") {
+      execute("PRAGMA " + pragma.first + "=" + pragma.second);
+      continue;
+    }
+
+    // journal_mode reports the resulting mode, e.g., wal is not available with unix-dotfile
+    sqlite3_stmt* statement = prepareStatement(m_db, ("PRAGMA journal_mode=" + pragma.second).c_str());
+    std::string mode;
+    if (sqlite3_step(statement) == SQLITE_ROW)
+      mode = reinterpret_cast<const char*>(sqlite3_column_text(statement, 0));
+    sqlite3_finalize(statement);
+
+    if (!boost::iequals(mode, pragma.second))
+      throw Error("Db: cannot set journal-mode to " + pragma.second);
+  }
+}
+
 } // namespace delorean
 } // namespace ndn
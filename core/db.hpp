@@ -23,15 +23,32 @@
 #define NDN_DELOREAN_CORE_DB_HPP
 
 #include "common.hpp"
+#include "frontier.hpp"
 #include "leaf.hpp"
+#include "sub-tree-cache.hpp"
 #include "util/non-negative-integer.hpp"
+#include "conf/config.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace ndn {
 namespace delorean {
 
+/**
+ * @brief The logger database
+ *
+ * Db owns a single writer connection, which performs all the appends.  Optionally, a pool
+ * of read-only connections serves getSubTreeData, getLeaf and getLeafRange, so that lookups do
+ * not wait behind appends and can be issued concurrently from several threads.  The pool only
+ * sees committed writes, so what it serves cannot be retracted by a rollback.  All the other
+ * methods must be called from the same thread.
+ */
 class Db : noncopyable
 {
 public:
@@ -45,16 +62,186 @@ public:
     }
   };
 
+  typedef function<void()> CommitCallback;
+
+  /**
+   * @brief Callback of getLeafRange
+   *
+   * @p cert is an empty Block unless the leaf is a certificate.  Both @p leaf and @p cert are
+   * only valid during the call, and the callback must not call back into Db.
+   */
+  typedef function<void(const Leaf& leaf, const Block& cert)> LeafCallback;
+
+  /**
+   * @brief Callback of getEncodedLeafRange
+   *
+   * @p wire is the LoggerLeaf encoding of a leaf, it is only valid during the call, and the
+   * callback must not call back into Db.
+   */
+  typedef function<void(const uint8_t* wire, size_t size)> EncodedLeafCallback;
+
 public:
+  Db();
+
+  ~Db();
+
+  /**
+   * @brief Open (or create) the logger database under @p dbDir
+   *
+   * All the statements used by Db are prepared here once and reused by the
+   * subsequent calls, so that no SQL is parsed on the append or lookup path.
+   *
+   * The optional @p config is the db section of the config file:
+   *
+   *   db
+   *   {
+   *     group-commit-size 64    ; number of leaf appends per transaction, 1 disables grouping
+   *     group-commit-window 10  ; milliseconds an open group may wait for more appends
+   *
+   *     journal-mode wal        ; delete, truncate, persist, memory, wal or off
+   *     synchronous normal      ; off, normal, full or extra
+   *     cache-size -65536       ; pages, or KiB if negative
+   *     mmap-size 268435456     ; bytes of the database file accessed through mmap
+   *     page-size 4096          ; only effective when the database is created
+   *
+   *     read-connections 4      ; size of the read-only connection pool, 0 disables the pool
+   *
+   *     subtree-cache-size 16777216  ; bytes of complete subtrees kept in memory, 0 disables
+   *                                  ; the cache
+   *   }
+   *
+   * The read-only connection pool is best combined with journal-mode wal, otherwise readers
+   * and the writer still block each other while a group is committed.
+   *
+   * The SQLite defaults are used for the pragmas which are not set.
+   *
+   * @throw Error if the database cannot be opened or initialized, or the config is invalid
+   */
+  void
+  open(const std::string& dbDir, const conf::ConfigSection& config = conf::ConfigSection());
+
+  /**
+   * @brief Check if there are writes which are not committed yet
+   *
+   * This can only be true when group commit is enabled.
+   */
+  bool
+  hasPendingCommit() const
+  {
+    return m_isInTransaction;
+  }
+
+  size_t
+  getGroupCommitSize() const
+  {
+    return m_groupCommitSize;
+  }
+
+  const time::milliseconds&
+  getGroupCommitWindow() const
+  {
+    return m_groupCommitWindow;
+  }
+
+  size_t
+  getNReadConnections() const
+  {
+    return m_readers.size();
+  }
+
+  const SubTreeCache&
+  getSubTreeCache() const
+  {
+    return m_subTreeCache;
+  }
+
+  /**
+   * @brief Get the seqNo of the next leaf to be appended
+   */
+  const NonNegativeInteger&
+  getNextLeafSeqNo() const
+  {
+    return m_nextLeafSeqNo;
+  }
+
+  /**
+   * @brief Get the seqNo following the last committed leaf
+   *
+   * This is getNextLeafSeqNo() unless a group of appends is open.
+   */
+  const NonNegativeInteger&
+  getNextCommittedLeafSeqNo() const
+  {
+    return m_nextCommittedLeafSeqNo;
+  }
+
+  /**
+   * @brief Commit the current group of writes, if any
+   *
+   * The callbacks registered through whenCommitted are invoked after the commit.
+   *
+   * @throw Error if the group cannot be committed, e.g., the db is busy, in which case the group
+   *        stays open with its callbacks, so that the commit can be retried
+   */
+  void
+  commit();
+
+  /**
+   * @brief Invoke @p callback once all the writes made so far are durable
+   *
+   * @p callback is invoked immediately if there is no pending commit.  Callbacks
+   * which are still pending when Db is destroyed are dropped.
+   */
+  void
+  whenCommitted(const CommitCallback& callback);
+
+  /**
+   * @brief Make the writes of @p writes atomic
+   *
+   * The writes join the open group, if any, and are committed with the appends of the group.
+   * Otherwise, they are made in a transaction of their own, which is committed on return.
+   *
+   * @throw Error if the transaction cannot be started or committed
+   */
   void
-  open(const std::string& dbDir);
+  runInTransaction(const function<void()>& writes);
 
+  /**
+   * @brief Store a subtree
+   *
+   * Storing a complete subtree removes the pending one it completes.  A pending subtree replaces
+   * the one stored at the same level and seqNo, a complete one is never overwritten.
+   *
+   * @return false if the subtree cannot be stored, e.g., it is already complete
+   */
   bool
   insertSubTreeData(size_t level, const NonNegativeInteger& seqNo,
                     const Data& data,
                     bool isFull = true,
                     const NonNegativeInteger& nextLeafSeqNo = 0);
 
+  /**
+   * @brief Store a subtree, replacing the one stored at the same level and seqNo if any
+   *
+   * This is meant to repair a corrupted subtree.  The cached copy of a replaced complete subtree
+   * is dropped once the write is committed.
+   */
+  bool
+  replaceSubTreeData(size_t level, const NonNegativeInteger& seqNo,
+                     const Data& data,
+                     bool isFull = true,
+                     const NonNegativeInteger& nextLeafSeqNo = 0);
+
+  /**
+   * @brief Get a complete or pending subtree
+   *
+   * This method is thread-safe when the read-only connection pool is enabled.  The lookup goes
+   * through the pool then, and the writes of an open group are not visible.  Without the pool,
+   * it goes through the writer, which sees them.
+   *
+   * Complete subtrees are looked up in the subtree cache first, the Data of a complete subtree
+   * may be shared with the cache and must not be modified.
+   */
   shared_ptr<Data>
   getSubTreeData(size_t level, const NonNegativeInteger& seqNo);
 
@@ -67,17 +254,157 @@ public:
   bool
   insertLeafData(const Leaf& leaf, const Data& data);
 
+  /**
+   * @brief Get a leaf and its certificate, if any
+   *
+   * The same rules as getSubTreeData apply, unless @p isUncommittedVisible is set, in which case
+   * the lookup always goes through the writer, so that the leaves of an open group are found.
+   * This is meant for the own lookups of the logger, e.g., of a signer appended in the same
+   * group, and must be made from the thread of the writes.
+   */
   std::pair<shared_ptr<Leaf>, shared_ptr<Data>>
-  getLeaf(const NonNegativeInteger& seqNo);
+  getLeaf(const NonNegativeInteger& seqNo, bool isUncommittedVisible = false);
+
+  /**
+   * @brief Visit the leaves from @p first (inclusive) to @p last (exclusive) in order
+   *
+   * The range is walked with a single cursor over the leaves index and the same Leaf object
+   * is reused for every row.  The same thread-safety rules as getSubTreeData apply.
+   *
+   * @return the number of visited leaves
+   */
+  size_t
+  getLeafRange(const NonNegativeInteger& first, const NonNegativeInteger& last,
+               const LeafCallback& callback);
+
+  /**
+   * @brief Visit the encoded leaves from @p first (inclusive) to @p last (exclusive) in order
+   *
+   * Each leaf is encoded from its stored columns into the same buffer, see Leaf::wireEncodeRow,
+   * so no allocation is made per leaf.  The same thread-safety rules as getSubTreeData apply.
+   *
+   * @return the number of visited leaves
+   */
+  size_t
+  getEncodedLeafRange(const NonNegativeInteger& first, const NonNegativeInteger& last,
+                      const EncodedLeafCallback& callback);
+
+  /**
+   * @brief Save @p frontier, replacing the previous one
+   */
+  bool
+  insertFrontier(const Frontier& frontier);
+
+  /**
+   * @brief Get the saved frontier if it matches the leaves
+   *
+   * A frontier is only current as long as no leaf has been appended since it was saved.
+   *
+   * @return nullptr if there is no frontier, it is stale or it cannot be decoded
+   */
+  shared_ptr<Frontier>
+  getFrontier();
+
+  /**
+   * @brief Get the saved frontier even if leaves have been appended since it was saved
+   *
+   * After a crash the frontier is behind the leaves, which can be replayed on top of it.
+   *
+   * @return nullptr if there is no frontier, it is ahead of the leaves or it cannot be decoded
+   */
+  shared_ptr<Frontier>
+  getLastFrontier();
 
 NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   const NonNegativeInteger&
   getMaxLeafSeq();
 
+private:
+  /**
+   * @brief A read-only connection with its own prepared statements
+   */
+  struct ReadConnection;
+  class ReadConnectionGuard;
+
+  void
+  loadConfig(const conf::ConfigSection& config);
+
+  void
+  openReadConnections(const std::string& dbFile);
+
+  /**
+   * @brief Get the next leaf seqNo from the last leaf in the db
+   */
+  void
+  loadNextLeafSeqNo();
+
+  /**
+   * @brief Open a transaction for the current group if group commit is enabled
+   */
+  void
+  beginWrite();
+
+  /**
+   * @brief Account one leaf append and commit the group once it is full
+   */
+  void
+  endLeafWrite();
+
+  /**
+   * @brief Store a subtree with @p completeStatement if it is complete, the writer must be locked
+   */
+  bool
+  storeSubTreeData(sqlite3_stmt* completeStatement, size_t level, const NonNegativeInteger& seqNo,
+                   const Data& data, bool isFull, const NonNegativeInteger& nextLeafSeqNo);
+
+  void
+  execute(const std::string& sql);
+
+  /**
+   * @brief Apply the pragmas set in the config, must be called before any table is created
+   */
+  void
+  applyPragmas();
+
 private:
   sqlite3* m_db;
 
+  sqlite3_stmt* m_insertCompleteTreeStmt;
+  sqlite3_stmt* m_replaceCompleteTreeStmt;
+  sqlite3_stmt* m_insertPendingTreeStmt;
+  sqlite3_stmt* m_selectCompleteTreeStmt;
+  sqlite3_stmt* m_selectPendingTreeStmt;
+  sqlite3_stmt* m_selectPendingTreesStmt;
+  sqlite3_stmt* m_insertLeafStmt;
+  sqlite3_stmt* m_insertCertLeafStmt;
+  sqlite3_stmt* m_selectLeafStmt;
+  sqlite3_stmt* m_selectLeafRangeStmt;
+  sqlite3_stmt* m_selectNextLeafSeqNoStmt;
+  sqlite3_stmt* m_insertFrontierStmt;
+  sqlite3_stmt* m_selectFrontierStmt;
+
   NonNegativeInteger m_nextLeafSeqNo;
+  NonNegativeInteger m_nextCommittedLeafSeqNo;
+
+  size_t m_groupCommitSize;
+  time::milliseconds m_groupCommitWindow;
+  std::atomic<bool> m_isInTransaction;
+  size_t m_nGroupedAppends;
+  std::vector<CommitCallback> m_commitCallbacks;
+
+  /// pragma name and value pairs, in the order they should be applied
+  std::vector<std::pair<std::string, std::string>> m_pragmas;
+
+  /// serializes the use of the writer connection, which lookups may fall back to
+  std::mutex m_writerMutex;
+
+  size_t m_nReadConnections;
+  std::vector<std::unique_ptr<ReadConnection>> m_readers;
+  std::vector<ReadConnection*> m_idleReaders;
+  std::mutex m_readersMutex;
+  std::condition_variable m_readerReleased;
+
+  SubTreeCache m_subTreeCache;
 };
 
 } // namespace delorean
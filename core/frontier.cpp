@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frontier.hpp"
+#include "tlv.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace delorean {
+
+Frontier::Frontier()
+  : m_nextLeafSeqNo(0)
+  , m_rootHash(Node::getEmptyHash())
+{
+}
+
+Frontier::Frontier(const NonNegativeInteger& nextLeafSeqNo, const Sha256Digest& rootHash)
+  : m_nextLeafSeqNo(nextLeafSeqNo)
+  , m_rootHash(rootHash)
+{
+}
+
+void
+Frontier::addSubTree(const Node::Index& peakIndex, const std::vector<Sha256Digest>& leafHashes)
+{
+  m_wire = Block();
+  m_subTrees.push_back(PendingSubTree{peakIndex, leafHashes});
+}
+
+const Block&
+Frontier::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  static_assert(sizeof(Sha256Digest) == 32, "Sha256Digest must be packed");
+
+  ndn::EncodingBuffer buffer;
+  size_t totalLength = 0;
+
+  for (auto subTree = m_subTrees.rbegin(); subTree != m_subTrees.rend(); subTree++) {
+    // the leaf hashes are adjacent, they are put on the wire as one block
+    size_t subTreeLength = 0;
+    subTreeLength +=
+      buffer.prependByteArrayBlock(tlv::FrontierLeafHashes,
+                                   reinterpret_cast<const uint8_t*>(subTree->leafHashes.data()),
+                                   subTree->leafHashes.size() * 32);
+    subTreeLength += prependNonNegativeIntegerBlock(buffer, tlv::FrontierPeakSeqNo,
+                                                    subTree->peakIndex.seqNo);
+    subTreeLength += prependNonNegativeIntegerBlock(buffer, tlv::FrontierPeakLevel,
+                                                    subTree->peakIndex.level);
+    subTreeLength += buffer.prependVarNumber(subTreeLength);
+    subTreeLength += buffer.prependVarNumber(tlv::FrontierSubTree);
+    totalLength += subTreeLength;
+  }
+
+  totalLength += buffer.prependByteArrayBlock(tlv::FrontierRootHash,
+                                              m_rootHash.data(), m_rootHash.size());
+  totalLength += prependNonNegativeIntegerBlock(buffer, tlv::FrontierNextSeqNo, m_nextLeafSeqNo);
+
+  // the checksum covers everything after it
+  Sha256Digest checksum = computeSha256Digest(buffer.buf(), totalLength);
+  totalLength += buffer.prependByteArrayBlock(tlv::FrontierChecksum,
+                                              checksum.data(), checksum.size());
+
+  totalLength += buffer.prependVarNumber(totalLength);
+  totalLength += buffer.prependVarNumber(tlv::Frontier);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+void
+Frontier::wireDecode(const Block& wire)
+{
+  if (!wire.hasWire()) {
+    throw Error("The supplied block does not contain wire format");
+  }
+
+  Block frontier = wire;
+  frontier.parse();
+
+  if (frontier.type() != tlv::Frontier)
+    throw Error("Unexpected TLV type when decoding frontier");
+
+  Block::element_const_iterator it = frontier.elements_begin();
+
+  Sha256Digest checksum;
+  if (it != frontier.elements_end() && it->type() == tlv::FrontierChecksum &&
+      toSha256Digest(it->value(), it->value_size(), checksum)) {
+    const uint8_t* begin = it->wire() + it->size();
+    const uint8_t* end = frontier.value() + frontier.value_size();
+    if (computeSha256Digest(begin, end - begin) != checksum)
+      throw Error("Frontier checksum does not match");
+    it++;
+  }
+  else
+    throw Error("The first sub-TLV is not FrontierChecksum");
+
+  NonNegativeInteger nextLeafSeqNo = 0;
+  if (it != frontier.elements_end() && it->type() == tlv::FrontierNextSeqNo) {
+    nextLeafSeqNo = readNonNegativeInteger(*it);
+    it++;
+  }
+  else
+    throw Error("The second sub-TLV is not FrontierNextSeqNo");
+
+  Sha256Digest rootHash;
+  if (it != frontier.elements_end() && it->type() == tlv::FrontierRootHash &&
+      toSha256Digest(it->value(), it->value_size(), rootHash)) {
+    it++;
+  }
+  else
+    throw Error("The third sub-TLV is not FrontierRootHash");
+
+  std::vector<PendingSubTree> subTrees;
+  for (; it != frontier.elements_end(); it++) {
+    if (it->type() != tlv::FrontierSubTree)
+      throw Error("Unexpected sub-TLV after the pending subtrees");
+
+    Block subTree = *it;
+    subTree.parse();
+    Block::element_const_iterator subTreeIt = subTree.elements_begin();
+
+    size_t level = 0;
+    if (subTreeIt != subTree.elements_end() && subTreeIt->type() == tlv::FrontierPeakLevel) {
+      level = readNonNegativeInteger(*subTreeIt);
+      subTreeIt++;
+    }
+    else
+      throw Error("The first sub-TLV of FrontierSubTree is not FrontierPeakLevel");
+
+    NonNegativeInteger seqNo = 0;
+    if (subTreeIt != subTree.elements_end() && subTreeIt->type() == tlv::FrontierPeakSeqNo) {
+      seqNo = readNonNegativeInteger(*subTreeIt);
+      subTreeIt++;
+    }
+    else
+      throw Error("The second sub-TLV of FrontierSubTree is not FrontierPeakSeqNo");
+
+    std::vector<Sha256Digest> leafHashes;
+    if (subTreeIt != subTree.elements_end() && subTreeIt->type() == tlv::FrontierLeafHashes &&
+        subTreeIt->value_size() % 32 == 0) {
+      leafHashes.resize(subTreeIt->value_size() / 32);
+      std::copy(subTreeIt->value_begin(), subTreeIt->value_end(),
+                reinterpret_cast<uint8_t*>(leafHashes.data()));
+      subTreeIt++;
+    }
+    else
+      throw Error("The third sub-TLV of FrontierSubTree is not FrontierLeafHashes");
+
+    if (subTreeIt != subTree.elements_end())
+      throw Error("No more sub-TLV in FrontierSubTree");
+
+    subTrees.push_back(PendingSubTree{Node::Index(seqNo, level), std::move(leafHashes)});
+  }
+
+  m_nextLeafSeqNo = nextLeafSeqNo;
+  m_rootHash = rootHash;
+  m_subTrees.swap(subTrees);
+  m_wire = wire;
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_FRONTIER_HPP
+#define NDN_DELOREAN_CORE_FRONTIER_HPP
+
+#include "common.hpp"
+#include "node.hpp"
+#include "util/non-negative-integer.hpp"
+#include "util/sha256-digest.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A snapshot of the pending subtrees of a MerkleTree
+ *
+ * The pending subtrees are kept from the root subtree down to the base one, each with the
+ * hashes of its complete leaves.  The last leaf of a pending subtree is the root of the next
+ * one, so it is rebuilt rather than kept.  The whole snapshot is a few hashes per level of the
+ * tree, however many leaves the tree has.
+ *
+ * The wire format starts with a SHA-256 checksum of the rest of the TLV value, so that a torn
+ * or corrupted snapshot is never mistaken for a valid one.
+ */
+class Frontier
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  struct PendingSubTree
+  {
+    Node::Index peakIndex;
+    std::vector<Sha256Digest> leafHashes;
+  };
+
+public:
+  Frontier();
+
+  Frontier(const NonNegativeInteger& nextLeafSeqNo, const Sha256Digest& rootHash);
+
+  const NonNegativeInteger&
+  getNextLeafSeqNo() const
+  {
+    return m_nextLeafSeqNo;
+  }
+
+  const Sha256Digest&
+  getRootHash() const
+  {
+    return m_rootHash;
+  }
+
+  /**
+   * @brief Get the pending subtrees, from the root subtree down
+   */
+  const std::vector<PendingSubTree>&
+  getSubTrees() const
+  {
+    return m_subTrees;
+  }
+
+  /**
+   * @brief Append the pending subtree below the last one
+   */
+  void
+  addSubTree(const Node::Index& peakIndex, const std::vector<Sha256Digest>& leafHashes);
+
+  /// @brief Encode to a wire format
+  const Block&
+  wireEncode() const;
+
+  /**
+   * @brief Decode from a wire format
+   *
+   * @throw Error if the wire format is malformed or the checksum does not match
+   */
+  void
+  wireDecode(const Block& wire);
+
+private:
+  NonNegativeInteger m_nextLeafSeqNo;
+  Sha256Digest m_rootHash;
+  std::vector<PendingSubTree> m_subTrees;
+
+  mutable Block m_wire;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_FRONTIER_HPP
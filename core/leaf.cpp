@@ -25,9 +25,65 @@
 #include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/util/crypto.hpp>
 
+#include <algorithm>
+
 namespace ndn {
 namespace delorean {
 
+/**
+ * A utility function to get the size of a nonNegativeInteger encoding.
+ */
+static size_t
+sizeOfNonNegativeInteger(uint64_t value)
+{
+  if (value <= 0xFF)
+    return 1;
+  else if (value <= 0xFFFF)
+    return 2;
+  else if (value <= 0xFFFFFFFF)
+    return 4;
+  else
+    return 8;
+}
+
+/**
+ * A utility function to append @p value in network byte order on @p size bytes.
+ */
+static void
+appendBigEndian(std::vector<uint8_t>& buffer, uint64_t value, size_t size)
+{
+  for (size_t i = size; i > 0; i--)
+    buffer.push_back(static_cast<uint8_t>(value >> (8 * (i - 1))));
+}
+
+/**
+ * A utility function to append a TLV-TYPE or TLV-LENGTH.
+ */
+static void
+appendVarNumber(std::vector<uint8_t>& buffer, uint64_t number)
+{
+  if (number < 253) {
+    buffer.push_back(static_cast<uint8_t>(number));
+    return;
+  }
+
+  size_t size = sizeOfNonNegativeInteger(number);
+  buffer.push_back(size <= 2 ? 253 : (size == 4 ? 254 : 255));
+  appendBigEndian(buffer, number, std::max<size_t>(size, 2));
+}
+
+/**
+ * A utility function to append a TLV block of a nonNegativeInteger, whose type is below 253.
+ */
+static void
+appendNonNegativeIntegerBlock(std::vector<uint8_t>& buffer, uint8_t type, uint64_t value)
+{
+  size_t size = sizeOfNonNegativeInteger(value);
+  buffer.push_back(type);
+  buffer.push_back(static_cast<uint8_t>(size));
+  appendBigEndian(buffer, value, size);
+}
+
 const Name Leaf::EMPTY_NAME;
 const size_t Leaf::N_LOGGER_LEAF_SUFFIX = 4;
 const ssize_t Leaf::OFFSET_LEAF_SEQNO = -2;
@@ -92,11 +148,11 @@ Leaf::setLoggerName(const Name& loggerName)
   m_loggerName = loggerName;
 }
 
-ndn::ConstBufferPtr
+Sha256Digest
 Leaf::getHash() const
 {
   wireEncode();
-  return ndn::crypto::sha256(m_wire.wire(), m_wire.size());
+  return computeSha256Digest(m_wire.wire(), m_wire.size());
 }
 
 shared_ptr<Data>
@@ -104,11 +160,11 @@ Leaf::encode() const
 {
   auto data = make_shared<Data>();
 
-  ndn::ConstBufferPtr hash = getHash();
+  Sha256Digest hash = getHash();
 
   // Name
   Name dataName = m_loggerName;
-  dataName.appendNumber(m_dataSeqNo).append(hash->buf(), hash->size());
+  dataName.appendNumber(m_dataSeqNo).append(hash.data(), hash.size());
   data->setName(dataName);
 
   // Content
@@ -140,11 +196,13 @@ Leaf::decode(const Data& data)
   if (m_loggerName.size() + N_LOGGER_LEAF_SUFFIX != dataName.size())
     throw Error("decode: leaf data name does not follow the naming convention");
 
-  ndn::ConstBufferPtr leafHash;
+  Sha256Digest leafHash;
+  bool hasValidLeafHash = false;
   NonNegativeInteger dataSeqNo;
   try {
-    leafHash = make_shared<ndn::Buffer>(dataName.get(OFFSET_LEAF_HASH).value(),
-                                        dataName.get(OFFSET_LEAF_HASH).value_size());
+    hasValidLeafHash = toSha256Digest(dataName.get(OFFSET_LEAF_HASH).value(),
+                                      dataName.get(OFFSET_LEAF_HASH).value_size(),
+                                      leafHash);
 
     dataSeqNo = dataName.get(OFFSET_LEAF_SEQNO).toNumber();
   }
@@ -154,7 +212,7 @@ Leaf::decode(const Data& data)
 
   wireDecode(data.getContent().blockFromValue());
 
-  if (*leafHash != *getHash())
+  if (!hasValidLeafHash || leafHash != getHash())
     throw Error("decode: inconsistent hash");
 
   if (m_dataSeqNo != dataSeqNo)
@@ -201,6 +259,26 @@ Leaf::wireEncode() const
   return m_wire;
 }
 
+void
+Leaf::wireEncodeRow(std::vector<uint8_t>& buffer, const uint8_t* dataNameWire, size_t dataNameSize,
+                    const Timestamp& timestamp, const NonNegativeInteger& dataSeqNo,
+                    const NonNegativeInteger& signerSeqNo)
+{
+  // the same order as wireEncode
+  size_t valueLength = dataNameSize +
+                       2 + sizeOfNonNegativeInteger(timestamp) +
+                       2 + sizeOfNonNegativeInteger(dataSeqNo) +
+                       2 + sizeOfNonNegativeInteger(signerSeqNo);
+
+  buffer.clear();
+  appendVarNumber(buffer, tlv::LoggerLeaf);
+  appendVarNumber(buffer, valueLength);
+  buffer.insert(buffer.end(), dataNameWire, dataNameWire + dataNameSize);
+  appendNonNegativeIntegerBlock(buffer, tlv::Timestamp, timestamp);
+  appendNonNegativeIntegerBlock(buffer, tlv::DataSeqNo, dataSeqNo);
+  appendNonNegativeIntegerBlock(buffer, tlv::SignerSeqNo, signerSeqNo);
+}
+
 void
 Leaf::wireDecode(const Block& wire)
 {
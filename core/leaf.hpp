@@ -25,7 +25,7 @@
 #include "common.hpp"
 #include "util/non-negative-integer.hpp"
 #include "util/timestamp.hpp"
-#include <ndn-cxx/encoding/buffer.hpp>
+#include "util/sha256-digest.hpp"
 
 namespace ndn {
 namespace delorean {
@@ -97,7 +97,7 @@ public:
     return m_loggerName;
   }
 
-  ndn::ConstBufferPtr
+  Sha256Digest
   getHash() const;
 
   shared_ptr<Data>
@@ -106,7 +106,6 @@ public:
   void
   decode(const Data& data);
 
-NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   /// @brief Encode to a wire format or estimate wire format
   template<ndn::encoding::Tag TAG>
   size_t
@@ -120,6 +119,18 @@ NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   wireDecode(const Block& wire);
 
+  /**
+   * @brief Encode the LoggerLeaf of a stored leaf into @p buffer, replacing its content
+   *
+   * The encoding is the one of wireEncode, but it is made from the data name in wire format, so
+   * that neither a Name nor a Block is built.  No allocation is made once @p buffer is large
+   * enough, so the same buffer can be reused for many leaves.
+   */
+  static void
+  wireEncodeRow(std::vector<uint8_t>& buffer, const uint8_t* dataNameWire, size_t dataNameSize,
+                const Timestamp& timestamp, const NonNegativeInteger& dataSeqNo,
+                const NonNegativeInteger& signerSeqNo);
+
 public:
   static const Name EMPTY_NAME;
 
@@ -26,21 +26,67 @@ namespace ndn {
 namespace delorean {
 
 LoggerResponse::LoggerResponse()
-  : m_code(-1)
+  : m_batchIndex(0)
 {
 }
 
 LoggerResponse::LoggerResponse(int32_t code, const std::string& msg)
-  : m_code(code)
-  , m_msg(msg)
-  , m_dataSeqNo(0)
+  : m_batchIndex(0)
 {
+  addEntry(code, msg);
 }
 
 LoggerResponse::LoggerResponse(const NonNegativeInteger& seqNo)
-  : m_code(0)
-  , m_dataSeqNo(seqNo)
+  : m_batchIndex(0)
 {
+  addEntry(seqNo);
+}
+
+void
+LoggerResponse::addEntry(int32_t code, const std::string& msg)
+{
+  m_entries.push_back({code, msg, 0});
+  m_wire = Block();
+}
+
+void
+LoggerResponse::addEntry(const NonNegativeInteger& seqNo)
+{
+  m_entries.push_back({0, "", seqNo});
+  m_wire = Block();
+}
+
+const LoggerResponse::Entry&
+LoggerResponse::getEntry(size_t index) const
+{
+  if (index >= m_entries.size())
+    throw Error("Entry " + boost::lexical_cast<std::string>(index) + " is not available");
+
+  return m_entries[index];
+}
+
+void
+LoggerResponse::setBatchProof(uint64_t index, const std::vector<Sha256Digest>& path,
+                              const Data& batchRoot)
+{
+  m_batchIndex = index;
+  m_batchPath = path;
+  m_batchRoot = make_shared<Data>(batchRoot);
+  m_wire = Block();
+}
+
+Sha256Digest
+LoggerResponse::computeBatchLeafHash(const Name& responseName) const
+{
+  LoggerResponse response;
+  response.m_entries = m_entries;
+
+  const Block& name = responseName.wireEncode();
+  const Block& wire = response.wireEncode();
+
+  ndn::Buffer buffer(name.wire(), name.size());
+  buffer.insert(buffer.end(), wire.wire(), wire.wire() + wire.size());
+  return computeSha256Digest(buffer.buf(), buffer.size());
 }
 
 template<ndn::encoding::Tag TAG>
@@ -49,15 +95,28 @@ LoggerResponse::wireEncode(ndn::EncodingImpl<TAG>& block) const
 {
   size_t totalLength = 0;
 
-  if (m_code != 0) {
-    totalLength += block.prependByteArrayBlock(tlv::ResultMsg,
-                                               reinterpret_cast<const uint8_t*>(m_msg.c_str()),
-                                               m_msg.size());
+  if (m_batchRoot != nullptr) {
+    size_t proofLength = 0;
+    proofLength += block.prependBlock(m_batchRoot->wireEncode());
+    for (auto hash = m_batchPath.rbegin(); hash != m_batchPath.rend(); hash++)
+      proofLength += block.prependByteArrayBlock(tlv::BatchPathHash, hash->data(), hash->size());
+    proofLength += prependNonNegativeIntegerBlock(block, tlv::BatchLeafIndex, m_batchIndex);
+
+    proofLength += block.prependVarNumber(proofLength);
+    proofLength += block.prependVarNumber(tlv::BatchProof);
+    totalLength += proofLength;
   }
-  else {
-    totalLength += prependNonNegativeIntegerBlock(block, tlv::DataSeqNo, m_dataSeqNo);
+
+  for (auto entry = m_entries.rbegin(); entry != m_entries.rend(); entry++) {
+    if (entry->code != 0) {
+      const uint8_t* msg = reinterpret_cast<const uint8_t*>(entry->msg.c_str());
+      totalLength += block.prependByteArrayBlock(tlv::ResultMsg, msg, entry->msg.size());
+    }
+    else {
+      totalLength += prependNonNegativeIntegerBlock(block, tlv::DataSeqNo, entry->dataSeqNo);
+    }
+    totalLength += prependNonNegativeIntegerBlock(block, tlv::ResultCode, entry->code);
   }
-  totalLength += prependNonNegativeIntegerBlock(block, tlv::ResultCode, m_code);
 
   totalLength += block.prependVarNumber(totalLength);
   totalLength += block.prependVarNumber(tlv::LogResponse);
@@ -101,31 +160,74 @@ LoggerResponse::wireDecode(const Block& wire)
   if (m_wire.type() != tlv::LogResponse)
     throw tlv::Error("Unexpected TLV type when decoding log response");
 
+  m_entries.clear();
+  m_batchIndex = 0;
+  m_batchPath.clear();
+  m_batchRoot.reset();
   Block::element_const_iterator it = m_wire.elements_begin();
 
-  // the first block must be result code
-  if (it != m_wire.elements_end() && it->type() == tlv::ResultCode) {
-    m_code = readNonNegativeInteger(*it);
-    it++;
-  }
-  else
+  // at least one entry
+  if (it == m_wire.elements_end())
     throw Error("The first sub-TLV is not ResultCode");
 
-  // the second block could be result msg
+  while (it != m_wire.elements_end() && it->type() != tlv::BatchProof) {
+    Entry entry{-1, "", 0};
+
+    // each entry starts with a result code
+    if (it->type() == tlv::ResultCode) {
+      entry.code = readNonNegativeInteger(*it);
+      it++;
+    }
+    else
+      throw Error("The first sub-TLV of an entry is not ResultCode");
+
+    // followed by a result msg or a data seqNo
+    if (it != m_wire.elements_end() && it->type() == tlv::ResultMsg) {
+      entry.msg = std::string(reinterpret_cast<const char*>(it->value()), it->value_size());
+      it++;
+    }
+    else if (it != m_wire.elements_end() && it->type() == tlv::DataSeqNo) {
+      entry.dataSeqNo = readNonNegativeInteger(*it);
+      it++;
+    }
+    else if (it != m_wire.elements_end() &&
+             it->type() != tlv::ResultCode && it->type() != tlv::BatchProof)
+      throw Error("The second sub-TLV of an entry is neither ResultMsg nor DataSeqNo");
+
+    m_entries.push_back(entry);
+  }
+
   if (it == m_wire.elements_end())
     return;
-  else if (it->type() == tlv::ResultMsg) {
-    m_msg = std::string(reinterpret_cast<const char*>(it->value()), it->value_size());
-    it++;
+
+  // the batch proof, if any, comes last
+  Block proof = *it;
+  proof.parse();
+  Block::element_const_iterator proofIt = proof.elements_begin();
+
+  if (proofIt != proof.elements_end() && proofIt->type() == tlv::BatchLeafIndex) {
+    m_batchIndex = readNonNegativeInteger(*proofIt);
+    proofIt++;
+  }
+  else
+    throw Error("The first sub-TLV of BatchProof is not BatchLeafIndex");
+
+  while (proofIt != proof.elements_end() && proofIt->type() == tlv::BatchPathHash) {
+    Sha256Digest hash;
+    if (!toSha256Digest(proofIt->value(), proofIt->value_size(), hash))
+      throw Error("BatchPathHash is not a SHA-256 digest");
+    m_batchPath.push_back(hash);
+    proofIt++;
   }
-  else if (it->type() == tlv::DataSeqNo) {
-    m_dataSeqNo = readNonNegativeInteger(*it);
-    it++;
+
+  if (proofIt != proof.elements_end() && proofIt->type() == ndn::tlv::Data) {
+    m_batchRoot = make_shared<Data>(*proofIt);
+    proofIt++;
   }
   else
-    throw Error("The second sub-TLV is not ResultMsg");
+    throw Error("BatchProof does not end with the batch root Data");
 
-  if (it != m_wire.elements_end())
+  if (proofIt != proof.elements_end() || ++it != m_wire.elements_end())
     throw Error("No more sub-TLV in log response");
 }
 
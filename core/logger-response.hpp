@@ -24,11 +24,21 @@
 
 #include "common.hpp"
 #include "util/non-negative-integer.hpp"
+#include "util/sha256-digest.hpp"
 #include <ndn-cxx/encoding/buffer.hpp>
 
 namespace ndn {
 namespace delorean {
 
+/**
+ * @brief The response to a log request, with one entry per requested Data
+ *
+ * A response carries a ResultCode followed by either a DataSeqNo or a ResultMsg for each
+ * entry, in the order of the requested Data.  A single entry response is a batch of one.
+ *
+ * A response whose Data is not signed by the logger carries a BatchProof instead: its index
+ * in a ResponseBatch, its inclusion path, and the root Data signed by the logger.
+ */
 class LoggerResponse
 {
 public:
@@ -49,30 +59,90 @@ public:
 
   LoggerResponse(const NonNegativeInteger& seqNo);
 
+  /// @brief Append an error entry
+  void
+  addEntry(int32_t resultCode, const std::string& resultMsg);
+
+  /// @brief Append an accepted entry
+  void
+  addEntry(const NonNegativeInteger& seqNo);
+
+  size_t
+  getNEntries() const
+  {
+    return m_entries.size();
+  }
+
   int32_t
-  getCode() const
+  getCode(size_t index = 0) const
   {
-    return m_code;
+    return getEntry(index).code;
   }
 
   const std::string&
-  getMsg() const
+  getMsg(size_t index = 0) const
   {
-    if (m_code == 0)
+    const Entry& entry = getEntry(index);
+    if (entry.code == 0)
       throw Error("Error msg is not available");
 
-    return m_msg;
+    return entry.msg;
   }
 
   const NonNegativeInteger&
-  getDataSeqNo() const
+  getDataSeqNo(size_t index = 0) const
   {
-    if (m_code != 0)
+    const Entry& entry = getEntry(index);
+    if (entry.code != 0)
       throw Error("Data seqNo is not available");
 
-    return m_dataSeqNo;
+    return entry.dataSeqNo;
+  }
+
+  /**
+   * @brief Attach the proof that the response is the leaf at @p index of a signed batch
+   *
+   * @param batchRoot Data signed by the logger, whose content is the root hash of the batch
+   */
+  void
+  setBatchProof(uint64_t index, const std::vector<Sha256Digest>& path, const Data& batchRoot);
+
+  bool
+  hasBatchProof() const
+  {
+    return m_batchRoot != nullptr;
   }
 
+  uint64_t
+  getBatchIndex() const
+  {
+    return m_batchIndex;
+  }
+
+  const std::vector<Sha256Digest>&
+  getBatchPath() const
+  {
+    return m_batchPath;
+  }
+
+  /**
+   * @brief Get the signed root Data of the batch, nullptr if there is no batch proof
+   */
+  shared_ptr<const Data>
+  getBatchRoot() const
+  {
+    return m_batchRoot;
+  }
+
+  /**
+   * @brief Compute the hash of the response as a leaf of a batch
+   *
+   * The hash is SHA-256 over the wire encoding of @p responseName, the name of the response
+   * Data, followed by the wire encoding of the response without its batch proof.
+   */
+  Sha256Digest
+  computeBatchLeafHash(const Name& responseName) const;
+
   /// @brief Encode to a wire format or estimate wire format
   template<ndn::encoding::Tag TAG>
   size_t
@@ -87,9 +157,22 @@ public:
   wireDecode(const Block& wire);
 
 private:
-  int32_t m_code;
-  std::string m_msg; // optional
-  NonNegativeInteger m_dataSeqNo; // optional
+  struct Entry
+  {
+    int32_t code;
+    std::string msg; // optional
+    NonNegativeInteger dataSeqNo; // optional
+  };
+
+  const Entry&
+  getEntry(size_t index) const;
+
+private:
+  std::vector<Entry> m_entries;
+
+  uint64_t m_batchIndex;
+  std::vector<Sha256Digest> m_batchPath;
+  shared_ptr<const Data> m_batchRoot;
 
   mutable Block m_wire;
 };
@@ -23,15 +23,43 @@
 #include "tlv.hpp"
 #include "conf/config-file.hpp"
 
+#include <ndn-cxx/encoding/buffer-stream.hpp>
+#include <ndn-cxx/security/digest-sha256.hpp>
+#include <ndn-cxx/util/crypto.hpp>
+
 namespace ndn {
 namespace delorean {
 
 const int Logger::N_DATA_FETCHING_RETRIAL = 2;
+const size_t Logger::N_LEAVES_PER_SEGMENT = 32;
+const size_t Logger::N_SUBTREES_PER_SEGMENT = 4;
+const size_t Logger::DEFAULT_SIGNER_CACHE_SIZE = 1024;
+const size_t Logger::N_MAX_RESPONSES_PER_BATCH = 1024;
+const size_t Logger::DEFAULT_CHECKPOINT_INTERVAL = 1024;
+const time::milliseconds Logger::DEFAULT_CHECKPOINT_PERIOD(1000);
+const size_t Logger::N_MAX_COMMIT_RETRIES = 5;
+const std::string Logger::COMPONENT_EXISTENCE("existence");
+const std::string Logger::COMPONENT_CONSISTENCY("consistency");
 
 Logger::Logger(ndn::Face& face, const std::string& configFile)
   : m_face(face)
+  , m_scheduler(face.getIoService())
+  , m_isCommitScheduled(false)
+  , m_nCommitRetries(0)
+  , m_nFailedCommits(0)
   , m_merkleTree(m_db)
   , m_validator(m_face)
+  , m_signerCache(DEFAULT_SIGNER_CACHE_SIZE)
+  , m_maxPendingRequests(0)
+  , m_nPendingRequests(0)
+  , m_nCommitQueued(0)
+  , m_signBatchWindow(0)
+  , m_nRejectedRequests(0)
+  , m_checkpointInterval(DEFAULT_CHECKPOINT_INTERVAL)
+  , m_checkpointPeriod(DEFAULT_CHECKPOINT_PERIOD)
+  , m_isCheckpointScheduled(false)
+  , m_nFailedCheckpoints(0)
+  , m_lifetime(make_shared<int>(0))
 {
   conf::ConfigFile conf(configFile);
   conf.parse();
@@ -42,13 +70,20 @@ Logger::Logger(ndn::Face& face, const std::string& configFile)
   m_treePrefix.append("tree");
   m_leafPrefix = m_loggerName;
   m_leafPrefix.append("leaf");
+  m_leafRangePrefix = m_loggerName;
+  m_leafRangePrefix.append("leaves");
+  m_proofPrefix = m_loggerName;
+  m_proofPrefix.append("proof");
+  m_batchPrefix = m_loggerName;
+  m_batchPrefix.append("batch");
   m_logPrefix = m_loggerName;
   m_logPrefix.append("log");
 
+  m_db.open(conf.getDbDir(), conf.getDbConfig());
+
   m_merkleTree.setLoggerName(m_treePrefix);
   m_merkleTree.loadPendingSubTrees();
-
-  m_db.open(conf.getDbDir());
+  replayLeaves();
 
   // initialize security environment: keychain
   initializeKeys();
@@ -59,6 +94,8 @@ Logger::Logger(ndn::Face& face, const std::string& configFile)
   // load validator rules
   m_validator.load(conf.getValidatorRule(), conf.getConfFileName());
 
+  loadPipelineConfig(conf.getPipelineConfig());
+
   // register subtree prefix
   m_face.setInterestFilter(m_treePrefix,
                            bind(&Logger::onSubTreeInterest, this, _1, _2),
@@ -71,6 +108,18 @@ Logger::Logger(ndn::Face& face, const std::string& configFile)
                            [] (const Name&) {},
                            [] (const Name&, const std::string&) {});
 
+  // register leaf range prefix
+  m_face.setInterestFilter(m_leafRangePrefix,
+                           bind(&Logger::onLeafRangeInterest, this, _1, _2),
+                           [] (const Name&) {},
+                           [] (const Name&, const std::string&) {});
+
+  // register proof prefix
+  m_face.setInterestFilter(m_proofPrefix,
+                           bind(&Logger::onProofInterest, this, _1, _2),
+                           [] (const Name&) {},
+                           [] (const Name&, const std::string&) {});
+
   // register log prefix
   m_face.setInterestFilter(m_logPrefix,
                            bind(&Logger::onLogRequestInterest, this, _1, _2),
@@ -90,6 +139,8 @@ Logger::addSelfSignedCert(ndn::IdentityCertificate& cert, const Timestamp& times
   if (m_merkleTree.addLeaf(dataSeqNo, leaf.getHash())) {
     m_db.insertLeafData(leaf, cert);
     m_db.getLeaf(dataSeqNo);
+    scheduleCheckpoint();
+    scheduleGroupCommit();
   }
   else
     throw Error("Cannot add cert");
@@ -97,6 +148,63 @@ Logger::addSelfSignedCert(ndn::IdentityCertificate& cert, const Timestamp& times
   return dataSeqNo;
 }
 
+Logger::PipelineStatus
+Logger::getPipelineStatus() const
+{
+  PipelineStatus status;
+  status.nPendingRequests = m_nPendingRequests;
+  status.nVerifyQueued = m_verificationQueue->getQueueDepth();
+  status.nAppendQueued = m_verificationQueue->getNUndelivered();
+  status.nCommitQueued = m_nCommitQueued;
+  status.nBatchQueued = m_responseBatch.size();
+  status.nSignQueued = m_signPool->getQueueDepth();
+  status.nRejectedRequests = m_nRejectedRequests;
+  status.nFailedCommits = m_nFailedCommits;
+  status.nFailedCheckpoints = m_nFailedCheckpoints;
+  return status;
+}
+
+void
+Logger::loadPipelineConfig(const conf::ConfigSection& config)
+{
+  size_t nVerifyThreads = 0;
+  size_t nSignThreads = 0;
+
+  for (const auto& option : config) {
+    try {
+      if (boost::iequals(option.first, "verify-threads"))
+        nVerifyThreads = boost::lexical_cast<size_t>(option.second.data());
+      else if (boost::iequals(option.first, "sign-threads"))
+        nSignThreads = boost::lexical_cast<size_t>(option.second.data());
+      else if (boost::iequals(option.first, "max-pending-requests"))
+        m_maxPendingRequests = boost::lexical_cast<size_t>(option.second.data());
+      else if (boost::iequals(option.first, "signer-cache-size"))
+        m_signerCache.setCapacity(boost::lexical_cast<size_t>(option.second.data()));
+      else if (boost::iequals(option.first, "sign-batch-window"))
+        m_signBatchWindow = time::milliseconds(boost::lexical_cast<size_t>(option.second.data()));
+      else if (boost::iequals(option.first, "checkpoint-interval"))
+        m_checkpointInterval = boost::lexical_cast<size_t>(option.second.data());
+      else if (boost::iequals(option.first, "checkpoint-period"))
+        m_checkpointPeriod = time::milliseconds(boost::lexical_cast<size_t>(option.second.data()));
+      else
+        throw Error("Logger: unrecognized pipeline option " + option.first);
+    }
+    catch (boost::bad_lexical_cast&) {
+      throw Error("Logger: invalid value of " + option.first + ": " + option.second.data());
+    }
+  }
+
+  m_verificationQueue.reset(new VerificationQueue(m_face.getIoService(), nVerifyThreads));
+
+  // each sign thread signs with a KeyChain of its own, which opens the same PIB and TPM as
+  // m_keyChain, so that the signatures are not serialized
+  for (size_t i = 0; i < nSignThreads; i++) {
+    m_signKeyChains.emplace_back(new ndn::KeyChain);
+    m_idleSignKeyChains.push_back(m_signKeyChains.back().get());
+  }
+  m_signPool.reset(new WorkerPool(nSignThreads));
+}
+
 void
 Logger::initializeKeys()
 {
@@ -177,23 +285,139 @@ Logger::onLeafInterest(const ndn::InterestFilter& interestFilter, const Interest
 
   if (result.first != nullptr) {
     if (interestName.size() >= hashOffset + 1) {
-      ndn::ConstBufferPtr leafHash;
-      try {
-        leafHash = make_shared<ndn::Buffer>(interestName.get(hashOffset).value(),
-                                            interestName.get(hashOffset).value_size());
-        ndn::ConstBufferPtr hash = result.first->getHash();
-        if (*hash != *leafHash)
-          return;
-      }
-      catch (tlv::Error&) {
+      Sha256Digest leafHash;
+      if (!toSha256Digest(interestName.get(hashOffset).value(),
+                          interestName.get(hashOffset).value_size(),
+                          leafHash) ||
+          leafHash != result.first->getHash())
         return;
-      }
     }
     result.first->setLoggerName(m_leafPrefix);
     m_face.put(*result.first->encode());
   }
 }
 
+void
+Logger::onLeafRangeInterest(const ndn::InterestFilter& interestFilter, const Interest& interest)
+{
+  Name interestName = interest.getName();
+
+  size_t firstOffset = m_leafRangePrefix.size();
+  size_t lastOffset = m_leafRangePrefix.size() + 1;
+  size_t segmentOffset = m_leafRangePrefix.size() + 2;
+
+  if (interestName.size() < lastOffset + 1)
+    return; // interest is too short to answer
+
+  NonNegativeInteger first;
+  NonNegativeInteger last;
+  uint64_t segment = 0;
+
+  try {
+    first = interestName.get(firstOffset).toNumber();
+    last = interestName.get(lastOffset).toNumber();
+    if (interestName.size() > segmentOffset)
+      segment = interestName.get(segmentOffset).toSegment();
+  }
+  catch (tlv::Error&) {
+    return;
+  }
+
+  // the content of a range must never change, so it cannot go beyond the committed log
+  if (first >= last || last > m_db.getNextCommittedLeafSeqNo())
+    return;
+
+  uint64_t nSegments = (last - first + N_LEAVES_PER_SEGMENT - 1) / N_LEAVES_PER_SEGMENT;
+  if (segment >= nSegments)
+    return;
+
+  NonNegativeInteger segmentFirst = first + segment * N_LEAVES_PER_SEGMENT;
+  NonNegativeInteger segmentLast = std::min<NonNegativeInteger>(last,
+                                                                segmentFirst + N_LEAVES_PER_SEGMENT);
+
+  ndn::OBufferStream os;
+  m_db.getEncodedLeafRange(segmentFirst, segmentLast, [&os] (const uint8_t* wire, size_t size) {
+      os.write(reinterpret_cast<const char*>(wire), size);
+    });
+
+  Name dataName = interestName.getPrefix(segmentOffset);
+  dataName.appendSegment(segment);
+
+  auto data = make_shared<Data>(dataName);
+  data->setContent(os.buf());
+  data->setFinalBlockId(ndn::name::Component::fromSegment(nSegments - 1));
+
+  // the leaves are authenticated by the tree, a digest is enough to protect the packet
+  signWithDigest(*data);
+  m_face.put(*data);
+}
+
+void
+Logger::onProofInterest(const ndn::InterestFilter& interestFilter, const Interest& interest)
+{
+  Name interestName = interest.getName();
+
+  size_t typeOffset = m_proofPrefix.size();
+  size_t firstOffset = m_proofPrefix.size() + 1;
+  size_t treeSizeOffset = m_proofPrefix.size() + 2;
+  size_t segmentOffset = m_proofPrefix.size() + 3;
+
+  if (interestName.size() < treeSizeOffset + 1)
+    return; // interest is too short to answer
+
+  NonNegativeInteger first;
+  NonNegativeInteger treeSize;
+  uint64_t segment = 0;
+
+  try {
+    first = interestName.get(firstOffset).toNumber();
+    treeSize = interestName.get(treeSizeOffset).toNumber();
+    if (interestName.size() > segmentOffset)
+      segment = interestName.get(segmentOffset).toSegment();
+  }
+  catch (tlv::Error&) {
+    return;
+  }
+
+  // the proof of a tree size never changes, but it can only be made once the tree is that big
+  // and the subtrees it is made of are committed
+  if (treeSize > m_db.getNextCommittedLeafSeqNo())
+    return;
+
+  std::vector<shared_ptr<Data>> proof;
+  std::string type = interestName.get(typeOffset).toUri();
+  if (type == COMPONENT_EXISTENCE)
+    proof = m_merkleTree.getExistenceProof(first, treeSize);
+  else if (type == COMPONENT_CONSISTENCY)
+    proof = m_merkleTree.getConsistencyProof(first, treeSize);
+
+  if (proof.empty())
+    return;
+
+  uint64_t nSegments = (proof.size() + N_SUBTREES_PER_SEGMENT - 1) / N_SUBTREES_PER_SEGMENT;
+  if (segment >= nSegments)
+    return;
+
+  ndn::OBufferStream os;
+  size_t segmentFirst = segment * N_SUBTREES_PER_SEGMENT;
+  size_t segmentLast = std::min(proof.size(), segmentFirst + N_SUBTREES_PER_SEGMENT);
+  for (size_t i = segmentFirst; i < segmentLast; i++) {
+    const Block& wire = proof[i]->wireEncode();
+    os.write(reinterpret_cast<const char*>(wire.wire()), wire.size());
+  }
+
+  Name dataName = interestName.getPrefix(segmentOffset);
+  dataName.appendSegment(segment);
+
+  auto data = make_shared<Data>(dataName);
+  data->setContent(os.buf());
+  data->setFinalBlockId(ndn::name::Component::fromSegment(nSegments - 1));
+
+  // the subtrees are authenticated by the root hash, a digest is enough to protect the packet
+  signWithDigest(*data);
+  m_face.put(*data);
+}
+
 void
 Logger::onLogRequestInterest(const ndn::InterestFilter& interestFilter, const Interest& interest)
 {
@@ -215,91 +439,458 @@ Logger::requestValidatedCallback(const shared_ptr<const Interest>& interest)
   if (request.size() < signerOffset + 1)
     return; // request is too short to answer
 
-  Name dataName;
-  NonNegativeInteger signerSeqNo;
+  auto logRequest = make_shared<LogRequest>();
+  logRequest->interest = *interest;
+  std::vector<Name> dataNames;
   try {
-    dataName.wireDecode(request.get(dataOffset).blockFromValue());
-    signerSeqNo = request.get(signerOffset).toNumber();
+    // either a single Data name or a list of them
+    Block dataBlock = request.get(dataOffset).blockFromValue();
+    if (dataBlock.type() == ndn::tlv::Name)
+      dataNames.push_back(Name(dataBlock));
+    else if (dataBlock.type() == tlv::DataNameList) {
+      dataBlock.parse();
+      for (const auto& element : dataBlock.elements())
+        dataNames.push_back(Name(element));
+    }
+    logRequest->signerSeqNo = request.get(signerOffset).toNumber();
   }
   catch (tlv::Error&) {
     return;
   }
 
-  auto result = m_db.getLeaf(signerSeqNo);
-  if (result.first == nullptr || result.second == nullptr)
+  if (dataNames.empty())
+    return;
+
+  logRequest->signer = getSigner(logRequest->signerSeqNo);
+  if (logRequest->signer == nullptr)
+    return;
+
+  // backpressure: the requester is told to back off and retry once the pipeline has drained
+  if (m_maxPendingRequests > 0 && m_nPendingRequests >= m_maxPendingRequests) {
+    m_nRejectedRequests++;
+
+    LoggerResponse response;
+    for (size_t i = 0; i < dataNames.size(); i++)
+      response.addEntry(tlv::LogResponse_Error_Busy, "logger is busy");
+
+    // the reply bypasses the pipeline, a digest keeps it cheap while the logger is overloaded
+    Data data(interest->getName());
+    data.setContent(response.wireEncode());
+    signWithDigest(data);
+    m_face.put(data);
     return;
+  }
+  m_nPendingRequests++;
 
-  Interest dataInterest(dataName);
-  m_face.expressInterest(dataInterest,
-                         bind(&Logger::dataReceivedCallback, this, _1, _2,
-                              signerSeqNo, *interest),
-                         bind(&Logger::dataTimeoutCallback, this, _1,
-                              N_DATA_FETCHING_RETRIAL, signerSeqNo, *interest));
+  logRequest->codes.resize(dataNames.size(), tlv::LogResponse_Error_Fetch);
+  logRequest->dataSeqNos.resize(dataNames.size(), 0);
+  logRequest->nRemaining = dataNames.size();
+
+  for (size_t index = 0; index < dataNames.size(); index++) {
+    Interest dataInterest(dataNames[index]);
+    m_face.expressInterest(dataInterest,
+                           bind(&Logger::dataReceivedCallback, this, _1, _2,
+                                logRequest, index),
+                           bind(&Logger::dataTimeoutCallback, this, _1,
+                                N_DATA_FETCHING_RETRIAL, logRequest, index));
+  }
 }
 
 void
 Logger::dataReceivedCallback(const Interest& interest, Data& data,
-                             const NonNegativeInteger& signerSeqNo,
-                             const Interest& reqInterest)
+                             const shared_ptr<LogRequest>& logRequest, size_t index)
 {
-  auto result = m_db.getLeaf(signerSeqNo);
-  BOOST_ASSERT(result.first != nullptr);
-  BOOST_ASSERT(result.second != nullptr);
-
   Timestamp dataTimestamp = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  auto fetchedData = make_shared<Data>(data);
+  auto signer = logRequest->signer;
+
+  // the rules are matched here, only the signature is verified on a verification thread
+  int policyVerdict = checkPolicy(dataTimestamp, *fetchedData, *signer);
+
+  m_verificationQueue->submit(
+    [=] {
+      if (policyVerdict != tlv::LogResponse_Accept)
+        return policyVerdict;
+      return verifyData(*fetchedData, *signer);
+    },
+    [=] (int verdict) {
+      appendLeaf(verdict, dataTimestamp, *fetchedData, logRequest, index);
+    });
+}
+
+shared_ptr<const SignerCache::Signer>
+Logger::getSigner(const NonNegativeInteger& signerSeqNo)
+{
+  auto signer = m_signerCache.find(signerSeqNo);
+  if (signer != nullptr)
+    return signer;
+
+  // the signer may have been appended in the open group
+  auto result = m_db.getLeaf(signerSeqNo, true);
+  if (result.first == nullptr || result.second == nullptr)
+    return nullptr;
 
+  auto newSigner = make_shared<SignerCache::Signer>();
+  newSigner->timestamp = result.first->getTimestamp();
   try {
-    ndn::IdentityCertificate cert(*result.second);
+    newSigner->cert = make_shared<ndn::IdentityCertificate>(*result.second);
+    newSigner->verifier = make_shared<SignatureVerifier>(newSigner->cert->getPublicKeyInfo());
+  }
+  catch (tlv::Error&) {
+    // keep the signer, Data signed by it is rejected with a signer error
+  }
+  catch (SignatureVerifier::Error&) {
+    // likewise
+  }
 
-    if (m_policyChecker.check(dataTimestamp, data, result.first->getTimestamp(), cert)) {
-      NonNegativeInteger dataSeqNo = m_merkleTree.getNextLeafSeqNo();
-      Leaf leaf(data.getFullName(), dataTimestamp, dataSeqNo, signerSeqNo, m_leafPrefix);
+  m_signerCache.insert(signerSeqNo, newSigner);
+  return newSigner;
+}
 
-      if (m_merkleTree.addLeaf(dataSeqNo, leaf.getHash())) {
-        if (data.getContentType() == ndn::tlv::ContentType_Key)
-          m_db.insertLeafData(leaf, data);
-        else
-          m_db.insertLeafData(leaf);
+int
+Logger::checkPolicy(const Timestamp& dataTimestamp, const Data& data,
+                    const SignerCache::Signer& signer)
+{
+  if (signer.cert == nullptr || signer.verifier == nullptr)
+    return tlv::LogResponse_Error_Signer;
 
-        makeLogResponse(reqInterest, LoggerResponse(dataSeqNo));
-      }
-      else
-        makeLogResponse(reqInterest,
-                        LoggerResponse(tlv::LogResponse_Error_Tree, "cannot add leaf"));
-    }
+  try {
+    if (m_policyChecker.checkPolicy(dataTimestamp, data, signer.timestamp, *signer.cert))
+      return tlv::LogResponse_Accept;
     else
-      makeLogResponse(reqInterest,
-                      LoggerResponse(tlv::LogResponse_Error_Policy, "cannot pass policy checking"));
+      return tlv::LogResponse_Error_Policy;
   }
   catch (tlv::Error&) {
-    makeLogResponse(reqInterest,
-                    LoggerResponse(tlv::LogResponse_Error_Signer, "signer is wrong"));
+    return tlv::LogResponse_Error_Signer;
   }
 }
 
+int
+Logger::verifyData(const Data& data, const SignerCache::Signer& signer)
+{
+  BOOST_ASSERT(signer.verifier != nullptr);
+
+  try {
+    if (signer.verifier->verify(data))
+      return tlv::LogResponse_Accept;
+    else
+      return tlv::LogResponse_Error_Policy;
+  }
+  catch (tlv::Error&) {
+    return tlv::LogResponse_Error_Signer;
+  }
+}
+
+void
+Logger::appendLeaf(int verdict, const Timestamp& dataTimestamp, const Data& data,
+                   const shared_ptr<LogRequest>& logRequest, size_t index)
+{
+  if (verdict != tlv::LogResponse_Accept) {
+    setLogResult(logRequest, index, verdict);
+    return;
+  }
+
+  NonNegativeInteger dataSeqNo = m_merkleTree.getNextLeafSeqNo();
+  Leaf leaf(data.getFullName(), dataTimestamp, dataSeqNo, logRequest->signerSeqNo, m_leafPrefix);
+
+  if (m_merkleTree.addLeaf(dataSeqNo, leaf.getHash())) {
+    if (data.getContentType() == ndn::tlv::ContentType_Key)
+      m_db.insertLeafData(leaf, data);
+    else
+      m_db.insertLeafData(leaf);
+
+    setLogResult(logRequest, index, tlv::LogResponse_Accept, dataSeqNo);
+    scheduleCheckpoint();
+    scheduleGroupCommit();
+  }
+  else
+    setLogResult(logRequest, index, tlv::LogResponse_Error_Tree);
+}
+
 void
 Logger::dataTimeoutCallback(const Interest& interest, int nRetrials,
-                            const NonNegativeInteger& signerSeqNo,
-                            const Interest& reqInterest)
+                            const shared_ptr<LogRequest>& logRequest, size_t index)
 {
   if (nRetrials > 0) {
     m_face.expressInterest(interest,
                            bind(&Logger::dataReceivedCallback, this, _1, _2,
-                                signerSeqNo, reqInterest),
+                                logRequest, index),
                            bind(&Logger::dataTimeoutCallback, this, _1,
-                                nRetrials - 1, signerSeqNo, reqInterest));
+                                nRetrials - 1, logRequest, index));
+  }
+  else
+    setLogResult(logRequest, index, tlv::LogResponse_Error_Fetch);
+}
+
+void
+Logger::setLogResult(const shared_ptr<LogRequest>& logRequest, size_t index,
+                     int code, const NonNegativeInteger& dataSeqNo)
+{
+  logRequest->codes[index] = code;
+  logRequest->dataSeqNos[index] = dataSeqNo;
+  if (--logRequest->nRemaining > 0)
+    return;
+
+  // a request none of whose Data could be fetched is not answered
+  bool hasFetched = false;
+  LoggerResponse response;
+  for (size_t i = 0; i < logRequest->codes.size(); i++) {
+    switch (logRequest->codes[i]) {
+    case tlv::LogResponse_Accept:
+      response.addEntry(logRequest->dataSeqNos[i]);
+      break;
+    case tlv::LogResponse_Error_Tree:
+      response.addEntry(tlv::LogResponse_Error_Tree, "cannot add leaf");
+      break;
+    case tlv::LogResponse_Error_Policy:
+      response.addEntry(tlv::LogResponse_Error_Policy, "cannot pass policy checking");
+      break;
+    case tlv::LogResponse_Error_Signer:
+      response.addEntry(tlv::LogResponse_Error_Signer, "signer is wrong");
+      break;
+    default:
+      response.addEntry(tlv::LogResponse_Error_Fetch, "cannot fetch data");
+      continue;
+    }
+    hasFetched = true;
   }
+
+  if (hasFetched)
+    makeLogResponse(logRequest->interest, response);
+  else
+    m_nPendingRequests--;
 }
 
 void
 Logger::makeLogResponse(const Interest& reqInterest, const LoggerResponse& response)
 {
   auto data = make_shared<Data>(reqInterest.getName());
+
+  bool hasAccepted = false;
+  for (size_t i = 0; i < response.getNEntries(); i++)
+    hasAccepted = hasAccepted || response.getCode(i) == tlv::LogResponse_Accept;
+
+  // an accepted leaf is acknowledged only after its group has been committed
+  if (hasAccepted) {
+    m_nCommitQueued++;
+    m_db.whenCommitted([this, data, response] {
+        m_nCommitQueued--;
+        signLogResponse(data, response);
+      });
+  }
+  else
+    signLogResponse(data, response);
+}
+
+void
+Logger::signLogResponse(const shared_ptr<Data>& data, const LoggerResponse& response)
+{
+  if (m_signBatchWindow > time::milliseconds::zero()) {
+    m_responseBatch.push_back(std::make_pair(data, response));
+    if (m_responseBatch.size() >= N_MAX_RESPONSES_PER_BATCH) {
+      m_scheduler.cancelEvent(m_signBatchEvent);
+      signResponseBatch();
+    }
+    else if (m_responseBatch.size() == 1)
+      m_signBatchEvent = m_scheduler.scheduleEvent(m_signBatchWindow,
+                                                   bind(&Logger::signResponseBatch, this));
+    return;
+  }
+
   data->setContent(response.wireEncode());
+  m_signPool->post([this, data] {
+      signWithDsk(*data);
+
+      runOnFaceThread(*m_signPool, [this, data] {
+          m_nPendingRequests--;
+          m_face.put(*data);
+        });
+    });
+}
 
+void
+Logger::signResponseBatch()
+{
+  if (m_responseBatch.empty())
+    return;
+
+  typedef std::vector<std::pair<shared_ptr<Data>, LoggerResponse>> Batch;
+  auto batch = make_shared<Batch>();
+  batch->swap(m_responseBatch);
+
+  m_signPool->post([this, batch] {
+      std::vector<Sha256Digest> leafHashes;
+      leafHashes.reserve(batch->size());
+      for (const auto& item : *batch)
+        leafHashes.push_back(item.second.computeBatchLeafHash(item.first->getName()));
+      ResponseBatch tree(leafHashes);
+      const Sha256Digest& rootHash = tree.getRootHash();
+
+      Name rootName = m_batchPrefix;
+      rootName.append(rootHash.data(), rootHash.size());
+      Data root(rootName);
+      root.setContent(rootHash.data(), rootHash.size());
+      signWithDsk(root);
+
+      for (size_t i = 0; i < batch->size(); i++) {
+        Data& data = *(*batch)[i].first;
+        LoggerResponse& response = (*batch)[i].second;
+        response.setBatchProof(i, tree.getPath(i), root);
+        data.setContent(response.wireEncode());
+        signWithDigest(data);
+      }
+
+      runOnFaceThread(*m_signPool, [this, batch] {
+          for (const auto& item : *batch) {
+            m_nPendingRequests--;
+            m_face.put(*item.first);
+          }
+        });
+    });
+}
+
+void
+Logger::signWithDsk(Data& data)
+{
   BOOST_ASSERT(m_dskCert != nullptr);
-  m_keyChain.sign(*data, m_dskCert->getName());
-  m_face.put(*data);
+
+  if (m_signPool->getNThreads() == 0) {
+    m_keyChain.sign(data, m_dskCert->getName());
+    return;
+  }
+
+  // there are as many KeyChains as sign threads, so one of them is always idle
+  ndn::KeyChain* keyChain = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_signKeyChainsMutex);
+    BOOST_ASSERT(!m_idleSignKeyChains.empty());
+    keyChain = m_idleSignKeyChains.back();
+    m_idleSignKeyChains.pop_back();
+  }
+
+  try {
+    keyChain->sign(data, m_dskCert->getName());
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(m_signKeyChainsMutex);
+    m_idleSignKeyChains.push_back(keyChain);
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(m_signKeyChainsMutex);
+  m_idleSignKeyChains.push_back(keyChain);
+}
+
+void
+Logger::signWithDigest(Data& data)
+{
+  // the same as KeyChain::signWithSha256, without going through a KeyChain
+  ndn::DigestSha256 sig;
+  data.setSignature(sig);
+
+  Block sigValue(tlv::SignatureValue,
+                 ndn::crypto::sha256(data.wireEncode().value(),
+                                     data.wireEncode().value_size() -
+                                     data.getSignature().getValue().size()));
+  data.setSignatureValue(sigValue);
+
+  data.wireEncode();
+}
+
+void
+Logger::runOnFaceThread(const WorkerPool& pool, const function<void()>& task)
+{
+  if (pool.getNThreads() == 0) {
+    task();
+    return;
+  }
+
+  weak_ptr<int> lifetime = m_lifetime;
+  m_face.getIoService().post([lifetime, task] {
+      if (!lifetime.expired())
+        task();
+    });
+}
+
+void
+Logger::scheduleGroupCommit()
+{
+  if (!m_db.hasPendingCommit() || m_isCommitScheduled)
+    return;
+
+  m_isCommitScheduled = true;
+  m_scheduler.scheduleEvent(m_db.getGroupCommitWindow(), [this] {
+      m_isCommitScheduled = false;
+      try {
+        m_db.commit();
+        m_nCommitRetries = 0;
+      }
+      catch (Db::Error& e) {
+        m_nFailedCommits++;
+        if (++m_nCommitRetries > N_MAX_COMMIT_RETRIES)
+          throw Error("Logger: cannot commit the appended leaves: " + std::string(e.what()));
+
+        // the group is still open, its responses wait for the next attempt
+        scheduleGroupCommit();
+      }
+    });
+}
+
+void
+Logger::scheduleCheckpoint()
+{
+  NonNegativeInteger nUnsavedLeaves = m_merkleTree.getNUnsavedLeaves();
+  if (nUnsavedLeaves == 0)
+    return;
+
+  if (m_checkpointInterval > 0 && nUnsavedLeaves >= m_checkpointInterval) {
+    saveCheckpoint();
+    return;
+  }
+
+  if (m_checkpointPeriod == time::milliseconds::zero() || m_isCheckpointScheduled)
+    return;
+
+  m_isCheckpointScheduled = true;
+  m_scheduler.scheduleEvent(m_checkpointPeriod, [this] {
+      m_isCheckpointScheduled = false;
+      saveCheckpoint();
+      scheduleGroupCommit();
+    });
+}
+
+void
+Logger::saveCheckpoint()
+{
+  try {
+    m_merkleTree.savePendingTree();
+  }
+  catch (Db::Error&) {
+    // the subtrees are saved again by the next checkpoint, a transaction left open by a failed
+    // commit is retried as a group
+    m_nFailedCheckpoints++;
+  }
+}
+
+void
+Logger::replayLeaves()
+{
+  NonNegativeInteger first = m_merkleTree.getNextLeafSeqNo();
+  NonNegativeInteger last = m_db.getNextLeafSeqNo();
+  if (first >= last)
+    return;
+
+  std::vector<Sha256Digest> leafHashes;
+  // the hash of a leaf is the one of its encoding
+  m_db.getEncodedLeafRange(first, last, [&leafHashes] (const uint8_t* wire, size_t size) {
+      leafHashes.push_back(computeSha256Digest(wire, size));
+    });
+
+  if (leafHashes.size() != last - first || !m_merkleTree.addLeaves(first, leafHashes))
+    throw Error("Logger: cannot replay the leaves appended after the last checkpoint");
+
+  m_merkleTree.savePendingTree();
+  m_db.commit();
 }
 
 
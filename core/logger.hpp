@@ -28,11 +28,19 @@
 #include "policy-checker.hpp"
 #include "merkle-tree.hpp"
 #include "util/non-negative-integer.hpp"
+#include "response-batch.hpp"
+#include "signer-cache.hpp"
+#include "verification-queue.hpp"
+#include "util/worker-pool.hpp"
 
 #include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/security/validator-config.hpp>
 
+#include <atomic>
+#include <mutex>
+
 namespace ndn {
 namespace delorean {
 
@@ -49,25 +57,132 @@ public:
     }
   };
 
+  /**
+   * @brief The state of the log request pipeline
+   *
+   * A log request goes through: fetching the Data, verification (verification queue), appending
+   * to the tree and the db in the order the Data was fetched (face thread), group commit, and
+   * response signing (sign pool).
+   */
+  struct PipelineStatus
+  {
+    /// requests admitted and not answered yet
+    size_t nPendingRequests;
+    /// fetched Data waiting for a verification thread
+    size_t nVerifyQueued;
+    /// verified Data waiting to be appended on the face thread, in order
+    size_t nAppendQueued;
+    /// accepted leaves waiting for their group to be committed
+    size_t nCommitQueued;
+    /// responses waiting for their batch to be closed
+    size_t nBatchQueued;
+    /// responses waiting for a signing thread
+    size_t nSignQueued;
+    /// requests answered with LogResponse_Error_Busy because the pipeline was full
+    uint64_t nRejectedRequests;
+    /// group commits which failed and were retried
+    uint64_t nFailedCommits;
+    /// checkpoints which failed to save the pending subtrees, they are saved by the next one
+    uint64_t nFailedCheckpoints;
+  };
+
 public:
   Logger(ndn::Face& face, const std::string& configFile);
 
+  PipelineStatus
+  getPipelineStatus() const;
+
   NonNegativeInteger
   addSelfSignedCert(ndn::IdentityCertificate& cert, const Timestamp& timestamp);
 
 NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief A log request being processed, with the result of each requested Data
+   */
+  struct LogRequest
+  {
+    Interest interest;
+    NonNegativeInteger signerSeqNo;
+    shared_ptr<const SignerCache::Signer> signer;
+    /// result code of each Data, in the order of the request
+    std::vector<int> codes;
+    /// seqNo of each accepted Data
+    std::vector<NonNegativeInteger> dataSeqNos;
+    /// Data without a result yet
+    size_t nRemaining;
+  };
+
   void
   initializeKeys();
 
   void
   loadConfiguration(const std::string& filename);
 
+  /**
+   * @brief Set up the log request pipeline from the pipeline section of the config file
+   *
+   *   pipeline
+   *   {
+   *     verify-threads 4           ; threads checking the fetched Data against the policy,
+   *                                ; 0 checks on the face thread
+   *     sign-threads 1             ; threads signing the log responses, 0 signs on the face thread
+   *     max-pending-requests 1024  ; requests admitted at a time, further ones are answered busy
+   *                                ; until some are answered, 0 means no limit
+   *     signer-cache-size 1024     ; signer certificates kept parsed, 0 disables the cache
+   *     sign-batch-window 0        ; milliseconds the responses are collected for, to sign the
+   *                                ; root of their ResponseBatch once, 0 signs each response
+   *     checkpoint-interval 1024   ; leaves appended before the changed pending subtrees are
+   *                                ; saved, 0 for no limit
+   *     checkpoint-period 1000     ; milliseconds a leaf may stay unsaved, 0 for no limit
+   *   }
+   *
+   * The tree and the db are only touched on the face thread.  The verified Data is appended in
+   * the order it was fetched, whichever verification thread finishes first.
+   *
+   * The leaves appended after the last checkpoint are replayed on the next start, so the
+   * checkpoint options bound the recovery after an unclean shutdown.  With both set to 0, the
+   * pending subtrees are only saved on shutdown.
+   *
+   * @throw Error if the config is invalid
+   */
+  void
+  loadPipelineConfig(const conf::ConfigSection& config);
+
   void
   onSubTreeInterest(const ndn::InterestFilter& interestFilter, const Interest& interest);
 
   void
   onLeafInterest(const ndn::InterestFilter& interestFilter, const Interest& interest);
 
+  /**
+   * @brief Answer /<logger>/leaves/<first>/<last>[/<segment>] with segmented Data
+   *
+   * The leaves from first (inclusive) to last (exclusive) are split into segments of
+   * N_LEAVES_PER_SEGMENT leaves, each segment carrying the concatenated LoggerLeaf blocks.
+   * A range is only answered once all its leaves are committed.
+   */
+  void
+  onLeafRangeInterest(const ndn::InterestFilter& interestFilter, const Interest& interest);
+
+  /**
+   * @brief Answer proof requests with segmented Data
+   *
+   * The requests are /<logger>/proof/existence/<seqNo>/<treeSize>[/<segment>] and
+   * /<logger>/proof/consistency/<oldTreeSize>/<treeSize>[/<segment>].  The proof is split into
+   * segments of N_SUBTREES_PER_SEGMENT subtree Data packets.  A proof is only answered once
+   * treeSize leaves are committed.
+   */
+  void
+  onProofInterest(const ndn::InterestFilter& interestFilter, const Interest& interest);
+
+  /**
+   * @brief Validate a signed log request
+   *
+   * The request is /<logger>/log/<data>/<signerSeqNo>/<signature components>, where <data> is
+   * either the wire encoding of a Data name, or of a DataNameList TLV carrying several Data names
+   * to log at once.  Each Data is fetched and verified separately, and the request is answered
+   * with one LoggerResponse holding an entry per Data, in the order of the request.
+   */
   void
   onLogRequestInterest(const ndn::InterestFilter& interestFilter, const Interest& interest);
 
@@ -76,17 +191,122 @@ NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
 
   void
   dataReceivedCallback(const Interest& interest, Data& data,
-                       const NonNegativeInteger& signerSeqNo,
-                       const Interest& reqInterest);
+                       const shared_ptr<LogRequest>& logRequest, size_t index);
+
+  /**
+   * @brief Get the parsed certificate of a signer, from the signer cache or the db
+   *
+   * @return the signer, or nullptr if it is not in the log
+   */
+  shared_ptr<const SignerCache::Signer>
+  getSigner(const NonNegativeInteger& signerSeqNo);
+
+  /**
+   * @brief Check fetched Data against the rules of the policy, on the face thread
+   *
+   * The rules are not thread-safe, so only the signature is left to verifyData.
+   *
+   * @return LogResponse_Accept, LogResponse_Error_Policy or LogResponse_Error_Signer
+   */
+  int
+  checkPolicy(const Timestamp& dataTimestamp, const Data& data, const SignerCache::Signer& signer);
+
+  /**
+   * @brief Verify the signature of Data which passed checkPolicy with the cached verifier of
+   *        @p signer, may run on a verification thread
+   *
+   * @return LogResponse_Accept, LogResponse_Error_Policy or LogResponse_Error_Signer
+   */
+  int
+  verifyData(const Data& data, const SignerCache::Signer& signer);
+
+  /**
+   * @brief Append verified Data to the tree and the db, and record the result in the request
+   */
+  void
+  appendLeaf(int verdict, const Timestamp& dataTimestamp, const Data& data,
+             const shared_ptr<LogRequest>& logRequest, size_t index);
 
   void
   dataTimeoutCallback(const Interest& interest, int nRetrials,
-                      const NonNegativeInteger& signerSeqNo,
-                      const Interest& reqInterest);
+                      const shared_ptr<LogRequest>& logRequest, size_t index);
+
+  /**
+   * @brief Record the result of the Data at @p index, and respond once every Data has one
+   */
+  void
+  setLogResult(const shared_ptr<LogRequest>& logRequest, size_t index,
+               int code, const NonNegativeInteger& dataSeqNo = 0);
 
   void
   makeLogResponse(const Interest& reqInterest, const LoggerResponse& response);
 
+  /**
+   * @brief Sign each response, or queue it for the next batch if batches are enabled
+   */
+  void
+  signLogResponse(const shared_ptr<Data>& data, const LoggerResponse& response);
+
+  /**
+   * @brief Sign the root of the queued responses once, and send them with their batch proofs
+   *
+   * The root is /<logger>/batch/<root hash>, signed with the DSK.  The response Data themselves
+   * are only protected by a digest.
+   */
+  void
+  signResponseBatch();
+
+  /**
+   * @brief Sign @p data with the DSK, may run on a sign thread
+   *
+   * A sign thread uses an idle KeyChain of m_signKeyChains, the face thread uses m_keyChain.
+   */
+  void
+  signWithDsk(Data& data);
+
+  /**
+   * @brief Protect @p data with a DigestSha256 signature, which is thread-safe
+   */
+  static void
+  signWithDigest(Data& data);
+
+  /**
+   * @brief Run @p task on the face thread once a task of @p pool is done
+   *
+   * The task runs inline if @p pool has no thread, and it is dropped if the logger is gone.
+   */
+  void
+  runOnFaceThread(const WorkerPool& pool, const function<void()>& task);
+
+  /**
+   * @brief Make sure that an open group of appends is committed within the group commit window
+   */
+  void
+  scheduleGroupCommit();
+
+  /**
+   * @brief Save the changed pending subtrees once enough leaves have been appended, or make
+   *        sure they are saved within the checkpoint period
+   *
+   * With group commit, the subtrees join the open group of the appends they follow.
+   */
+  void
+  scheduleCheckpoint();
+
+  /**
+   * @brief Save the changed pending subtrees, a failure is left to the next checkpoint
+   */
+  void
+  saveCheckpoint();
+
+  /**
+   * @brief Add the leaves appended after the last checkpoint, e.g., before a crash, to the tree
+   *
+   * @throw Error if the leaves cannot be added
+   */
+  void
+  replayLeaves();
+
   const Name&
   getLoggerName() const
   {
@@ -105,6 +325,18 @@ NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
     return m_leafPrefix;
   }
 
+  const Name&
+  getLeafRangePrefix() const
+  {
+    return m_leafRangePrefix;
+  }
+
+  const Name&
+  getProofPrefix() const
+  {
+    return m_proofPrefix;
+  }
+
   const Name&
   getLogPrefix() const
   {
@@ -117,14 +349,52 @@ NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
     return m_db;
   }
 
+  const MerkleTree&
+  getMerkleTree() const
+  {
+    return m_merkleTree;
+  }
+
+  shared_ptr<const ndn::IdentityCertificate>
+  getDskCertificate() const
+  {
+    return m_dskCert;
+  }
+
+  const SignerCache&
+  getSignerCache() const
+  {
+    return m_signerCache;
+  }
+
 private:
   static const int N_DATA_FETCHING_RETRIAL;
 
+NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  static const size_t N_LEAVES_PER_SEGMENT;
+  static const size_t N_SUBTREES_PER_SEGMENT;
+  static const std::string COMPONENT_EXISTENCE;
+  static const std::string COMPONENT_CONSISTENCY;
+  static const size_t DEFAULT_SIGNER_CACHE_SIZE;
+  static const size_t N_MAX_RESPONSES_PER_BATCH;
+  static const size_t DEFAULT_CHECKPOINT_INTERVAL;
+  static const time::milliseconds DEFAULT_CHECKPOINT_PERIOD;
+  static const size_t N_MAX_COMMIT_RETRIES;
+
 private:
   ndn::Face& m_face;
+  ndn::util::Scheduler m_scheduler;
+  bool m_isCommitScheduled;
+  /// failed attempts to commit the open group, Error is thrown once there are too many
+  size_t m_nCommitRetries;
+  uint64_t m_nFailedCommits;
+
   Name m_loggerName;
   Name m_treePrefix;
   Name m_leafPrefix;
+  Name m_leafRangePrefix;
+  Name m_proofPrefix;
+  Name m_batchPrefix;
   Name m_logPrefix;
 
   Db m_db;
@@ -135,6 +405,33 @@ private:
 
   ndn::ValidatorConfig m_validator;
   PolicyChecker m_policyChecker;
+  SignerCache m_signerCache;
+
+  /// a KeyChain for each sign thread, m_keyChain is only used on the face thread
+  std::vector<std::unique_ptr<ndn::KeyChain>> m_signKeyChains;
+  std::vector<ndn::KeyChain*> m_idleSignKeyChains;
+  std::mutex m_signKeyChainsMutex;
+
+  size_t m_maxPendingRequests;
+  size_t m_nPendingRequests;
+  size_t m_nCommitQueued;
+
+  time::milliseconds m_signBatchWindow;
+  std::vector<std::pair<shared_ptr<Data>, LoggerResponse>> m_responseBatch;
+  ndn::util::scheduler::EventId m_signBatchEvent;
+  uint64_t m_nRejectedRequests;
+
+  size_t m_checkpointInterval;
+  time::milliseconds m_checkpointPeriod;
+  bool m_isCheckpointScheduled;
+  uint64_t m_nFailedCheckpoints;
+
+  /// expires with the logger, so that the tasks posted back to the face can tell
+  shared_ptr<int> m_lifetime;
+
+  // destroyed first, while what their tasks use is still there
+  std::unique_ptr<VerificationQueue> m_verificationQueue;
+  std::unique_ptr<WorkerPool> m_signPool;
 };
 
 } // namespace delorean
@@ -27,6 +27,9 @@ namespace delorean {
 MerkleTree::MerkleTree(Db& db)
   : m_db(db)
   , m_nextLeafSeqNo(0)
+  , m_hash(Node::getEmptyHash())
+  , m_savedLeafSeqNo(0)
+  , m_isFrontierSaved(false)
 {
 }
 
@@ -34,13 +37,21 @@ MerkleTree::MerkleTree(const Name& loggerName, Db& db)
   : m_loggerName(loggerName)
   , m_db(db)
   , m_nextLeafSeqNo(0)
+  , m_hash(Node::getEmptyHash())
+  , m_savedLeafSeqNo(0)
+  , m_isFrontierSaved(false)
 {
   loadPendingSubTrees();
 }
 
 MerkleTree::~MerkleTree()
 {
-  savePendingTree();
+  try {
+    savePendingTree();
+  }
+  catch (Db::Error&) {
+    // the next start replays the leaves appended since the last save
+  }
 }
 
 void
@@ -50,31 +61,101 @@ MerkleTree::setLoggerName(const Name& loggerName)
 }
 
 bool
-MerkleTree::addLeaf(const NonNegativeInteger& seqNo, ndn::ConstBufferPtr hash)
+MerkleTree::addLeaf(const NonNegativeInteger& seqNo, const Sha256Digest& hash)
 {
-  auto baseTree = m_pendingTrees[SubTreeBinary::SUB_TREE_DEPTH - 1];
+  // keep a reference, the base tree is replaced in m_pendingTrees once it is complete
+  auto baseTree = m_pendingTrees[SubTreeBinary::STEP];
   BOOST_ASSERT(baseTree != nullptr);
 
-  NodePtr leaf = make_shared<Node>(seqNo, 0, seqNo + 1, hash);
-  return baseTree->addLeaf(leaf);
+  return baseTree->addLeaf(Node(seqNo, 0, seqNo + 1, hash));
 }
 
-void
+bool
+MerkleTree::addLeaves(const NonNegativeInteger& firstSeqNo,
+                      const std::vector<Sha256Digest>& hashes)
+{
+  if (firstSeqNo != m_nextLeafSeqNo)
+    return false;
+
+  size_t nAdded = 0;
+  while (nAdded < hashes.size()) {
+    auto baseTree = m_pendingTrees[SubTreeBinary::STEP];
+    BOOST_ASSERT(baseTree != nullptr);
+
+    // fill the base tree up, a complete base tree is replaced by its sibling
+    size_t n = baseTree->addLeaves(firstSeqNo + nAdded, hashes.data() + nAdded,
+                                   hashes.size() - nAdded);
+    if (n == 0)
+      return false;
+
+    nAdded += n;
+  }
+
+  return true;
+}
+
+size_t
 MerkleTree::savePendingTree()
 {
-  size_t level = m_rootSubTree->getPeakIndex().level;
-  size_t step = SubTreeBinary::SUB_TREE_DEPTH - 1;
+  if (m_pendingTrees.empty())
+    return 0;
+
+  size_t nSaved = 0;
+  m_db.runInTransaction([this, &nSaved] {
+      for (const auto& item : m_pendingTrees) {
+        const auto& pendingTree = item.second;
+        BOOST_ASSERT(pendingTree != nullptr);
+
+        // a subtree which has not changed is already in the db
+        auto saved = m_savedVersions.find(item.first);
+        if (saved != m_savedVersions.end() &&
+            saved->second.first == pendingTree->getPeakIndex() &&
+            saved->second.second == pendingTree->getVersion())
+          continue;
 
-  for (size_t i = level; i > 0; i -= step) {
-    auto pendingTree = m_pendingTrees[i];
-    BOOST_ASSERT(pendingTree != nullptr);
+        auto data = pendingTree->encode();
+        if (data != nullptr) {
+          m_db.insertSubTreeData(pendingTree->getPeakIndex().level,
+                                 pendingTree->getPeakIndex().seqNo,
+                                 *data, false, pendingTree->getNextLeafSeqNo());
+          nSaved++;
+        }
+      }
 
-    auto data = pendingTree->encode();
-    if (data != nullptr) {
-      m_db.insertSubTreeData(pendingTree->getPeakIndex().level, pendingTree->getPeakIndex().seqNo,
-                             *data, false, pendingTree->getNextLeafSeqNo());
+      if (nSaved > 0 || !m_isFrontierSaved)
+        m_db.insertFrontier(getFrontier());
+    });
+
+  markSaved();
+  m_isFrontierSaved = true;
+  return nSaved;
+}
+
+Frontier
+MerkleTree::getFrontier() const
+{
+  Frontier frontier(m_nextLeafSeqNo, m_hash);
+
+  // from the root subtree down to the base one
+  for (auto it = m_pendingTrees.rbegin(); it != m_pendingTrees.rend(); it++) {
+    const auto& pendingTree = it->second;
+    size_t leafLevel = pendingTree->getLeafLevel();
+    NonNegativeInteger leafRange = static_cast<NonNegativeInteger>(1) << leafLevel;
+
+    // an incomplete last leaf is the root of the next pending subtree, it is left out
+    std::vector<Sha256Digest> leafHashes;
+    for (NonNegativeInteger seqNo = pendingTree->getPeakIndex().seqNo; ; seqNo += leafRange) {
+      auto leaf = pendingTree->getNode(Node::Index(seqNo, leafLevel));
+      if (leaf == nullptr || !leaf->hasHash() || leaf->getLeafSeqNo() != seqNo + leafRange)
+        break;
+
+      leafHashes.push_back(leaf->getHash());
     }
+
+    frontier.addSubTree(pendingTree->getPeakIndex(), leafHashes);
   }
+
+  return frontier;
 }
 
 shared_ptr<Data>
@@ -87,38 +168,136 @@ MerkleTree::getPendingSubTreeData(size_t level)
     return nullptr;
 }
 
+std::vector<shared_ptr<Data>>
+MerkleTree::getExistenceProof(const NonNegativeInteger& seqNo, const NonNegativeInteger& treeSize)
+{
+  std::vector<shared_ptr<Data>> proof;
+  if (seqNo >= treeSize || treeSize > m_nextLeafSeqNo)
+    return proof;
+
+  size_t rootLevel = 0;
+  for (NonNegativeInteger n = treeSize - 1; n != 0; n = n >> 1)
+    rootLevel++;
+
+  // a subtree holds the nodes of the path from its leaf level up to below its peak, the first
+  // subtree is needed even if the root is the leaf itself
+  size_t step = SubTreeBinary::STEP;
+  for (size_t peakLevel = step; peakLevel == step || peakLevel - step < rootLevel;
+       peakLevel += step) {
+    Node::Index peakIndex((seqNo >> peakLevel) << peakLevel, peakLevel);
+
+    auto subtree = getSubTree(peakIndex, treeSize);
+    if (subtree == nullptr)
+      return std::vector<shared_ptr<Data>>();
+
+    proof.push_back(subtree->encode());
+  }
+
+  return proof;
+}
+
+std::vector<shared_ptr<Data>>
+MerkleTree::getConsistencyProof(const NonNegativeInteger& oldTreeSize,
+                                const NonNegativeInteger& treeSize)
+{
+  if (oldTreeSize == 0 || oldTreeSize > treeSize)
+    return std::vector<shared_ptr<Data>>();
+
+  return getExistenceProof(oldTreeSize - 1, treeSize);
+}
+
 // private:
+ConstSubTreeBinaryPtr
+MerkleTree::getSubTree(const Node::Index& peakIndex, const NonNegativeInteger& treeSize)
+{
+  ConstSubTreeBinaryPtr current;
+
+  auto it = m_pendingTrees.find(peakIndex.level);
+  if (it != m_pendingTrees.end() && it->second->getPeakIndex() == peakIndex) {
+    current = it->second;
+  }
+  else {
+    auto data = m_db.getSubTreeData(peakIndex.level, peakIndex.seqNo);
+    if (data == nullptr)
+      return nullptr;
+
+    auto subtree = make_shared<SubTreeBinary>(m_loggerName,
+                                              [] (const Node::Index&) {},
+                                              [] (const Node::Index&,
+                                                  const NonNegativeInteger&,
+                                                  const Sha256Digest&) {});
+    try {
+      subtree->decode(*data);
+    }
+    catch (SubTreeBinary::Error&) {
+      return nullptr;
+    }
+    current = subtree;
+  }
+
+  if (current->getRoot() == nullptr || treeSize <= peakIndex.seqNo)
+    return nullptr;
+
+  // no leaf has been added to the subtree since
+  if (current->getNextLeafSeqNo() <= treeSize)
+    return current;
+
+  auto subtree = make_shared<SubTreeBinary>(m_loggerName, peakIndex,
+                                            [] (const Node::Index&) {},
+                                            [] (const Node::Index&,
+                                                const NonNegativeInteger&,
+                                                const Sha256Digest&) {});
+
+  size_t leafLevel = subtree->getLeafLevel();
+  NonNegativeInteger leafRange = static_cast<NonNegativeInteger>(1) << leafLevel;
+
+  // the leaves that were complete then have not changed
+  std::vector<Sha256Digest> leafHashes;
+  NonNegativeInteger seqNo = peakIndex.seqNo;
+  for (; seqNo + leafRange <= treeSize; seqNo += leafRange) {
+    auto leaf = current->getNode(Node::Index(seqNo, leafLevel));
+    if (leaf == nullptr)
+      return nullptr;
+
+    leafHashes.push_back(leaf->getHash());
+  }
+  if (!leafHashes.empty())
+    subtree->addLeaves(peakIndex.seqNo, leafHashes.data(), leafHashes.size());
+
+  // the last leaf was the root of a pending subtree
+  if (seqNo < treeSize) {
+    auto child = getSubTree(Node::Index(seqNo, leafLevel), treeSize);
+    if (child == nullptr)
+      return nullptr;
+
+    subtree->addLeaf(Node(seqNo, leafLevel, treeSize, child->getRootHash()));
+  }
+
+  return subtree;
+}
+
 void
 MerkleTree::loadPendingSubTrees()
 {
-  std::vector<shared_ptr<Data>> subtreeDatas = m_db.getPendingSubTrees();
+  // the leaves appended after the frontier, e.g., before a crash, are left to the caller
+  auto frontier = m_db.getLastFrontier();
+  if (frontier != nullptr && loadFrontier(*frontier)) {
+    markSaved();
+    m_isFrontierSaved = true;
+    return;
+  }
 
-  shared_ptr<SubTreeBinary> subtree;
+  std::vector<shared_ptr<Data>> subtreeDatas = m_db.getPendingSubTrees();
   if (subtreeDatas.empty()) {
-    subtree = make_shared<SubTreeBinary>(m_loggerName,
-      Node::Index(0, SubTreeBinary::SUB_TREE_DEPTH - 1),
-      [this] (const Node::Index& idx) {
-        // std::cerr << "complete: " << idx.level << ", " << idx.seqNo << std::endl;
-        this->getNewRoot(idx);
-      },
-      [this] (const Node::Index& idx,
-              const NonNegativeInteger& seqNo,
-              ndn::ConstBufferPtr hash) {
-        // std::cerr << "update: " << idx.level << ", " << idx.seqNo << std::endl;
-        // std::cerr << "seqNo: " << seqNo << std::endl;
-        this->m_nextLeafSeqNo = seqNo;
-        this->m_hash = hash;
-      });
-    m_pendingTrees[SubTreeBinary::SUB_TREE_DEPTH - 1] = subtree;
-    m_rootSubTree = subtree;
+    loadEmptyTree();
     return;
   }
 
-  subtree = make_shared<SubTreeBinary>(m_loggerName,
+  shared_ptr<SubTreeBinary> subtree = make_shared<SubTreeBinary>(m_loggerName,
     [this] (const Node::Index& idx) { this->getNewRoot(idx); },
     [this] (const Node::Index& idx,
             const NonNegativeInteger& seqNo,
-            ndn::ConstBufferPtr hash) {
+            const Sha256Digest& hash) {
       this->m_nextLeafSeqNo = seqNo;
       this->m_hash = hash;
     });
@@ -135,7 +314,7 @@ MerkleTree::loadPendingSubTrees()
       },
       [parentTree] (const Node::Index&,
            const NonNegativeInteger& seqNo,
-           ndn::ConstBufferPtr hash) {
+           const Sha256Digest& hash) {
         parentTree->updateLeaf(seqNo, hash);
       });
 
@@ -150,6 +329,132 @@ MerkleTree::loadPendingSubTrees()
     m_pendingTrees[subtree->getPeakIndex().level] = subtree;
     parentTree = subtree;
   }
+
+  // a subtree completed after the last save has left pTrees, so the pending subtrees end
+  // above the base one, in which case the whole tree is rebuilt from the leaves
+  if (m_pendingTrees.find(SubTreeBinary::STEP) == m_pendingTrees.end()) {
+    loadEmptyTree();
+    return;
+  }
+
+  // the subtrees are those in pTrees, but no frontier has been saved with them
+  markSaved();
+}
+
+void
+MerkleTree::loadEmptyTree()
+{
+  m_pendingTrees.clear();
+  m_nextLeafSeqNo = 0;
+  m_hash = Node::getEmptyHash();
+
+  auto subtree = make_shared<SubTreeBinary>(m_loggerName,
+    Node::Index(0, SubTreeBinary::STEP),
+    [this] (const Node::Index& idx) { this->getNewRoot(idx); },
+    [this] (const Node::Index& idx,
+            const NonNegativeInteger& seqNo,
+            const Sha256Digest& hash) {
+      this->m_nextLeafSeqNo = seqNo;
+      this->m_hash = hash;
+    });
+  m_pendingTrees[SubTreeBinary::STEP] = subtree;
+  m_rootSubTree = subtree;
+}
+
+bool
+MerkleTree::loadFrontier(const Frontier& frontier)
+{
+  const auto& pendingSubTrees = frontier.getSubTrees();
+  size_t step = SubTreeBinary::STEP;
+
+  // the subtrees must chain from the root subtree down to the base one, each starting where
+  // the complete leaves of its parent end
+  if (pendingSubTrees.empty() ||
+      pendingSubTrees.front().peakIndex.seqNo != 0 ||
+      pendingSubTrees.front().peakIndex.level >= 64 ||
+      pendingSubTrees.back().peakIndex.level != step)
+    return false;
+
+  for (size_t i = 0; i < pendingSubTrees.size(); i++) {
+    const auto& pendingSubTree = pendingSubTrees[i];
+    if (pendingSubTree.leafHashes.size() >= (static_cast<size_t>(1) << step))
+      return false;
+
+    if (i == 0)
+      continue;
+
+    const auto& parent = pendingSubTrees[i - 1];
+    const Node::Index& peakIndex = pendingSubTree.peakIndex;
+    if (peakIndex.level + step != parent.peakIndex.level ||
+        peakIndex.seqNo != parent.peakIndex.seqNo +
+                           (static_cast<NonNegativeInteger>(parent.leafHashes.size()) <<
+                            peakIndex.level))
+      return false;
+  }
+
+  // the current state is put back if the rebuilt tree does not match the frontier
+  std::map<size_t, shared_ptr<SubTreeBinary>> oldPendingTrees;
+  oldPendingTrees.swap(m_pendingTrees);
+  shared_ptr<SubTreeBinary> oldRootSubTree = m_rootSubTree;
+  NonNegativeInteger oldNextLeafSeqNo = m_nextLeafSeqNo;
+  Sha256Digest oldHash = m_hash;
+
+  m_nextLeafSeqNo = 0;
+  m_hash = Node::getEmptyHash();
+
+  shared_ptr<SubTreeBinary> parentTree;
+  for (const auto& pendingSubTree : pendingSubTrees) {
+    shared_ptr<SubTreeBinary> subtree;
+    if (parentTree == nullptr) {
+      subtree = make_shared<SubTreeBinary>(m_loggerName, pendingSubTree.peakIndex,
+        [this] (const Node::Index& idx) { this->getNewRoot(idx); },
+        [this] (const Node::Index&,
+                const NonNegativeInteger& seqNo,
+                const Sha256Digest& hash) {
+          this->m_nextLeafSeqNo = seqNo;
+          this->m_hash = hash;
+        });
+      m_rootSubTree = subtree;
+    }
+    else {
+      subtree = make_shared<SubTreeBinary>(m_loggerName, pendingSubTree.peakIndex,
+        [this] (const Node::Index& idx) { this->getNewSibling(idx); },
+        [parentTree] (const Node::Index&,
+                      const NonNegativeInteger& seqNo,
+                      const Sha256Digest& hash) {
+          parentTree->updateLeaf(seqNo, hash);
+        });
+    }
+
+    // the root of each subtree is propagated up to the root subtree
+    if (!pendingSubTree.leafHashes.empty())
+      subtree->addLeaves(pendingSubTree.peakIndex.seqNo, pendingSubTree.leafHashes.data(),
+                         pendingSubTree.leafHashes.size());
+
+    m_pendingTrees[pendingSubTree.peakIndex.level] = subtree;
+    parentTree = subtree;
+  }
+
+  if (m_nextLeafSeqNo != frontier.getNextLeafSeqNo() || m_hash != frontier.getRootHash()) {
+    m_pendingTrees.swap(oldPendingTrees);
+    m_rootSubTree = oldRootSubTree;
+    m_nextLeafSeqNo = oldNextLeafSeqNo;
+    m_hash = oldHash;
+    return false;
+  }
+
+  return true;
+}
+
+void
+MerkleTree::markSaved()
+{
+  m_savedVersions.clear();
+  for (const auto& item : m_pendingTrees) {
+    m_savedVersions[item.first] = std::make_pair(item.second->getPeakIndex(),
+                                                 item.second->getVersion());
+  }
+  m_savedLeafSeqNo = m_nextLeafSeqNo;
 }
 
 void
@@ -161,7 +466,7 @@ MerkleTree::getNewRoot(const Node::Index& idx)
   m_db.insertSubTreeData(idx.level, idx.seqNo, *oldRoot->encode());
 
   // create a new root tree
-  Node::Index newRootIdx(0, idx.level + SubTreeBinary::SUB_TREE_DEPTH - 1);
+  Node::Index newRootIdx(0, idx.level + SubTreeBinary::STEP);
   auto newRoot = make_shared<SubTreeBinary>(m_loggerName, newRootIdx,
     [this] (const Node::Index& idx) {
       // std::cerr << "complete: " << idx.level << ", " << idx.seqNo << std::endl;
@@ -169,7 +474,7 @@ MerkleTree::getNewRoot(const Node::Index& idx)
     },
     [this] (const Node::Index& index,
          const NonNegativeInteger& seqNo,
-         ndn::ConstBufferPtr hash) {
+         const Sha256Digest& hash) {
       // std::cerr << "update: " << index.level << ", " << index.seqNo << std::endl;
       // std::cerr << "seqNo: " << seqNo << std::endl;
       this->m_nextLeafSeqNo = seqNo;
@@ -179,7 +484,7 @@ MerkleTree::getNewRoot(const Node::Index& idx)
   m_pendingTrees[newRoot->getPeakIndex().level] = newRoot;
   m_rootSubTree = newRoot;
 
-  newRoot->updateLeaf(idx.seqNo + idx.range, oldRoot->getRoot()->getHash());
+  newRoot->updateLeaf(idx.seqNo + idx.range, oldRoot->getRootHash());
 
   // create a sibling
   getNewSibling(idx);
@@ -194,7 +499,7 @@ MerkleTree::getNewSibling(const Node::Index& idx)
   m_db.insertSubTreeData(idx.level, idx.seqNo, *oldSibling->encode());
 
   // get parent tree
-  Node::Index parentIdx(0, idx.level + SubTreeBinary::SUB_TREE_DEPTH - 1);
+  Node::Index parentIdx(0, idx.level + SubTreeBinary::STEP);
   auto parent = m_pendingTrees[parentIdx.level];
   BOOST_ASSERT(parent != nullptr);
 
@@ -205,7 +510,7 @@ MerkleTree::getNewSibling(const Node::Index& idx)
     [this] (const Node::Index& idx) { this->getNewSibling(idx); },
     [parent] (const Node::Index& index,
          const NonNegativeInteger& seqNo,
-         ndn::ConstBufferPtr hash) {
+         const Sha256Digest& hash) {
       // std::cerr << "update: " << index.level << ", " << index.seqNo << std::endl;
       // std::cerr << "seqNo: " << seqNo << std::endl;
       // std::cerr << "parent: " << parent->getRoot()->getIndex().level << ", " <<
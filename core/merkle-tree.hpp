@@ -62,46 +62,152 @@ public:
     return m_nextLeafSeqNo;
   }
 
-  const ndn::ConstBufferPtr&
+  /**
+   * @brief Get the root hash, which is the empty hash if the tree has no leaf yet
+   */
+  const Sha256Digest&
   getRootHash() const
   {
     return m_hash;
   }
 
   bool
-  addLeaf(const NonNegativeInteger& seqNo, ndn::ConstBufferPtr hash);
+  addLeaf(const NonNegativeInteger& seqNo, const Sha256Digest& hash);
+
+  /**
+   * @brief Append a batch of leaves, starting from the leaf at @p firstSeqNo
+   *
+   * The result is the same as adding the leaves one by one, but each interior node is hashed
+   * once per batch rather than once per leaf.
+   *
+   * @return false if @p firstSeqNo is not the next leaf seqNo, in which case nothing is added
+   */
+  bool
+  addLeaves(const NonNegativeInteger& firstSeqNo, const std::vector<Sha256Digest>& hashes);
 
+  /**
+   * @brief Load the pending subtrees, from the last frontier saved in the db if it is valid,
+   *        otherwise by decoding each pending subtree
+   *
+   * The tree may end before the leaves in the db, e.g., after a crash, the caller adds the
+   * leaves from getNextLeafSeqNo() on.  If the pending subtrees in the db do not reach down
+   * to a base subtree, the tree starts out empty.
+   */
   void
   loadPendingSubTrees();
 
-  void
+  /**
+   * @brief Save the pending subtrees which have changed since they were last saved, and the
+   *        frontier of the tree
+   *
+   * The writes are atomic, see Db::runInTransaction, so that the saved subtrees always make up
+   * one tree.
+   *
+   * @return the number of saved subtrees
+   */
+  size_t
   savePendingTree();
 
+  /**
+   * @brief Get the number of leaves added since the pending subtrees were last saved or loaded
+   */
+  NonNegativeInteger
+  getNUnsavedLeaves() const
+  {
+    return m_nextLeafSeqNo - m_savedLeafSeqNo;
+  }
+
+  /**
+   * @brief Get a snapshot of the pending subtrees
+   */
+  Frontier
+  getFrontier() const;
+
   shared_ptr<Data>
   getPendingSubTreeData(size_t level);
 
-  std::vector<ConstSubTreeBinaryPtr>
-  getExistenceProof(const NonNegativeInteger& seqNo);
+  /**
+   * @brief Get the subtrees proving that leaf @p seqNo is in the tree of the first @p treeSize
+   *        leaves
+   *
+   * These are the subtrees on the path from the leaf up to the root, from the bottom up, as
+   * they were when the tree had @p treeSize leaves, so the proof for a tree size never changes.
+   * Auditor::doesExist verifies it against the root of that tree.
+   *
+   * @return the subtree Data, empty if seqNo >= treeSize or treeSize > getNextLeafSeqNo()
+   */
+  std::vector<shared_ptr<Data>>
+  getExistenceProof(const NonNegativeInteger& seqNo, const NonNegativeInteger& treeSize);
 
-  std::vector<ConstSubTreeBinaryPtr>
-  getConsistencyProof(const NonNegativeInteger& seqNo);
+  /**
+   * @brief Get the subtrees proving that the tree of the first @p oldTreeSize leaves is a
+   *        prefix of the tree of the first @p treeSize leaves
+   *
+   * This is the existence proof of the last leaf of the old tree in the new tree, which is also
+   * its existence proof in the old tree.  Auditor::isConsistent verifies it.
+   *
+   * @return the subtree Data, empty if oldTreeSize is 0, oldTreeSize > treeSize or
+   *         treeSize > getNextLeafSeqNo()
+   */
+  std::vector<shared_ptr<Data>>
+  getConsistencyProof(const NonNegativeInteger& oldTreeSize, const NonNegativeInteger& treeSize);
+
+NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Rebuild the pending subtrees from @p frontier
+   *
+   * Only the complete leaves of the pending subtrees are hashed again, up to their peaks.
+   *
+   * @return false if the frontier is not the one of a tree or the rebuilt tree does not match
+   *         its root, in which case the tree is left unchanged
+   */
+  bool
+  loadFrontier(const Frontier& frontier);
 
 private:
+  /**
+   * @brief Get the subtree at @p peakIndex as it was when the tree had @p treeSize leaves
+   *
+   * A subtree that has changed since then is rebuilt from its complete leaves and, for its last
+   * leaf, from the child subtree as it was at that time.
+   *
+   * @return nullptr if the subtree is not found
+   */
+  ConstSubTreeBinaryPtr
+  getSubTree(const Node::Index& peakIndex, const NonNegativeInteger& treeSize);
+
   void
   getNewRoot(const Node::Index& idx);
 
   void
   getNewSibling(const Node::Index& idx);
 
+  /**
+   * @brief Start over with a tree without leaves
+   */
+  void
+  loadEmptyTree();
+
+  /**
+   * @brief Remember the pending subtrees as they are now as saved
+   */
+  void
+  markSaved();
+
 private:
   Name m_loggerName;
   Db& m_db;
 
   shared_ptr<SubTreeBinary> m_rootSubTree;
   NonNegativeInteger m_nextLeafSeqNo;
-  ndn::ConstBufferPtr m_hash;
+  Sha256Digest m_hash;
 
   std::map<size_t, shared_ptr<SubTreeBinary>> m_pendingTrees;
+
+  /// peak and version of the pending subtree of each level when it was last saved
+  std::map<size_t, std::pair<Node::Index, uint64_t>> m_savedVersions;
+  NonNegativeInteger m_savedLeafSeqNo;
+  bool m_isFrontierSaved;
 };
 
 } // namespace delorean
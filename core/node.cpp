@@ -20,19 +20,17 @@
  */
 
 #include "node.hpp"
+#include "util/sha256-node-hash.hpp"
 
-#include <ndn-cxx/util/digest.hpp>
 #include <boost/lexical_cast.hpp>
 
 namespace ndn {
 namespace delorean {
 
-ndn::ConstBufferPtr Node::EMPTY_HASH;
-
 Node::Index::Index(const NonNegativeInteger& nodeSeq, size_t nodeLevel)
   : seqNo(nodeSeq)
   , level(nodeLevel)
-  , range(1 << nodeLevel)
+  , range(static_cast<NonNegativeInteger>(1) << nodeLevel)
 {
   if (seqNo % range != 0)
     throw Error("Index: index level and seqNo do not match: (" +
@@ -79,10 +77,10 @@ Node::Index::equals(const Index& other) const
 
 Node::Node(const NonNegativeInteger& nodeSeqNo,
            size_t nodeLevel,
-           const NonNegativeInteger& leafSeqNo,
-           ndn::ConstBufferPtr hash)
+           const NonNegativeInteger& leafSeqNo)
   : m_index(nodeSeqNo, nodeLevel)
-  , m_hash(hash)
+  , m_hasHash(false)
+  , m_hash()
 {
   if (leafSeqNo == 0 && m_index.seqNo > leafSeqNo)
     m_leafSeqNo = m_index.seqNo;
@@ -90,6 +88,15 @@ Node::Node(const NonNegativeInteger& nodeSeqNo,
     setLeafSeqNo(leafSeqNo);
 }
 
+Node::Node(const NonNegativeInteger& nodeSeqNo,
+           size_t nodeLevel,
+           const NonNegativeInteger& leafSeqNo,
+           const Sha256Digest& hash)
+  : Node(nodeSeqNo, nodeLevel, leafSeqNo)
+{
+  setHash(hash);
+}
+
 void
 Node::setLeafSeqNo(const NonNegativeInteger& leafSeqNo)
 {
@@ -100,9 +107,10 @@ Node::setLeafSeqNo(const NonNegativeInteger& leafSeqNo)
 }
 
 void
-Node::setHash(ndn::ConstBufferPtr hash)
+Node::setHash(const Sha256Digest& hash)
 {
   m_hash = hash;
+  m_hasHash = true;
 }
 
 bool
@@ -111,16 +119,21 @@ Node::isFull() const
   return m_index.seqNo + m_index.range == m_leafSeqNo;
 }
 
-ndn::ConstBufferPtr
+const Sha256Digest&
 Node::getEmptyHash()
 {
-  if (EMPTY_HASH == nullptr) {
-    ndn::util::Sha256 sha256;
-    EMPTY_HASH = sha256.computeDigest();
-  }
-
+  static const Sha256Digest EMPTY_HASH = computeSha256Digest(nullptr, 0);
   return EMPTY_HASH;
 }
 
+Sha256Digest
+Node::computeHash(const Index& index, const Sha256Digest& left, const Sha256Digest& right)
+{
+  Sha256Digest digest;
+  Sha256NodeHashJob job{index.level, index.seqNo, &left, &right, &digest};
+  computeNodeHashes(&job, 1);
+  return digest;
+}
+
 } // namespace delorean
 } // namespace ndn
@@ -24,7 +24,7 @@
 
 #include "common.hpp"
 #include "util/non-negative-integer.hpp"
-#include <ndn-cxx/encoding/buffer.hpp>
+#include "util/sha256-digest.hpp"
 
 namespace ndn {
 namespace delorean {
@@ -73,10 +73,17 @@ public:
   };
 
 public:
+  /**
+   * @brief Create a node without hash
+   */
   Node(const NonNegativeInteger& seqNo,
        size_t level,
-       const NonNegativeInteger& leafSeqNo = 0,
-       ndn::ConstBufferPtr hash = nullptr);
+       const NonNegativeInteger& leafSeqNo = 0);
+
+  Node(const NonNegativeInteger& seqNo,
+       size_t level,
+       const NonNegativeInteger& leafSeqNo,
+       const Sha256Digest& hash);
 
   const Index&
   getIndex() const
@@ -94,9 +101,18 @@ public:
   }
 
   void
-  setHash(ndn::ConstBufferPtr hash);
+  setHash(const Sha256Digest& hash);
 
-  ndn::ConstBufferPtr
+  bool
+  hasHash() const
+  {
+    return m_hasHash;
+  }
+
+  /**
+   * @brief Get the hash of the node, which is meaningful only if hasHash()
+   */
+  const Sha256Digest&
   getHash() const
   {
     return m_hash;
@@ -105,16 +121,27 @@ public:
   bool
   isFull() const;
 
-  static ndn::ConstBufferPtr
+  /**
+   * @brief Get the SHA-256 digest of the empty string, which stands for a missing child
+   */
+  static const Sha256Digest&
   getEmptyHash();
 
+  /**
+   * @brief Compute the hash of the node at @p index from the hashes of its children
+   *
+   * The hash is SHA-256 over the level and the seqNo of the node (both as 8-byte integers
+   * in host byte order), followed by @p left and @p right.  Use computeNodeHashes to hash
+   * independent nodes in a batch.
+   */
+  static Sha256Digest
+  computeHash(const Index& index, const Sha256Digest& left, const Sha256Digest& right);
+
 protected:
   Index m_index;
   NonNegativeInteger m_leafSeqNo;
-  ndn::ConstBufferPtr m_hash;
-
-private:
-  static ndn::ConstBufferPtr EMPTY_HASH;
+  bool m_hasHash;
+  Sha256Digest m_hash;
 };
 
 typedef shared_ptr<Node> NodePtr;
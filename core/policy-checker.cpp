@@ -124,6 +124,13 @@ PolicyChecker::onConfigRule(const conf::ConfigSection& section)
 bool
 PolicyChecker::check(const Timestamp& dataTimestamp, const Data& data,
                      const Timestamp& keyTimestamp, const ndn::IdentityCertificate& cert)
+{
+  return checkPolicy(dataTimestamp, data, keyTimestamp, cert) && verifySignature(data, cert);
+}
+
+bool
+PolicyChecker::checkPolicy(const Timestamp& dataTimestamp, const Data& data,
+                           const Timestamp& keyTimestamp, const ndn::IdentityCertificate& cert)
 {
   system_clock::TimePoint dataTs((time::seconds(dataTimestamp)));
   system_clock::TimePoint keyTs((time::seconds(keyTimestamp)));
@@ -147,12 +154,15 @@ PolicyChecker::check(const Timestamp& dataTimestamp, const Data& data,
   if (!keyLocatorName.isPrefixOf(cert.getName()))
     return false;
 
-  if (!ndn::Validator::verifySignature(data, cert.getPublicKeyInfo()))
-    return false;
-
   return true;
 }
 
+bool
+PolicyChecker::verifySignature(const Data& data, const ndn::IdentityCertificate& cert)
+{
+  return ndn::Validator::verifySignature(data, cert.getPublicKeyInfo());
+}
+
 bool
 PolicyChecker::checkRule(const Data& data)
 {
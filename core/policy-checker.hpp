@@ -58,6 +58,22 @@ public:
   bool
   check(const Timestamp& dataTimestamp, const Data& data,
         const Timestamp& keyTimestamp, const ndn::IdentityCertificate& cert);
+
+  /**
+   * @brief Check everything but the signature of @p data
+   *
+   * The rules match with stateful regexes, so this must not run concurrently.
+   */
+  bool
+  checkPolicy(const Timestamp& dataTimestamp, const Data& data,
+              const Timestamp& keyTimestamp, const ndn::IdentityCertificate& cert);
+
+  /**
+   * @brief Verify the signature of @p data with the key of @p cert, which is thread-safe
+   */
+  static bool
+  verifySignature(const Data& data, const ndn::IdentityCertificate& cert);
+
 private:
 
   void
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "response-batch.hpp"
+#include "node.hpp"
+
+namespace ndn {
+namespace delorean {
+
+ResponseBatch::ResponseBatch(const std::vector<Sha256Digest>& leafHashes)
+{
+  if (leafHashes.empty())
+    throw Error("ResponseBatch: no leaf");
+
+  m_levels.push_back(leafHashes);
+  for (size_t level = 1; m_levels.back().size() > 1; level++) {
+    const std::vector<Sha256Digest>& children = m_levels.back();
+    std::vector<Sha256Digest> nodes((children.size() + 1) / 2);
+    for (size_t i = 0; i < nodes.size(); i++) {
+      const Sha256Digest& left = children[2 * i];
+      const Sha256Digest& right = (2 * i + 1 < children.size()) ?
+                                  children[2 * i + 1] : Node::getEmptyHash();
+      nodes[i] = Node::computeHash(Node::Index(i << level, level), left, right);
+    }
+    m_levels.push_back(std::move(nodes));
+  }
+}
+
+std::vector<Sha256Digest>
+ResponseBatch::getPath(size_t index) const
+{
+  if (index >= getNLeaves())
+    throw Error("ResponseBatch: no leaf " + boost::lexical_cast<std::string>(index));
+
+  std::vector<Sha256Digest> path;
+  for (size_t level = 0; level + 1 < m_levels.size(); level++, index >>= 1) {
+    size_t sibling = index ^ 1;
+    path.push_back(sibling < m_levels[level].size() ? m_levels[level][sibling] :
+                                                      Node::getEmptyHash());
+  }
+  return path;
+}
+
+Sha256Digest
+ResponseBatch::computeRootHash(const Sha256Digest& leafHash, uint64_t index,
+                               const std::vector<Sha256Digest>& path)
+{
+  if (path.size() >= 64)
+    throw Error("ResponseBatch: path is too long");
+
+  Sha256Digest hash = leafHash;
+  for (size_t level = 1; level <= path.size(); level++, index >>= 1) {
+    Node::Index nodeIndex((index >> 1) << level, level);
+    if (index & 1)
+      hash = Node::computeHash(nodeIndex, path[level - 1], hash);
+    else
+      hash = Node::computeHash(nodeIndex, hash, path[level - 1]);
+  }
+  return hash;
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_RESPONSE_BATCH_HPP
+#define NDN_DELOREAN_CORE_RESPONSE_BATCH_HPP
+
+#include "common.hpp"
+#include "util/sha256-digest.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A Merkle tree over log responses, whose root is signed once for all of them
+ *
+ * The leaves are the batch leaf hashes of the responses at level 0, and the nodes are hashed
+ * like the nodes of the log tree: Node::computeHash over the index of the node, with the empty
+ * hash standing for a missing child.  The inclusion path of a response is the sibling hash at
+ * each level, from the leaves up to the root.
+ */
+class ResponseBatch
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+public:
+  /**
+   * @brief Build the tree over @p leafHashes
+   *
+   * @throw Error if there is no leaf
+   */
+  explicit
+  ResponseBatch(const std::vector<Sha256Digest>& leafHashes);
+
+  size_t
+  getNLeaves() const
+  {
+    return m_levels.front().size();
+  }
+
+  const Sha256Digest&
+  getRootHash() const
+  {
+    return m_levels.back().front();
+  }
+
+  /**
+   * @brief Get the inclusion path of the leaf at @p index
+   */
+  std::vector<Sha256Digest>
+  getPath(size_t index) const;
+
+  /**
+   * @brief Compute the root hash from a leaf and its inclusion path
+   *
+   * @throw Error if the path is too long to be valid
+   */
+  static Sha256Digest
+  computeRootHash(const Sha256Digest& leafHash, uint64_t index,
+                  const std::vector<Sha256Digest>& path);
+
+private:
+  /// hashes of each level, from the leaves to the root
+  std::vector<std::vector<Sha256Digest>> m_levels;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_RESPONSE_BATCH_HPP
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "signature-verifier.hpp"
+#include "cryptopp.hpp"
+
+namespace ndn {
+namespace delorean {
+
+/// the size of a P1363 signature on the largest curve ndn-cxx signs with, P-384
+static const size_t MAX_ECDSA_SIGNATURE_SIZE = 96;
+
+struct SignatureVerifier::DecodedKey
+{
+  ndn::KeyType type;
+  CryptoPP::RSA::PublicKey rsaKey;
+  CryptoPP::ECDSA<CryptoPP::ECP, CryptoPP::SHA256>::PublicKey ecdsaKey;
+  /// the size of a P1363 signature by ecdsaKey
+  size_t ecdsaSignatureSize;
+};
+
+SignatureVerifier::SignatureVerifier(const ndn::PublicKey& key)
+  : m_key(new DecodedKey)
+{
+  using namespace CryptoPP;
+
+  m_key->type = key.getKeyType();
+  m_key->ecdsaSignatureSize = 0;
+
+  try {
+    ByteQueue queue;
+    queue.Put(reinterpret_cast<const byte*>(key.get().buf()), key.get().size());
+
+    switch (m_key->type) {
+    case ndn::KEY_TYPE_RSA:
+      m_key->rsaKey.Load(queue);
+      break;
+    case ndn::KEY_TYPE_ECDSA: {
+      m_key->ecdsaKey.Load(queue);
+      ECDSA<ECP, SHA256>::Verifier verifier(m_key->ecdsaKey);
+      m_key->ecdsaSignatureSize = verifier.SignatureLength();
+      if (m_key->ecdsaSignatureSize > MAX_ECDSA_SIGNATURE_SIZE)
+        throw Error("Unsupported ECDSA curve");
+      break;
+    }
+    default:
+      throw Error("Unsupported key type");
+    }
+  }
+  catch (const CryptoPP::Exception& e) {
+    throw Error(std::string("Cannot decode the key: ") + e.what());
+  }
+}
+
+SignatureVerifier::~SignatureVerifier()
+{
+}
+
+bool
+SignatureVerifier::verify(const Data& data) const
+{
+  using namespace CryptoPP;
+
+  const Block& sigValue = data.getSignature().getValue();
+  const Block& wire = data.wireEncode();
+  const uint8_t* buf = wire.value();
+  size_t size = wire.value_size() - sigValue.size();
+
+  try {
+    switch (data.getSignature().getType()) {
+    case ndn::tlv::SignatureSha256WithRsa: {
+      if (m_key->type != ndn::KEY_TYPE_RSA)
+        return false;
+
+      RSASS<PKCS1v15, SHA256>::Verifier verifier(m_key->rsaKey);
+      return verifier.VerifyMessage(buf, size, sigValue.value(), sigValue.value_size());
+    }
+    case ndn::tlv::SignatureSha256WithEcdsa: {
+      if (m_key->type != ndn::KEY_TYPE_ECDSA)
+        return false;
+
+      // the curve of a CryptoPP key has scratch state, so it is not shared among threads
+      ECDSA<ECP, SHA256>::Verifier verifier(m_key->ecdsaKey);
+
+      uint8_t buffer[MAX_ECDSA_SIGNATURE_SIZE];
+      size_t usedSize = DSAConvertSignatureFormat(buffer, m_key->ecdsaSignatureSize, DSA_P1363,
+                                                  sigValue.value(), sigValue.value_size(),
+                                                  DSA_DER);
+      return verifier.VerifyMessage(buf, size, buffer, usedSize);
+    }
+    default:
+      return false;
+    }
+  }
+  catch (const CryptoPP::Exception&) {
+    return false;
+  }
+}
+
+} // namespace delorean
+} // namespace ndn
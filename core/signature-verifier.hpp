@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_SIGNATURE_VERIFIER_HPP
+#define NDN_DELOREAN_CORE_SIGNATURE_VERIFIER_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/security/public-key.hpp>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief Verify Data signatures with a public key which is decoded once
+ *
+ * ndn::Validator::verifySignature decodes the DER key for every signature.  A verifier decodes
+ * it when it is created, and each verify only copies the decoded key into a CryptoPP verifier
+ * of its own, so one verifier can be used by several threads at once.
+ */
+class SignatureVerifier : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+public:
+  /**
+   * @throw Error the key is neither an RSA nor an ECDSA key, or cannot be decoded
+   */
+  explicit
+  SignatureVerifier(const ndn::PublicKey& key);
+
+  ~SignatureVerifier();
+
+  /**
+   * @brief Verify the signature of @p data, the same as ndn::Validator::verifySignature
+   */
+  bool
+  verify(const Data& data) const;
+
+private:
+  struct DecodedKey;
+
+  std::unique_ptr<DecodedKey> m_key;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_SIGNATURE_VERIFIER_HPP
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_SIGNER_CACHE_HPP
+#define NDN_DELOREAN_CORE_SIGNER_CACHE_HPP
+
+#include "common.hpp"
+#include "signature-verifier.hpp"
+#include "util/lru-cache.hpp"
+#include "util/non-negative-integer.hpp"
+#include "util/timestamp.hpp"
+
+#include <ndn-cxx/security/identity-certificate.hpp>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief An LRU cache of parsed signer certificates, keyed by the seqNo of their leaf
+ *
+ * A certificate leaf never changes once it is logged, so the certificate is parsed and its
+ * public key is decoded into a SignatureVerifier once for all the Data the signer submits.  The
+ * cache is bounded by the number of signers and is not thread-safe, but the cached signers can
+ * be shared with other threads.
+ */
+class SignerCache : noncopyable
+{
+public:
+  struct Signer
+  {
+    /// nullptr if the logged certificate cannot be parsed
+    shared_ptr<const ndn::IdentityCertificate> cert;
+    /// verifies with the key of cert, nullptr if there is no cert or its key cannot be decoded
+    shared_ptr<const SignatureVerifier> verifier;
+    /// the timestamp of the certificate leaf
+    Timestamp timestamp;
+  };
+
+  /**
+   * @brief Create a cache of at most @p capacity signers, 0 disables the cache
+   */
+  explicit
+  SignerCache(size_t capacity = 0);
+
+  /**
+   * @brief Change the capacity, evicting the least recently used signers if necessary
+   */
+  void
+  setCapacity(size_t capacity)
+  {
+    m_cache.setCapacity(capacity);
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_cache.getCapacity();
+  }
+
+  size_t
+  getNEntries() const
+  {
+    return m_cache.getNEntries();
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_cache.getNHits();
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_cache.getNMisses();
+  }
+
+  /**
+   * @brief Look up a signer and make it the most recently used one
+   *
+   * Lookups are not counted when the cache is disabled.
+   *
+   * @return the signer, or nullptr if it is not cached
+   */
+  shared_ptr<const Signer>
+  find(const NonNegativeInteger& signerSeqNo);
+
+  /**
+   * @brief Insert or replace a signer as the most recently used one
+   */
+  void
+  insert(const NonNegativeInteger& signerSeqNo, const shared_ptr<const Signer>& signer);
+
+private:
+  /// every signer costs 1, so that the capacity bounds the number of signers
+  LruCache<NonNegativeInteger, shared_ptr<const Signer>> m_cache;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_SIGNER_CACHE_HPP
@@ -20,98 +20,155 @@
  */
 
 #include "sub-tree-binary.hpp"
+#include "util/sha256-node-hash.hpp"
 
-#include <ndn-cxx/util/digest.hpp>
 #include <ndn-cxx/util/crypto.hpp>
 #include <ndn-cxx/security/digest-sha256.hpp>
+#include <cstring>
+#include <limits>
 
 namespace ndn {
 namespace delorean {
 
-const time::milliseconds SubTreeBinary::INCOMPLETE_FRESHNESS_PERIOD(60000);
-const std::string SubTreeBinary::COMPONENT_COMPLETE("complete");
-const ssize_t SubTreeBinary::OFFSET_ROOTHASH = -1;
-const ssize_t SubTreeBinary::OFFSET_COMPLETE = -2;
-const ssize_t SubTreeBinary::OFFSET_SEQNO = -3;
-const ssize_t SubTreeBinary::OFFSET_LEVEL = -4;
-const size_t SubTreeBinary::N_LOGGER_SUFFIX = 4;
-const size_t SubTreeBinary::SUB_TREE_DEPTH = 6;
-
-
-SubTreeBinary::SubTreeBinary(const Name& loggerName,
-                             const CompleteCallback& completeCallback,
-                             const RootUpdateCallback& rootUpdateCallback)
+template<size_t DEPTH>
+const time::milliseconds BasicSubTreeBinary<DEPTH>::INCOMPLETE_FRESHNESS_PERIOD(60000);
+template<size_t DEPTH>
+const std::string BasicSubTreeBinary<DEPTH>::COMPONENT_COMPLETE("complete");
+template<size_t DEPTH>
+const ssize_t BasicSubTreeBinary<DEPTH>::OFFSET_ROOTHASH = -1;
+template<size_t DEPTH>
+const ssize_t BasicSubTreeBinary<DEPTH>::OFFSET_COMPLETE = -2;
+template<size_t DEPTH>
+const ssize_t BasicSubTreeBinary<DEPTH>::OFFSET_SEQNO = -3;
+template<size_t DEPTH>
+const ssize_t BasicSubTreeBinary<DEPTH>::OFFSET_LEVEL = -4;
+template<size_t DEPTH>
+const size_t BasicSubTreeBinary<DEPTH>::N_LOGGER_SUFFIX = 4;
+template<size_t DEPTH>
+constexpr size_t BasicSubTreeBinary<DEPTH>::SUB_TREE_DEPTH;
+template<size_t DEPTH>
+constexpr size_t BasicSubTreeBinary<DEPTH>::STEP;
+template<size_t DEPTH>
+constexpr size_t BasicSubTreeBinary<DEPTH>::N_NODES;
+
+
+template<size_t DEPTH>
+BasicSubTreeBinary<DEPTH>::BasicSubTreeBinary(const Name& loggerName,
+                                              const CompleteCallback& completeCallback,
+                                              const RootUpdateCallback& rootUpdateCallback)
   : m_loggerName(loggerName)
   , m_completeCallback(completeCallback)
   , m_rootUpdateCallback(rootUpdateCallback)
+  , m_hasActualRoot(false)
+  , m_nodes()
+  , m_hashes()
+  , m_version(0)
+  , m_encodedVersion(0)
 {
 }
 
-SubTreeBinary::SubTreeBinary(const Name& loggerName,
-                             const Node::Index& peakIndex,
-                             const CompleteCallback& completeCallback,
-                             const RootUpdateCallback& rootUpdateCallback)
+template<size_t DEPTH>
+BasicSubTreeBinary<DEPTH>::BasicSubTreeBinary(const Name& loggerName,
+                                              const Node::Index& peakIndex,
+                                              const CompleteCallback& completeCallback,
+                                              const RootUpdateCallback& rootUpdateCallback)
   : m_loggerName(loggerName)
   , m_completeCallback(completeCallback)
   , m_rootUpdateCallback(rootUpdateCallback)
+  , m_hasActualRoot(false)
+  , m_nodes()
+  , m_hashes()
+  , m_version(0)
+  , m_encodedVersion(0)
 {
   initialize(peakIndex);
 }
 
+template<size_t DEPTH>
 const NonNegativeInteger&
-SubTreeBinary::getNextLeafSeqNo() const
+BasicSubTreeBinary<DEPTH>::getNextLeafSeqNo() const
 {
-  if (m_actualRoot != nullptr)
-    return m_actualRoot->getLeafSeqNo();
+  if (m_hasActualRoot)
+    return m_nodes[toPosition(m_actualRootIndex)].leafSeqNo;
 
   return m_peakIndex.seqNo;
 }
 
-ndn::ConstBufferPtr
-SubTreeBinary::getRootHash() const
+template<size_t DEPTH>
+ConstNodePtr
+BasicSubTreeBinary<DEPTH>::getRoot() const
 {
-  if (m_actualRoot != nullptr)
-    return m_actualRoot->getHash();
+  if (!m_hasActualRoot)
+    return nullptr;
 
-  return nullptr;
+  return getNode(m_actualRootIndex);
 }
 
-ConstNodePtr
-SubTreeBinary::getNode(const Node::Index& index) const
+template<size_t DEPTH>
+const Sha256Digest&
+BasicSubTreeBinary<DEPTH>::getRootHash() const
 {
-  auto it = m_nodes.find(index);
-  if (it != m_nodes.end()) {
-    return it->second;
-  }
+  BOOST_ASSERT(m_hasActualRoot);
+  return m_hashes[toPosition(m_actualRootIndex)];
+}
 
-  return nullptr;
+template<size_t DEPTH>
+ConstNodePtr
+BasicSubTreeBinary<DEPTH>::getNode(const Node::Index& index) const
+{
+  if (!m_hasActualRoot ||
+      index.level < m_leafLevel || index.level > m_peakIndex.level ||
+      index.seqNo < m_minSeqNo || index.seqNo >= m_maxSeqNo)
+    return nullptr;
+
+  size_t position = toPosition(index);
+  const NodeEntry& entry = m_nodes[position];
+  if (!entry.isPresent)
+    return nullptr;
+
+  if (entry.hasHash)
+    return make_shared<Node>(index.seqNo, index.level, entry.leafSeqNo, m_hashes[position]);
+  else
+    return make_shared<Node>(index.seqNo, index.level, entry.leafSeqNo);
 }
 
+template<size_t DEPTH>
 bool
-SubTreeBinary::addLeaf(NodePtr leaf)
+BasicSubTreeBinary<DEPTH>::addLeaf(const Node& leaf)
 {
+  const Node::Index& index = leaf.getIndex();
+  const NonNegativeInteger& leafSeqNo = leaf.getLeafSeqNo();
+
+  if (!leaf.hasHash())
+    return false;
+
   // sanity check: must be a valid leaf
-  if (leaf->getIndex().level != m_leafLevel ||
-      leaf->getIndex().seqNo < m_minSeqNo ||
-      leaf->getIndex().seqNo >= m_maxSeqNo)
+  if (index.level != m_leafLevel ||
+      index.seqNo < m_minSeqNo ||
+      index.seqNo >= m_maxSeqNo)
     return false;
 
   // sanity check: must be the expected next leaf
-  if (leaf->getIndex().seqNo != m_pendingLeafSeqNo ||
+  if (index.seqNo != m_pendingLeafSeqNo ||
       !m_isPendingLeafEmpty)
     return false;
 
+  // bump the version first, the callbacks may encode the subtree
+  m_version++;
+
   // add the leaf
-  m_nodes[leaf->getIndex()] = leaf;
+  NodeEntry& entry = createEntry(index, leafSeqNo);
+  getEntryHash(index) = leaf.getHash();
+  entry.hasHash = true;
 
   // update actual root (guarantee we will have a root)
-  updateActualRoot(leaf);
+  updateActualRoot(index);
 
   // update nodes and their hashes
-  updateParentNode(leaf);
+  updateParentNodes(index);
 
-  if (leaf->isFull()) {
-    m_pendingLeafSeqNo = leaf->getIndex().seqNo + leaf->getIndex().range;
+  if (index.seqNo + index.range == leafSeqNo) {
+    m_pendingLeafSeqNo = leafSeqNo;
     m_isPendingLeafEmpty = true;
   }
   else {
@@ -121,68 +178,127 @@ SubTreeBinary::addLeaf(NodePtr leaf)
   return true;
 }
 
-bool
-SubTreeBinary::updateLeaf(const NonNegativeInteger& nextSeqNo, ndn::ConstBufferPtr hash)
+template<size_t DEPTH>
+size_t
+BasicSubTreeBinary<DEPTH>::addLeaves(const NonNegativeInteger& firstSeqNo,
+                                     const Sha256Digest* hashes, size_t nHashes)
 {
-  // std::cerr << "NextSeqNo: " << nextSeqNo << std::endl;
-  // std::cerr << "minSeqNo: " << m_minSeqNo << std::endl;
-  // std::cerr << "maxSeqNo: " << m_maxSeqNo << std::endl;
+  static_assert(sizeof(Sha256Digest) == 32, "Sha256Digest must be packed");
+  return addLeafHashes(firstSeqNo, reinterpret_cast<const uint8_t*>(hashes), nHashes);
+}
 
+template<size_t DEPTH>
+size_t
+BasicSubTreeBinary<DEPTH>::addLeafHashes(const NonNegativeInteger& firstSeqNo,
+                                         const uint8_t* hashes, size_t nHashes)
+{
+  // sanity check: must start from the expected next leaf
+  if (nHashes == 0 ||
+      firstSeqNo != m_pendingLeafSeqNo ||
+      !m_isPendingLeafEmpty ||
+      firstSeqNo >= m_maxSeqNo)
+    return 0;
+
+  NonNegativeInteger seqNoInterval = static_cast<NonNegativeInteger>(1) << m_leafLevel;
+  size_t nLeaves = std::min<NonNegativeInteger>(nHashes,
+                                                (m_maxSeqNo - firstSeqNo) >> m_leafLevel);
+
+  m_version++;
+
+  // the leaves are adjacent in the leaf row
+  std::memcpy(&getEntryHash(Node::Index(firstSeqNo, m_leafLevel)), hashes, nLeaves * 32);
+
+  // add the leaves, parents are hashed after all leaves are in place
+  NonNegativeInteger seqNo = firstSeqNo;
+  for (size_t i = 0; i < nLeaves; i++, seqNo += seqNoInterval) {
+    Node::Index index(seqNo, m_leafLevel);
+    NodeEntry& entry = createEntry(index, seqNo + seqNoInterval);
+    entry.hasHash = true;
+
+    updateActualRoot(index, false);
+  }
+
+  m_pendingLeafSeqNo = seqNo;
+  m_isPendingLeafEmpty = true;
+
+  Node::Index firstIndex(firstSeqNo, m_leafLevel);
+  if (firstIndex == m_actualRootIndex) {
+    // a single leaf which is the actual root, there is no parent to update
+    const NodeEntry& root = getEntry(firstIndex);
+    m_rootUpdateCallback(firstIndex, root.leafSeqNo, getEntryHash(firstIndex));
+  }
+  else
+    updateParentNodes(firstIndex, nLeaves);
+
+  return nLeaves;
+}
+
+template<size_t DEPTH>
+bool
+BasicSubTreeBinary<DEPTH>::updateLeaf(const NonNegativeInteger& nextSeqNo, const Sha256Digest& hash)
+{
   // sanity check
   if (nextSeqNo < m_minSeqNo || nextSeqNo > m_maxSeqNo)
     return false;
 
-  // std::cerr << "2" << std::endl;
   // determine leaf index
   NonNegativeInteger leafSeqNo = ((nextSeqNo - 1) >> m_leafLevel) << m_leafLevel;
   if (m_pendingLeafSeqNo != leafSeqNo)
     return false;
 
+  m_version++;
+
   Node::Index index(leafSeqNo, m_leafLevel);
-  auto leaf = m_nodes[index];
+  NodeEntry& leaf = getEntry(index);
 
-  if (leaf == nullptr) {
-    leaf = make_shared<Node>(leafSeqNo, m_leafLevel, nextSeqNo, hash);
-    m_nodes[index] = leaf;
-    updateActualRoot(leaf);
+  if (!leaf.isPresent) {
+    createEntry(index, nextSeqNo);
+    getEntryHash(index) = hash;
+    leaf.hasHash = true;
+    updateActualRoot(index);
   }
   else {
-    leaf->setLeafSeqNo(nextSeqNo);
-    leaf->setHash(hash);
+    leaf.leafSeqNo = nextSeqNo;
+    getEntryHash(index) = hash;
   }
 
-  if (nextSeqNo == leafSeqNo + (1 << m_leafLevel)) {
+  if (nextSeqNo == leafSeqNo + (static_cast<NonNegativeInteger>(1) << m_leafLevel)) {
     m_pendingLeafSeqNo = nextSeqNo;
     m_isPendingLeafEmpty = true;
   }
 
-  updateParentNode(leaf);
+  updateParentNodes(index);
 
   return true;
 }
 
+template<size_t DEPTH>
 bool
-SubTreeBinary::isFull() const
+BasicSubTreeBinary<DEPTH>::isFull() const
 {
-  if (m_actualRoot != nullptr &&
-      m_actualRoot->getIndex() == m_peakIndex &&
-      m_actualRoot->isFull())
+  if (m_hasActualRoot &&
+      m_actualRootIndex == m_peakIndex &&
+      m_nodes[toPosition(m_actualRootIndex)].leafSeqNo == m_maxSeqNo)
     return true;
 
   return false;
 }
 
+template<size_t DEPTH>
 shared_ptr<Data>
-SubTreeBinary::encode() const
+BasicSubTreeBinary<DEPTH>::encode() const
 {
-  if (m_actualRoot == nullptr) {
+  if (m_encodedData != nullptr && m_encodedVersion == m_version)
+    return m_encodedData;
+
+  if (!m_hasActualRoot) {
     auto emptyData = make_shared<Data>();
     // Name
     Name emptyName = m_loggerName;
     emptyName.appendNumber(m_peakIndex.level)
       .appendNumber(m_peakIndex.seqNo)
       .appendNumber(m_peakIndex.seqNo)
-      .append(Node::getEmptyHash()->buf(), Node::getEmptyHash()->size());
+      .append(Node::getEmptyHash().data(), Node::getEmptyHash().size());
     emptyData->setName(emptyName);
 
     // MetaInfo
@@ -200,18 +316,24 @@ SubTreeBinary::encode() const
 
     emptyData->wireEncode();
 
+    m_encodedData = emptyData;
+    m_encodedVersion = m_version;
     return emptyData;
   }
 
+  const NodeEntry& root = m_nodes[toPosition(m_actualRootIndex)];
+  const Sha256Digest& rootHash = m_hashes[toPosition(m_actualRootIndex)];
+  BOOST_ASSERT(root.hasHash);
+
   // Name
   Name dataName = m_loggerName;
-  dataName.appendNumber(m_actualRoot->getIndex().level)
-    .appendNumber(m_actualRoot->getIndex().seqNo);
+  dataName.appendNumber(m_actualRootIndex.level)
+    .appendNumber(m_actualRootIndex.seqNo);
   if (isFull())
     dataName.append(COMPONENT_COMPLETE.c_str());
   else
-    dataName.appendNumber(m_actualRoot->getLeafSeqNo());
-  dataName.append(m_actualRoot->getHash()->buf(), m_actualRoot->getHash()->size());
+    dataName.appendNumber(root.leafSeqNo);
+  dataName.append(rootHash.data(), rootHash.size());
 
   auto data = make_shared<Data>(dataName);
 
@@ -219,22 +341,9 @@ SubTreeBinary::encode() const
   if (!isFull())
     data->setFreshnessPeriod(INCOMPLETE_FRESHNESS_PERIOD);
 
-  // Content
-  auto buffer = make_shared<ndn::Buffer>();
-  NonNegativeInteger range = 1 << m_leafLevel;
-  for (NonNegativeInteger i = m_minSeqNo; i < m_maxSeqNo; i += range) {
-    auto it = m_nodes.find(Node::Index(i, m_leafLevel));
-    if (it == m_nodes.end())
-      break;
-
-    auto leaf = it->second;
-    if (leaf == nullptr)
-      break;
-    BOOST_ASSERT(leaf->getHash() != nullptr);
-    BOOST_ASSERT(leaf->getHash()->size() == 32);
-    buffer->insert(buffer->end(), leaf->getHash()->begin(), leaf->getHash()->end());
-  }
-  data->setContent(buffer->buf(), buffer->size());
+  // Content: the hashes of the leaf row, which is the contiguous tail of m_hashes
+  size_t nLeaves = ((root.leafSeqNo - m_minSeqNo - 1) >> m_leafLevel) + 1;
+  data->setContent(reinterpret_cast<const uint8_t*>(&m_hashes[N_NODES / 2]), nLeaves * 32);
 
   // Signature
   ndn::DigestSha256 sig;
@@ -247,15 +356,20 @@ SubTreeBinary::encode() const
   data->setSignatureValue(sigValue);
 
   data->wireEncode();
+
+  m_encodedData = data;
+  m_encodedVersion = m_version;
   return data;
 }
 
+template<size_t DEPTH>
 void
-SubTreeBinary::decode(const Data& data)
+BasicSubTreeBinary<DEPTH>::decode(const Data& data)
 {
   bool isComplete = false;
   NonNegativeInteger nextSeqNo;
-  ndn::ConstBufferPtr rootHash;
+  Sha256Digest rootHash;
+  bool hasValidRootHash = false;
   NonNegativeInteger seqNo;
   size_t level;
 
@@ -273,8 +387,9 @@ SubTreeBinary::decode(const Data& data)
     else
       nextSeqNo = dataName.get(OFFSET_COMPLETE).toNumber();
 
-    rootHash = make_shared<ndn::Buffer>(dataName.get(OFFSET_ROOTHASH).value(),
-                                        dataName.get(OFFSET_ROOTHASH).value_size());
+    hasValidRootHash = toSha256Digest(dataName.get(OFFSET_ROOTHASH).value(),
+                                      dataName.get(OFFSET_ROOTHASH).value_size(),
+                                      rootHash);
 
     seqNo = dataName.get(OFFSET_SEQNO).toNumber();
     level = dataName.get(OFFSET_LEVEL).toNumber();
@@ -283,15 +398,16 @@ SubTreeBinary::decode(const Data& data)
     throw Error("decode: logger name encoding error");
   }
 
+  // the subtree and its peak must fit in the range of seqNos
+  if (level >= std::numeric_limits<NonNegativeInteger>::digits - STEP)
+    throw Error("decode: level out of range");
+
   if (seqNo == 0) {
-    size_t peakLevel = 0;
-    if (level % (SUB_TREE_DEPTH - 1) != 0)
-      peakLevel = ((level + SUB_TREE_DEPTH - 1) / (SUB_TREE_DEPTH - 1)) * (SUB_TREE_DEPTH - 1);
-    else
-      peakLevel = level;
+    // round the level up to a multiple of STEP, a compile-time constant
+    size_t peakLevel = ((level + STEP - 1) / STEP) * STEP;
 
-    if (nextSeqNo == 1 << peakLevel)
-      peakLevel = peakLevel + SUB_TREE_DEPTH - 1;
+    if (nextSeqNo == static_cast<NonNegativeInteger>(1) << peakLevel)
+      peakLevel = peakLevel + STEP;
 
     initialize(Node::Index(seqNo, peakLevel));
   }
@@ -299,17 +415,17 @@ SubTreeBinary::decode(const Data& data)
     initialize(Node::Index(seqNo, level));
 
   if (isComplete)
-    nextSeqNo = seqNo + (1 << level);
+    nextSeqNo = seqNo + (static_cast<NonNegativeInteger>(1) << level);
   else if (nextSeqNo == seqNo) // empty tree
     return;
 
-  if (rootHash->size() != 32)
+  if (!hasValidRootHash)
     throw Error("decode: wrong root hash size");
 
-  if (nextSeqNo <= seqNo || nextSeqNo > seqNo + (1 << level))
+  if (nextSeqNo <= seqNo || nextSeqNo > seqNo + (static_cast<NonNegativeInteger>(1) << level))
     throw Error("decode: wrong current leaf SeqNo");
 
-  int nLeaves = (nextSeqNo - seqNo - 1) / (1 << m_leafLevel) + 1;
+  size_t nLeaves = ((nextSeqNo - seqNo - 1) >> m_leafLevel) + 1;
 
   // std::cerr << data.getName() << std::endl;
   // std::cerr << nextSeqNo << std::endl;
@@ -319,155 +435,169 @@ SubTreeBinary::decode(const Data& data)
   if (nLeaves * 32 != data.getContent().value_size())
     throw Error("decode: inconsistent content");
 
-  const uint8_t* offset = data.getContent().value();
-  NonNegativeInteger seqNoInterval = 1 << m_leafLevel;
-  int i = 0;
-  for (; i < nLeaves - 1; i++) {
-    auto node = make_shared<Node>(seqNo + (i * seqNoInterval),
-                                  m_peakIndex.level + 1 - SUB_TREE_DEPTH,
-                                  seqNo + (i * seqNoInterval) + seqNoInterval,
-                                  make_shared<ndn::Buffer>(offset + (i * 32), 32));
-    addLeaf(node);
-  }
+  // all leaves but the last one are complete, so they are copied from the content in one batch
+  const uint8_t* leafHashes = data.getContent().value();
+  if (nLeaves > 1)
+    addLeafHashes(seqNo, leafHashes, nLeaves - 1);
 
-  auto node = make_shared<Node>(seqNo + (i * seqNoInterval),
-                                m_peakIndex.level + 1 - SUB_TREE_DEPTH,
-                                nextSeqNo,
-                                make_shared<ndn::Buffer>(offset + (i * 32), 32));
-  addLeaf(node);
+  Sha256Digest lastLeafHash;
+  toSha256Digest(leafHashes + (nLeaves - 1) * 32, 32, lastLeafHash);
+  NonNegativeInteger lastSeqNo =
+    seqNo + (static_cast<NonNegativeInteger>(nLeaves - 1) << m_leafLevel);
+  addLeaf(Node(lastSeqNo, m_leafLevel, nextSeqNo, lastLeafHash));
 
-  if (*rootHash != *getRoot()->getHash())
+  if (rootHash != getRootHash())
     throw Error("decode: Inconsistent hash");
 }
 
+template<size_t DEPTH>
 Node::Index
-SubTreeBinary::toSubTreePeakIndex(const Node::Index& index, bool notRoot)
+BasicSubTreeBinary<DEPTH>::toSubTreePeakIndex(const Node::Index& index, bool notRoot)
 {
-  size_t peakLevel =
-    ((index.level + SUB_TREE_DEPTH - 1) / (SUB_TREE_DEPTH - 1)) * (SUB_TREE_DEPTH - 1);
-
-  size_t leafLevel = peakLevel + 1 - SUB_TREE_DEPTH;
+  size_t peakLevel = ((index.level + STEP) / STEP) * STEP;
 
-  if (index.level % (SUB_TREE_DEPTH - 1) == 0 && index.level > 0 && !notRoot) {
-    peakLevel -= (SUB_TREE_DEPTH - 1);
-    leafLevel -= (SUB_TREE_DEPTH - 1);
-  }
+  if (index.level % STEP == 0 && index.level > 0 && !notRoot)
+    peakLevel -= STEP;
 
   NonNegativeInteger peakSeqNo = (index.seqNo >> peakLevel) << peakLevel;
 
   return Node::Index(peakSeqNo, peakLevel);
 }
 
+template<size_t DEPTH>
 void
-SubTreeBinary::initialize(const Node::Index& peakIndex)
+BasicSubTreeBinary<DEPTH>::initialize(const Node::Index& peakIndex)
 {
   m_peakIndex = peakIndex;
 
-  if (peakIndex.level + 1 < SUB_TREE_DEPTH ||
-      peakIndex.level % (SUB_TREE_DEPTH - 1) != 0)
+  if (peakIndex.level < STEP || peakIndex.level % STEP != 0)
     throw Error("SubTreeBinary: peak level does not match the depth");
 
-  m_leafLevel = peakIndex.level + 1 - SUB_TREE_DEPTH;
+  m_leafLevel = peakIndex.level - STEP;
 
   m_minSeqNo = peakIndex.seqNo;
   m_maxSeqNo = peakIndex.seqNo + peakIndex.range;
 
   m_pendingLeafSeqNo = m_minSeqNo;
   m_isPendingLeafEmpty = true;
+
+  m_hasActualRoot = false;
+  for (auto& entry : m_nodes)
+    entry.isPresent = false;
+
+  m_version++;
 }
 
 
 
+template<size_t DEPTH>
+typename BasicSubTreeBinary<DEPTH>::NodeEntry&
+BasicSubTreeBinary<DEPTH>::createEntry(const Node::Index& index, const NonNegativeInteger& leafSeqNo)
+{
+  NodeEntry& entry = getEntry(index);
+  entry.leafSeqNo = leafSeqNo;
+  entry.isPresent = true;
+  entry.hasHash = false;
+  return entry;
+}
+
+template<size_t DEPTH>
 void
-SubTreeBinary::updateActualRoot(NodePtr node)
+BasicSubTreeBinary<DEPTH>::updateActualRoot(const Node::Index& index, bool shouldNotify)
 {
-  if (m_actualRoot == nullptr) {
+  if (!m_hasActualRoot) {
+    m_hasActualRoot = true;
     // if actual root is not set yet
-    if (node->getIndex().seqNo == 0) { // root sub-tree
-      m_actualRoot = node;
-      m_rootUpdateCallback(node->getIndex(), node->getLeafSeqNo(), node->getHash());
+    if (index.seqNo == 0) { // root sub-tree
+      m_actualRootIndex = index;
+      if (shouldNotify) {
+        const NodeEntry& root = getEntry(index);
+        m_rootUpdateCallback(index, root.leafSeqNo, getEntryHash(index));
+      }
       return;
     }
     else {
-      m_actualRoot = make_shared<Node>(m_peakIndex.seqNo, m_peakIndex.level);
-      m_nodes[m_actualRoot->getIndex()] = m_actualRoot;
+      m_actualRootIndex = m_peakIndex;
+      createEntry(m_peakIndex, m_peakIndex.seqNo);
       return;
     }
   }
 
-  if (m_actualRoot->getIndex() == m_peakIndex)
+  if (m_actualRootIndex == m_peakIndex)
     return;
 
-  if ((node->getIndex().seqNo >> m_actualRoot->getIndex().level) != 0) {
+  if ((index.seqNo >> m_actualRootIndex.level) != 0) {
     // a new actual root at a higher is needed
-    m_actualRoot = make_shared<Node>(m_minSeqNo, m_actualRoot->getIndex().level + 1);
-    m_nodes[m_actualRoot->getIndex()] = m_actualRoot;
+    m_actualRootIndex = Node::Index(m_minSeqNo, m_actualRootIndex.level + 1);
+    createEntry(m_actualRootIndex, m_minSeqNo);
     return;
   }
 }
 
+template<size_t DEPTH>
 void
-SubTreeBinary::updateParentNode(NodePtr node)
+BasicSubTreeBinary<DEPTH>::updateParentNodes(const Node::Index& index, size_t nNodes)
 {
-  if (node->getIndex() == m_actualRoot->getIndex()) { // root does not have a parent
+  if (index == m_actualRootIndex) // root does not have a parent
     return;
-  }
 
-  size_t parentLevel = node->getIndex().level + 1;
-  NodePtr parentNode;
-
-  if ((node->getIndex().seqNo >> node->getIndex().level) % 2 == 0) { // left child
-    // parent may not exist
-    Node::Index parentIndex(node->getIndex().seqNo, parentLevel);
-    parentNode = m_nodes[parentIndex];
-
-    ndn::util::Sha256 sha256;
-    sha256 << parentIndex.level << parentIndex.seqNo;
-    sha256.update(node->getHash()->buf(), node->getHash()->size());
-    sha256.update(Node::getEmptyHash()->buf(), Node::getEmptyHash()->size());
-
-    if (parentNode == nullptr) {
-      parentNode = make_shared<Node>(node->getIndex().seqNo,
-                                     parentLevel,
-                                     node->getLeafSeqNo(),
-                                     sha256.computeDigest());
+  // the changed nodes of the current level are [firstSeqNo, lastSeqNo], the parents of a
+  // level do not depend on each other, so they are hashed in one batch
+  std::array<Sha256NodeHashJob, (N_NODES + 1) / 4> jobs;
+  size_t level = index.level;
+  NonNegativeInteger firstSeqNo = index.seqNo;
+  NonNegativeInteger lastSeqNo = index.seqNo + ((nNodes - 1) << level);
+  do {
+    size_t parentLevel = level + 1;
+    NonNegativeInteger parentInterval = static_cast<NonNegativeInteger>(1) << parentLevel;
+    firstSeqNo = (firstSeqNo >> parentLevel) << parentLevel;
+    lastSeqNo = (lastSeqNo >> parentLevel) << parentLevel;
+
+    size_t nJobs = 0;
+    for (NonNegativeInteger seqNo = firstSeqNo; seqNo <= lastSeqNo; seqNo += parentInterval) {
+      Node::Index parentIndex(seqNo, parentLevel);
+      Node::Index leftIndex(seqNo, level);
+      Node::Index rightIndex(seqNo + (parentInterval >> 1), level);
+      NodeEntry& parent = getEntry(parentIndex);
+
+      // left child must exist, right child may not exist
+      const NodeEntry& left = getEntry(leftIndex);
+      const NodeEntry& right = getEntry(rightIndex);
+      BOOST_ASSERT(left.hasHash);
+
+      Sha256NodeHashJob& job = jobs[nJobs++];
+      job.level = parentLevel;
+      job.seqNo = seqNo;
+      job.left = &getEntryHash(leftIndex);
+      job.result = &getEntryHash(parentIndex);
+
+      if (right.isPresent) {
+        BOOST_ASSERT(right.hasHash);
+        job.right = &getEntryHash(rightIndex);
+        parent.leafSeqNo = right.leafSeqNo;
+      }
+      else {
+        job.right = &Node::getEmptyHash();
+        parent.leafSeqNo = left.leafSeqNo;
+      }
+      parent.isPresent = true;
+      parent.hasHash = true;
     }
-    else {
-      parentNode->setHash(sha256.computeDigest());
-      parentNode->setLeafSeqNo(node->getLeafSeqNo());
-    }
-
-    m_nodes[parentNode->getIndex()] = parentNode;
-  }
-  else { // right child
-    // parent must exist
-    NonNegativeInteger parentSeqNo = node->getIndex().seqNo - node->getIndex().range;
+    computeNodeHashes(jobs.data(), nJobs);
 
-    Node::Index parentIndex(parentSeqNo, parentLevel);
-    Node::Index siblingIndex(parentSeqNo, parentLevel - 1);
+    level = parentLevel;
+  } while (level < m_actualRootIndex.level);
 
-    parentNode = m_nodes[parentIndex];
-    auto siblingNode = m_nodes[siblingIndex];
-
-    ndn::util::Sha256 sha256;
-    sha256 << parentNode->getIndex().level << parentNode->getIndex().seqNo;
-    sha256.update(siblingNode->getHash()->buf(), siblingNode->getHash()->size());
-    sha256.update(node->getHash()->buf(), node->getHash()->size());
-
-    parentNode->setHash(sha256.computeDigest());
-    parentNode->setLeafSeqNo(node->getLeafSeqNo());
-  }
-
-  if (parentNode->getIndex() == m_actualRoot->getIndex()) { // reach root
-    m_rootUpdateCallback(parentNode->getIndex(),
-                         parentNode->getLeafSeqNo(),
-                         parentNode->getHash());
-    if (parentNode->getIndex() == m_peakIndex && parentNode->isFull())
-      m_completeCallback(parentNode->getIndex());
-  }
-  else
-    updateParentNode(parentNode);
+  // reach root
+  const NodeEntry& root = getEntry(m_actualRootIndex);
+  m_rootUpdateCallback(m_actualRootIndex, root.leafSeqNo, getEntryHash(m_actualRootIndex));
+  if (m_actualRootIndex == m_peakIndex && root.leafSeqNo == m_maxSeqNo)
+    m_completeCallback(m_actualRootIndex);
 }
 
+template class BasicSubTreeBinary<6>;
+template class BasicSubTreeBinary<8>;
+template class BasicSubTreeBinary<10>;
+
 } // namespace delorean
 } // namespace ndn
@@ -24,16 +24,33 @@
 
 #include "node.hpp"
 
+#include <array>
+
+#ifndef NDN_DELOREAN_SUB_TREE_DEPTH
+#define NDN_DELOREAN_SUB_TREE_DEPTH 6
+#endif
+
 namespace ndn {
 namespace delorean {
 
 typedef std::function<void(const Node::Index&)> CompleteCallback;
 typedef std::function<void(const Node::Index&,
                            const NonNegativeInteger&,
-                           ndn::ConstBufferPtr)> RootUpdateCallback;
+                           const Sha256Digest&)> RootUpdateCallback;
 
-class SubTreeBinary
+/**
+ * @brief A subtree of the log tree, spanning DEPTH levels
+ *
+ * Subtrees overlap by one level: the peak of a subtree is a leaf of its parent subtree, so a
+ * subtree covers (DEPTH - 1) levels of the log tree and 2^(DEPTH - 1) leaves.  The depth is a
+ * compile-time parameter, so that the level and position arithmetic folds into constants.
+ * Only the depths instantiated in sub-tree-binary.cpp are available.
+ */
+template<size_t DEPTH>
+class BasicSubTreeBinary
 {
+  static_assert(DEPTH >= 2, "a subtree has at least a peak and a row of leaves");
+
 public:
   class Error : public std::runtime_error
   {
@@ -55,9 +72,9 @@ public:
    * @param completeCallback Callback when the subtree is complete
    * @param rootUpdateCallback Callback when the subtree root is updated
    */
-  SubTreeBinary(const Name& loggerName,
-                const CompleteCallback& completeCallback,
-                const RootUpdateCallback& rootUpdateCallback);
+  BasicSubTreeBinary(const Name& loggerName,
+                     const CompleteCallback& completeCallback,
+                     const RootUpdateCallback& rootUpdateCallback);
   /**
    * @brief Constructor
    *
@@ -68,10 +85,10 @@ public:
    * @param completeCallback Callback when the subtree is complete
    * @param rootUpdateCallback Callback when the subtree root is updated
    */
-  SubTreeBinary(const Name& loggerName,
-                const Node::Index& rootIndex,
-                const CompleteCallback& completeCallback,
-                const RootUpdateCallback& rootUpdateCallback);
+  BasicSubTreeBinary(const Name& loggerName,
+                     const Node::Index& rootIndex,
+                     const CompleteCallback& completeCallback,
+                     const RootUpdateCallback& rootUpdateCallback);
 
   const Node::Index&
   getPeakIndex() const
@@ -103,29 +120,68 @@ public:
   /**
    * @brief get the root of the subtree
    *
-   * @return pointer to the root, nullptr if no leaf added
+   * @return a copy of the root, nullptr if no leaf added
    */
   ConstNodePtr
-  getRoot() const
-  {
-    return m_actualRoot;
-  }
+  getRoot() const;
 
-  ndn::ConstBufferPtr
+  /**
+   * @brief get the hash of the subtree root
+   *
+   * @pre getRoot() != nullptr
+   */
+  const Sha256Digest&
   getRootHash() const;
 
+  /**
+   * @brief get a node of the subtree
+   *
+   * @return a copy of the node, nullptr if the node does not exist
+   */
   ConstNodePtr
   getNode(const Node::Index& index) const;
 
   bool
-  addLeaf(NodePtr leaf);
+  addLeaf(const Node& leaf);
 
   bool
-  updateLeaf(const NonNegativeInteger& nextSeqNo, ndn::ConstBufferPtr hash);
+  addLeaf(NodePtr leaf)
+  {
+    return addLeaf(*leaf);
+  }
+
+  /**
+   * @brief Add complete leaves in a batch, starting from the leaf at @p firstSeqNo
+   *
+   * Leaves are added until either @p nHashes leaves are added or the subtree is full.  Each
+   * node above the new leaves is hashed once, and the callbacks are invoked once at the end.
+   *
+   * @return the number of leaves added, 0 if @p firstSeqNo is not the expected next leaf
+   */
+  size_t
+  addLeaves(const NonNegativeInteger& firstSeqNo, const Sha256Digest* hashes, size_t nHashes);
+
+  bool
+  updateLeaf(const NonNegativeInteger& nextSeqNo, const Sha256Digest& hash);
 
   bool
   isFull() const;
 
+  /**
+   * @brief Get the version of the subtree, which changes whenever a leaf is added or updated
+   */
+  uint64_t
+  getVersion() const
+  {
+    return m_version;
+  }
+
+  /**
+   * @brief Encode the subtree into Data
+   *
+   * The Data is kept until the subtree changes, so encoding an unchanged subtree again does
+   * not hash anything.  The returned Data is shared and must not be modified.
+   */
   shared_ptr<Data>
   encode() const;
 
@@ -137,17 +193,82 @@ public:
   toSubTreePeakIndex(const Node::Index& index, bool notRoot = true);
 
 private:
+  /**
+   * @brief A node stored in place, its hash is kept apart in m_hashes at the same position
+   */
+  struct NodeEntry
+  {
+    NonNegativeInteger leafSeqNo;
+    bool isPresent;
+    bool hasHash;
+  };
+
   void
   initialize(const Node::Index& peakIndex);
 
+  /**
+   * @brief Get the position of a node in m_nodes
+   *
+   * The nodes are laid out in breadth-first order: the node at depth d below the peak and
+   * offset o within its row is at (2^d - 1 + o), so the leaves form the last, contiguous row.
+   */
+  size_t
+  toPosition(const Node::Index& index) const
+  {
+    size_t depth = m_peakIndex.level - index.level;
+    return (static_cast<size_t>(1) << depth) - 1 + ((index.seqNo - m_minSeqNo) >> index.level);
+  }
+
+  NodeEntry&
+  getEntry(const Node::Index& index)
+  {
+    return m_nodes[toPosition(index)];
+  }
+
+  Sha256Digest&
+  getEntryHash(const Node::Index& index)
+  {
+    return m_hashes[toPosition(index)];
+  }
+
+  /**
+   * @brief Add @p nLeaves complete leaves whose hashes are packed in @p hashes, 32 bytes each
+   *
+   * The hashes are copied in one go into the leaf row of m_hashes.
+   *
+   * @return the number of leaves added, see addLeaves
+   */
+  size_t
+  addLeafHashes(const NonNegativeInteger& firstSeqNo, const uint8_t* hashes, size_t nLeaves);
+
+  /**
+   * @brief Create an empty node at @p index, replacing the existing one if any
+   */
+  NodeEntry&
+  createEntry(const Node::Index& index, const NonNegativeInteger& leafSeqNo);
+
+  /**
+   * @brief Raise the actual root to cover the new leaf at @p index
+   *
+   * When the first leaf of the root subtree becomes the actual root, the root update callback
+   * is invoked unless @p shouldNotify is false.
+   */
   void
-  updateActualRoot(NodePtr node);
+  updateActualRoot(const Node::Index& index, bool shouldNotify = true);
 
+  /**
+   * @brief Re-hash the ancestors of @p nNodes adjacent nodes, starting from @p index
+   *
+   * Nodes are hashed level by level, so that each ancestor is hashed only once.
+   */
   void
-  updateParentNode(NodePtr node);
+  updateParentNodes(const Node::Index& index, size_t nNodes = 1);
 
 public:
-  static const size_t SUB_TREE_DEPTH;
+  static constexpr size_t SUB_TREE_DEPTH = DEPTH;
+  /// the number of log tree levels between the peak and the leaves of a subtree
+  static constexpr size_t STEP = DEPTH - 1;
+  static constexpr size_t N_NODES = (1 << SUB_TREE_DEPTH) - 1;
 
 NDN_DELOREAN_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   static const time::milliseconds INCOMPLETE_FRESHNESS_PERIOD;
@@ -168,13 +289,28 @@ private:
   CompleteCallback m_completeCallback;
   RootUpdateCallback m_rootUpdateCallback;
 
-  NodePtr m_actualRoot;
+  bool m_hasActualRoot;
+  Node::Index m_actualRootIndex;
   bool m_isPendingLeafEmpty;
   NonNegativeInteger m_pendingLeafSeqNo;
 
-  std::map<Node::Index, NodePtr> m_nodes;
+  std::array<NodeEntry, N_NODES> m_nodes;
+  /// the leaf row is the contiguous tail, which is the content of the encoded subtree as is
+  std::array<Sha256Digest, N_NODES> m_hashes;
+
+  uint64_t m_version;
+  mutable uint64_t m_encodedVersion;
+  mutable shared_ptr<Data> m_encodedData;
 };
 
+/**
+ * @brief The subtree used by the log, its depth is chosen when configuring the build
+ *
+ * The depth determines the names and the content of the subtree Data, so it cannot change for
+ * an existing log.
+ */
+typedef BasicSubTreeBinary<NDN_DELOREAN_SUB_TREE_DEPTH> SubTreeBinary;
+
 typedef shared_ptr<SubTreeBinary> SubTreeBinaryPtr;
 typedef shared_ptr<const SubTreeBinary> ConstSubTreeBinaryPtr;
 
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sub-tree-cache.hpp"
+
+namespace ndn {
+namespace delorean {
+
+SubTreeCache::SubTreeCache(size_t capacity)
+  : m_cache(capacity)
+{
+}
+
+void
+SubTreeCache::setCapacity(size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cache.setCapacity(capacity);
+}
+
+size_t
+SubTreeCache::getCapacity() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.getCapacity();
+}
+
+size_t
+SubTreeCache::getSize() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.getSize();
+}
+
+size_t
+SubTreeCache::getNEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.getNEntries();
+}
+
+uint64_t
+SubTreeCache::getNHits() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.getNHits();
+}
+
+uint64_t
+SubTreeCache::getNMisses() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.getNMisses();
+}
+
+shared_ptr<Data>
+SubTreeCache::find(size_t level, const NonNegativeInteger& seqNo)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cache.find(Key(level, seqNo));
+}
+
+void
+SubTreeCache::insert(size_t level, const NonNegativeInteger& seqNo,
+                     const shared_ptr<Data>& data)
+{
+  size_t size = data->wireEncode().size();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cache.insert(Key(level, seqNo), data, size);
+}
+
+void
+SubTreeCache::erase(size_t level, const NonNegativeInteger& seqNo)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cache.erase(Key(level, seqNo));
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_SUB_TREE_CACHE_HPP
+#define NDN_DELOREAN_CORE_SUB_TREE_CACHE_HPP
+
+#include "common.hpp"
+#include "util/lru-cache.hpp"
+#include "util/non-negative-integer.hpp"
+
+#include <mutex>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A byte-budgeted LRU cache of complete subtree Data, keyed by (level, seqNo)
+ *
+ * A complete subtree never changes once it is written, so its Data can be kept in memory and
+ * handed out to every lookup instead of being read and parsed again.  The size of an entry is
+ * the size of its wire encoding.  The cache is thread-safe.
+ */
+class SubTreeCache : noncopyable
+{
+public:
+  /**
+   * @brief Create a cache of at most @p capacity bytes, 0 disables the cache
+   */
+  explicit
+  SubTreeCache(size_t capacity = 0);
+
+  /**
+   * @brief Change the capacity, evicting the least recently used entries if necessary
+   */
+  void
+  setCapacity(size_t capacity);
+
+  size_t
+  getCapacity() const;
+
+  /**
+   * @brief Get the number of bytes held by the cache
+   */
+  size_t
+  getSize() const;
+
+  size_t
+  getNEntries() const;
+
+  uint64_t
+  getNHits() const;
+
+  uint64_t
+  getNMisses() const;
+
+  /**
+   * @brief Look up a subtree and make it the most recently used entry
+   *
+   * The returned Data is shared with the cache and must not be modified.  Lookups are not
+   * counted when the cache is disabled.
+   *
+   * @return the Data, or nullptr if it is not cached
+   */
+  shared_ptr<Data>
+  find(size_t level, const NonNegativeInteger& seqNo);
+
+  /**
+   * @brief Insert or replace a subtree as the most recently used entry
+   *
+   * A Data larger than the capacity is not cached.
+   */
+  void
+  insert(size_t level, const NonNegativeInteger& seqNo, const shared_ptr<Data>& data);
+
+  void
+  erase(size_t level, const NonNegativeInteger& seqNo);
+
+private:
+  typedef std::pair<size_t, NonNegativeInteger> Key;
+
+  mutable std::mutex m_mutex;
+  /// the cost of an entry is the size of its wire encoding
+  LruCache<Key, shared_ptr<Data>> m_cache;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_SUB_TREE_CACHE_HPP
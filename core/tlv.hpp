@@ -37,14 +37,31 @@ enum {
 
   LogResponse = 144, // 0x90
   ResultCode  = 145, // 0x91
-  ResultMsg   = 146 // 0x92
+  ResultMsg   = 146, // 0x92
+
+  BatchProof     = 147, // 0x93
+  BatchLeafIndex = 148, // 0x94
+  BatchPathHash  = 149, // 0x95
+
+  DataNameList = 160, // 0xa0
+
+  Frontier           = 176, // 0xb0
+  FrontierChecksum   = 177, // 0xb1
+  FrontierNextSeqNo  = 178, // 0xb2
+  FrontierRootHash   = 179, // 0xb3
+  FrontierSubTree    = 180, // 0xb4
+  FrontierPeakLevel  = 181, // 0xb5
+  FrontierPeakSeqNo  = 182, // 0xb6
+  FrontierLeafHashes = 183  // 0xb7
 };
 
 enum {
   LogResponse_Accept       = 0,
   LogResponse_Error_Tree   = 1,
   LogResponse_Error_Policy = 2,
-  LogResponse_Error_Signer = 3
+  LogResponse_Error_Signer = 3,
+  LogResponse_Error_Fetch  = 4,
+  LogResponse_Error_Busy   = 5
 };
 
 } // namespace tlv
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_UTIL_LRU_CACHE_HPP
+#define NDN_DELOREAN_UTIL_LRU_CACHE_HPP
+
+#include "common.hpp"
+
+#include <iterator>
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A least recently used cache of values bounded by their total cost
+ *
+ * Each value is inserted with a cost, e.g., 1 to bound the number of entries or its size to
+ * bound the memory held.  The cache keeps hit and miss counters.  It is not thread-safe, the
+ * caches built on it choose their own locking.
+ */
+template<typename Key, typename Value>
+class LruCache : noncopyable
+{
+public:
+  /**
+   * @brief Create a cache of at most @p capacity in total cost, 0 disables the cache
+   */
+  explicit
+  LruCache(size_t capacity = 0)
+    : m_capacity(capacity)
+    , m_size(0)
+    , m_nHits(0)
+    , m_nMisses(0)
+  {
+  }
+
+  /**
+   * @brief Change the capacity, evicting the least recently used entries if necessary
+   */
+  void
+  setCapacity(size_t capacity)
+  {
+    m_capacity = capacity;
+    evict();
+  }
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief Get the total cost of the cached values
+   */
+  size_t
+  getSize() const
+  {
+    return m_size;
+  }
+
+  size_t
+  getNEntries() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+  /**
+   * @brief Look up a value and make it the most recently used entry
+   *
+   * Lookups are not counted when the cache is disabled.
+   *
+   * @return the value, or a default-constructed Value if it is not cached
+   */
+  Value
+  find(const Key& key)
+  {
+    if (m_capacity == 0)
+      return Value();
+
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      m_nMisses++;
+      return Value();
+    }
+
+    m_nHits++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->value;
+  }
+
+  /**
+   * @brief Insert or replace a value as the most recently used entry
+   *
+   * A value which costs more than the capacity is not cached.
+   */
+  void
+  insert(const Key& key, const Value& value, size_t cost = 1)
+  {
+    erase(key);
+    if (cost > m_capacity)
+      return;
+
+    m_entries.push_front(Entry{key, value, cost});
+    m_index[key] = m_entries.begin();
+    m_size += cost;
+    evict();
+  }
+
+  void
+  erase(const Key& key)
+  {
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+      eraseEntry(it->second);
+  }
+
+private:
+  struct Entry
+  {
+    Key key;
+    Value value;
+    size_t cost;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  void
+  eraseEntry(typename EntryList::iterator entry)
+  {
+    m_size -= entry->cost;
+    m_index.erase(entry->key);
+    m_entries.erase(entry);
+  }
+
+  /**
+   * @brief Evict the least recently used entries until the cache fits in its capacity
+   */
+  void
+  evict()
+  {
+    while (m_size > m_capacity)
+      eraseEntry(std::prev(m_entries.end()));
+  }
+
+private:
+  size_t m_capacity;
+  size_t m_size;
+  uint64_t m_nHits;
+  uint64_t m_nMisses;
+
+  /// most recently used entry first
+  EntryList m_entries;
+  std::map<Key, typename EntryList::iterator> m_index;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_UTIL_LRU_CACHE_HPP
@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_UTIL_SHA256_DIGEST_HPP
+#define NDN_DELOREAN_UTIL_SHA256_DIGEST_HPP
+
+#include <array>
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A SHA-256 digest held by value
+ *
+ * Node hashes are passed around as this trivially copyable type, the conversion from and to
+ * ndn::Buffer only happens when a digest is put on or taken from the wire.
+ */
+typedef std::array<uint8_t, 32> Sha256Digest;
+
+/**
+ * @brief Compute the SHA-256 digest of @p size bytes at @p buf
+ */
+Sha256Digest
+computeSha256Digest(const uint8_t* buf, size_t size);
+
+/**
+ * @brief Copy a digest from wire, e.g., the value of a name component
+ *
+ * @return false if @p size is not the size of a SHA-256 digest
+ */
+inline bool
+toSha256Digest(const uint8_t* buf, size_t size, Sha256Digest& digest)
+{
+  if (size != digest.size())
+    return false;
+
+  std::copy(buf, buf + size, digest.begin());
+  return true;
+}
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_UTIL_SHA256_DIGEST_HPP
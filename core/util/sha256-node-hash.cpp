@@ -0,0 +1,415 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sha256-node-hash.hpp"
+
+#include <cstring>
+
+#include <boost/assert.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace ndn {
+namespace delorean {
+
+namespace {
+
+const uint32_t SHA256_K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t SHA256_H0[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * The preimage of a node hash has a fixed size, so its padded message is always two blocks:
+ * level, seqNo, left and the first half of right in the first block, the second half of
+ * right followed by the padding in the second one.  The padding is the same for all nodes.
+ */
+const size_t PREIMAGE_SIZE = 2 * sizeof(uint64_t) + 2 * 32;
+const size_t BLOCK_SIZE = 64;
+const size_t N_BLOCK_WORDS = 16;
+
+void
+getPreimage(const Sha256NodeHashJob& job, uint8_t* preimage)
+{
+  std::memcpy(preimage, &job.level, sizeof(job.level));
+  std::memcpy(preimage + 8, &job.seqNo, sizeof(job.seqNo));
+  std::memcpy(preimage + 16, job.left->data(), 32);
+  std::memcpy(preimage + 48, job.right->data(), 32);
+}
+
+const uint32_t PADDING_FIRST_WORD = 0x80000000;
+const uint32_t PADDING_SIZE_WORD = PREIMAGE_SIZE * 8; // the preimage size in bits
+
+inline uint32_t
+loadBigEndian(const uint8_t* buf)
+{
+  return (static_cast<uint32_t>(buf[0]) << 24) | (static_cast<uint32_t>(buf[1]) << 16) |
+         (static_cast<uint32_t>(buf[2]) << 8) | static_cast<uint32_t>(buf[3]);
+}
+
+inline void
+storeBigEndian(uint32_t word, uint8_t* buf)
+{
+  buf[0] = static_cast<uint8_t>(word >> 24);
+  buf[1] = static_cast<uint8_t>(word >> 16);
+  buf[2] = static_cast<uint8_t>(word >> 8);
+  buf[3] = static_cast<uint8_t>(word);
+}
+
+/**
+ * The compression function is written once for a type W, which is either uint32_t or a GCC
+ * vector of uint32_t, in which case each lane runs an independent hash.  The functions are
+ * always inlined, so that they are compiled for the instruction set of the kernel using them.
+ * Vectors are never passed by value, as their ABI depends on the instruction set.
+ */
+#define NDN_DELOREAN_SHA256_INLINE inline __attribute__((always_inline))
+#define NDN_DELOREAN_SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+template<typename W>
+NDN_DELOREAN_SHA256_INLINE void
+compress(W (&state)[8], const W (&block)[N_BLOCK_WORDS])
+{
+  W w[64];
+  for (size_t t = 0; t < N_BLOCK_WORDS; t++)
+    w[t] = block[t];
+  for (size_t t = N_BLOCK_WORDS; t < 64; t++) {
+    W s0 = NDN_DELOREAN_SHA256_ROTR(w[t - 15], 7) ^ NDN_DELOREAN_SHA256_ROTR(w[t - 15], 18) ^ (w[t - 15] >> 3);
+    W s1 = NDN_DELOREAN_SHA256_ROTR(w[t - 2], 17) ^ NDN_DELOREAN_SHA256_ROTR(w[t - 2], 19) ^ (w[t - 2] >> 10);
+    w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+  }
+
+  W a = state[0], b = state[1], c = state[2], d = state[3];
+  W e = state[4], f = state[5], g = state[6], h = state[7];
+  for (size_t t = 0; t < 64; t++) {
+    W s1 = NDN_DELOREAN_SHA256_ROTR(e, 6) ^ NDN_DELOREAN_SHA256_ROTR(e, 11) ^ NDN_DELOREAN_SHA256_ROTR(e, 25);
+    W ch = (e & f) ^ (~e & g);
+    W t1 = h + s1 + ch + SHA256_K[t] + w[t];
+    W s0 = NDN_DELOREAN_SHA256_ROTR(a, 2) ^ NDN_DELOREAN_SHA256_ROTR(a, 13) ^ NDN_DELOREAN_SHA256_ROTR(a, 22);
+    W maj = (a & b) ^ (a & c) ^ (b & c);
+    W t2 = s0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+/**
+ * @brief Hash exactly N_LANES jobs, lane i of a W holds the word of jobs[i]
+ */
+template<typename W, size_t N_LANES>
+NDN_DELOREAN_SHA256_INLINE void
+hashLanes(const Sha256NodeHashJob* jobs)
+{
+  static_assert(sizeof(W) == N_LANES * sizeof(uint32_t), "W must hold one word per lane");
+
+  // the preimage is the first block and the first 4 words of the second block
+  const size_t nPreimageWords = PREIMAGE_SIZE / sizeof(uint32_t);
+  uint32_t words[nPreimageWords][N_LANES];
+  for (size_t lane = 0; lane < N_LANES; lane++) {
+    uint8_t preimage[PREIMAGE_SIZE];
+    getPreimage(jobs[lane], preimage);
+    for (size_t t = 0; t < nPreimageWords; t++)
+      words[t][lane] = loadBigEndian(preimage + 4 * t);
+  }
+
+  W state[8];
+  for (size_t i = 0; i < 8; i++)
+    state[i] = W() + SHA256_H0[i];
+
+  W block[N_BLOCK_WORDS];
+  std::memcpy(block, words, sizeof(block));
+  compress(state, block);
+
+  std::memcpy(block, words[N_BLOCK_WORDS], (nPreimageWords - N_BLOCK_WORDS) * sizeof(W));
+  block[nPreimageWords - N_BLOCK_WORDS] = W() + PADDING_FIRST_WORD;
+  for (size_t t = nPreimageWords - N_BLOCK_WORDS + 1; t < N_BLOCK_WORDS - 1; t++)
+    block[t] = W();
+  block[N_BLOCK_WORDS - 1] = W() + PADDING_SIZE_WORD;
+  compress(state, block);
+
+  uint32_t digests[8][N_LANES];
+  std::memcpy(digests, state, sizeof(state));
+  for (size_t lane = 0; lane < N_LANES; lane++)
+    for (size_t i = 0; i < 8; i++)
+      storeBigEndian(digests[i][lane], jobs[lane].result->data() + 4 * i);
+}
+
+/**
+ * @brief Hash @p nJobs jobs, N_LANES at a time
+ *
+ * The last group is filled up with copies of its first job, whose results are discarded.
+ */
+template<typename W, size_t N_LANES>
+NDN_DELOREAN_SHA256_INLINE void
+hashJobs(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  size_t nFull = nJobs - nJobs % N_LANES;
+  for (size_t i = 0; i < nFull; i += N_LANES)
+    hashLanes<W, N_LANES>(jobs + i);
+
+  if (nFull == nJobs)
+    return;
+
+  Sha256Digest discarded;
+  Sha256NodeHashJob tail[N_LANES];
+  for (size_t lane = 0; lane < N_LANES; lane++) {
+    if (nFull + lane < nJobs) {
+      tail[lane] = jobs[nFull + lane];
+    }
+    else {
+      tail[lane] = jobs[nFull];
+      tail[lane].result = &discarded;
+    }
+  }
+  hashLanes<W, N_LANES>(tail);
+}
+
+void
+hashScalar(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  hashJobs<uint32_t, 1>(jobs, nJobs);
+}
+
+void
+hashLibrary(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  uint8_t preimage[PREIMAGE_SIZE];
+  for (size_t j = 0; j < nJobs; j++) {
+    getPreimage(jobs[j], preimage);
+    *jobs[j].result = computeSha256Digest(preimage, sizeof(preimage));
+  }
+}
+
+#ifdef NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+
+typedef uint32_t Lanes8 __attribute__((vector_size(32)));
+typedef uint32_t Lanes16 __attribute__((vector_size(64)));
+
+__attribute__((target("avx2")))
+void
+hashAvx2(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  hashJobs<Lanes8, 8>(jobs, nJobs);
+}
+
+__attribute__((target("avx512f")))
+void
+hashAvx512(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  hashJobs<Lanes16, 16>(jobs, nJobs);
+}
+
+__attribute__((target("sha,sse4.1")))
+void
+hashShaNi(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  // the state is kept as ABEF and CDGH, which is the layout sha256rnds2 works on
+  const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  const __m128i initial = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_H0[0]));
+  const __m128i initial1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_H0[4]));
+  const __m128i dcba = _mm_shuffle_epi32(initial, 0xB1);
+  const __m128i efgh = _mm_shuffle_epi32(initial1, 0x1B);
+  const __m128i initialAbef = _mm_alignr_epi8(dcba, efgh, 8);
+  const __m128i initialCdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+  for (size_t j = 0; j < nJobs; j++) {
+    uint8_t message[2 * BLOCK_SIZE] = {};
+    getPreimage(jobs[j], message);
+    storeBigEndian(PADDING_FIRST_WORD, message + PREIMAGE_SIZE);
+    storeBigEndian(PADDING_SIZE_WORD, message + sizeof(message) - sizeof(uint32_t));
+
+    __m128i abef = initialAbef;
+    __m128i cdgh = initialCdgh;
+    for (size_t i = 0; i < 2; i++) {
+      const __m128i abefSaved = abef;
+      const __m128i cdghSaved = cdgh;
+
+      __m128i w[4];
+      for (size_t k = 0; k < 16; k++) {
+        if (k < 4) {
+          __m128i data =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(message + i * BLOCK_SIZE + 16 * k));
+          w[k] = _mm_shuffle_epi8(data, byteSwap);
+        }
+        else {
+          // w[k % 4] holds w[t - 16 .. t - 13] and is replaced by w[t .. t + 3]
+          __m128i w7 = _mm_alignr_epi8(w[(k + 3) % 4], w[(k + 2) % 4], 4);
+          __m128i sum = _mm_add_epi32(_mm_sha256msg1_epu32(w[k % 4], w[(k + 1) % 4]), w7);
+          w[k % 4] = _mm_sha256msg2_epu32(sum, w[(k + 3) % 4]);
+        }
+
+        __m128i wk = _mm_add_epi32(w[k % 4],
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(&SHA256_K[4 * k])));
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0E));
+      }
+
+      abef = _mm_add_epi32(abef, abefSaved);
+      cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    // back to ABCD and EFGH
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    uint32_t state[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+
+    for (size_t i = 0; i < 8; i++)
+      storeBigEndian(state[i], jobs[j].result->data() + 4 * i);
+  }
+}
+
+bool
+hasShaExtensions()
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid_max(0, nullptr) < 7)
+    return false;
+
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx & (1 << 29)) != 0 && __builtin_cpu_supports("sse4.1");
+}
+
+#endif // NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+
+size_t
+getNLanes(Sha256Kernel kernel)
+{
+  switch (kernel) {
+  case Sha256Kernel::AVX2:
+    return 8;
+  case Sha256Kernel::AVX512:
+    return 16;
+  default:
+    return 1;
+  }
+}
+
+Sha256Kernel
+selectKernel()
+{
+  // ordered by throughput on full batches
+  for (auto kernel : {Sha256Kernel::AVX512, Sha256Kernel::SHA_NI, Sha256Kernel::AVX2}) {
+    if (isSha256KernelSupported(kernel))
+      return kernel;
+  }
+  return Sha256Kernel::LIBRARY;
+}
+
+} // anonymous namespace
+
+bool
+isSha256KernelSupported(Sha256Kernel kernel)
+{
+  switch (kernel) {
+  case Sha256Kernel::SCALAR:
+  case Sha256Kernel::LIBRARY:
+    return true;
+#ifdef NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+  case Sha256Kernel::SHA_NI:
+    return hasShaExtensions();
+  case Sha256Kernel::AVX2:
+    return __builtin_cpu_supports("avx2");
+  case Sha256Kernel::AVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif // NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+  default:
+    return false;
+  }
+}
+
+Sha256Kernel
+getDefaultSha256Kernel()
+{
+  static const Sha256Kernel kernel = selectKernel();
+  return kernel;
+}
+
+void
+computeNodeHashes(const Sha256NodeHashJob* jobs, size_t nJobs)
+{
+  static const Sha256Kernel batchKernel = getDefaultSha256Kernel();
+  static const Sha256Kernel singleKernel =
+    isSha256KernelSupported(Sha256Kernel::SHA_NI) ? Sha256Kernel::SHA_NI : Sha256Kernel::LIBRARY;
+
+  // the jobs that do not fill up the lanes of the batch kernel, e.g., the single dirty node of
+  // a level after a one-leaf append, go to the one-at-a-time kernel
+  size_t nBatched = nJobs - nJobs % getNLanes(batchKernel);
+  size_t nRest = nJobs - nBatched;
+
+  if (nBatched > 0)
+    computeNodeHashes(jobs, nBatched, batchKernel);
+  if (nRest > 0)
+    computeNodeHashes(jobs + nBatched, nRest, singleKernel);
+}
+
+void
+computeNodeHashes(const Sha256NodeHashJob* jobs, size_t nJobs, Sha256Kernel kernel)
+{
+  BOOST_ASSERT(isSha256KernelSupported(kernel));
+
+  switch (kernel) {
+#ifdef NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+  case Sha256Kernel::SHA_NI:
+    return hashShaNi(jobs, nJobs);
+  case Sha256Kernel::AVX2:
+    return hashAvx2(jobs, nJobs);
+  case Sha256Kernel::AVX512:
+    return hashAvx512(jobs, nJobs);
+#endif // NDN_DELOREAN_HAVE_X86_SHA256_KERNELS
+  case Sha256Kernel::LIBRARY:
+    return hashLibrary(jobs, nJobs);
+  default:
+    return hashScalar(jobs, nJobs);
+  }
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_UTIL_SHA256_NODE_HASH_HPP
+#define NDN_DELOREAN_UTIL_SHA256_NODE_HASH_HPP
+
+#include "sha256-digest.hpp"
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief The input and output of one tree node hash
+ *
+ * The hash of a node is SHA-256 over its level and seqNo, each as 8 bytes in host byte order,
+ * followed by the hashes of its left and right children.
+ */
+struct Sha256NodeHashJob
+{
+  uint64_t level;
+  uint64_t seqNo;
+  const Sha256Digest* left;
+  const Sha256Digest* right;
+  Sha256Digest* result;
+};
+
+/**
+ * @brief The implementations of the node hash
+ */
+enum class Sha256Kernel {
+  SCALAR,  ///< portable implementation, one hash at a time
+  LIBRARY, ///< SHA-256 of the crypto library, one hash at a time
+  SHA_NI,  ///< x86 SHA extensions, one hash at a time
+  AVX2,    ///< 8 hashes in parallel
+  AVX512   ///< 16 hashes in parallel
+};
+
+/**
+ * @brief Check if @p kernel can run on this CPU
+ */
+bool
+isSha256KernelSupported(Sha256Kernel kernel);
+
+/**
+ * @brief Get the kernel used by computeNodeHashes for batches when none is specified
+ *
+ * The kernel is selected once, at the first call, from what the CPU supports.  Jobs that do
+ * not fill up the lanes of a multi-buffer kernel are hashed one at a time, with SHA_NI if the
+ * CPU has it, otherwise with LIBRARY.  SCALAR is never selected, the library is faster.
+ */
+Sha256Kernel
+getDefaultSha256Kernel();
+
+/**
+ * @brief Compute @p nJobs independent node hashes
+ *
+ * @pre the result of a job does not overlap with the children of any job
+ */
+void
+computeNodeHashes(const Sha256NodeHashJob* jobs, size_t nJobs);
+
+/**
+ * @brief Compute @p nJobs independent node hashes with @p kernel
+ *
+ * @pre isSha256KernelSupported(kernel)
+ */
+void
+computeNodeHashes(const Sha256NodeHashJob* jobs, size_t nJobs, Sha256Kernel kernel);
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_UTIL_SHA256_NODE_HASH_HPP
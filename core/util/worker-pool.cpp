@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "worker-pool.hpp"
+
+namespace ndn {
+namespace delorean {
+
+WorkerPool::WorkerPool(size_t nThreads)
+  : m_isStopped(false)
+{
+  for (size_t i = 0; i < nThreads; i++)
+    m_threads.emplace_back(&WorkerPool::run, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopped = true;
+    m_tasks.clear();
+  }
+  m_taskPosted.notify_all();
+
+  for (auto& thread : m_threads)
+    thread.join();
+}
+
+size_t
+WorkerPool::getQueueDepth() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_tasks.size();
+}
+
+void
+WorkerPool::post(const Task& task)
+{
+  if (m_threads.empty()) {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(task);
+  }
+  m_taskPosted.notify_one();
+}
+
+void
+WorkerPool::run()
+{
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_taskPosted.wait(lock, [this] { return m_isStopped || !m_tasks.empty(); });
+      if (m_isStopped)
+        return;
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_UTIL_WORKER_POOL_HPP
+#define NDN_DELOREAN_UTIL_WORKER_POOL_HPP
+
+#include "common.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief A fixed set of threads running posted tasks in FIFO order
+ *
+ * A pool without threads runs each task inline in post(), which keeps the caller
+ * single-threaded.  Tasks which have not started when the pool is destroyed are dropped, the
+ * running ones are waited for.
+ */
+class WorkerPool : noncopyable
+{
+public:
+  typedef function<void()> Task;
+
+  explicit
+  WorkerPool(size_t nThreads = 0);
+
+  ~WorkerPool();
+
+  size_t
+  getNThreads() const
+  {
+    return m_threads.size();
+  }
+
+  /**
+   * @brief Get the number of tasks waiting for a thread
+   */
+  size_t
+  getQueueDepth() const;
+
+  void
+  post(const Task& task);
+
+private:
+  void
+  run();
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_taskPosted;
+  std::deque<Task> m_tasks;
+  bool m_isStopped;
+
+  std::vector<std::thread> m_threads;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_UTIL_WORKER_POOL_HPP
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "verification-queue.hpp"
+
+namespace ndn {
+namespace delorean {
+
+VerificationQueue::VerificationQueue(boost::asio::io_service& io, size_t nThreads)
+  : m_io(io)
+  , m_nextTicket(0)
+  , m_nCompleted(0)
+  , m_lifetime(make_shared<int>(0))
+  , m_pool(nThreads)
+{
+}
+
+void
+VerificationQueue::submit(const Verification& verification, const VerdictCallback& callback)
+{
+  uint64_t ticket = m_nextTicket++;
+  Submission& submission = m_submissions[ticket];
+  submission.callback = callback;
+  submission.isCompleted = false;
+
+  if (m_pool.getNThreads() == 0) {
+    m_nCompleted++;
+    complete(ticket, verification());
+    return;
+  }
+
+  weak_ptr<int> lifetime = m_lifetime;
+  m_pool.post([this, lifetime, ticket, verification] {
+      int verdict = verification();
+      m_nCompleted++;
+
+      m_io.post([this, lifetime, ticket, verdict] {
+          if (!lifetime.expired())
+            complete(ticket, verdict);
+        });
+    });
+}
+
+void
+VerificationQueue::complete(uint64_t ticket, int verdict)
+{
+  auto it = m_submissions.find(ticket);
+  BOOST_ASSERT(it != m_submissions.end());
+  it->second.isCompleted = true;
+  it->second.verdict = verdict;
+
+  // a callback may submit again, so the head is looked up anew each time
+  while (!m_submissions.empty() && m_submissions.begin()->second.isCompleted) {
+    Submission submission = std::move(m_submissions.begin()->second);
+    m_submissions.erase(m_submissions.begin());
+    m_nCompleted--;
+
+    submission.callback(submission.verdict);
+  }
+}
+
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_DELOREAN_CORE_VERIFICATION_QUEUE_HPP
+#define NDN_DELOREAN_CORE_VERIFICATION_QUEUE_HPP
+
+#include "common.hpp"
+#include "util/worker-pool.hpp"
+
+#include <atomic>
+#include <map>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief Run verifications on a worker pool and deliver their verdicts on the io_service
+ *        thread in the order of submission
+ *
+ * Signature verification is the most expensive step of logging, so it is spread over several
+ * threads, while the leaves are still appended in the order the Data was submitted.  submit
+ * and the getters must be called from the io_service thread.  Verdicts which have not been
+ * delivered when the queue is destroyed are dropped.
+ */
+class VerificationQueue : noncopyable
+{
+public:
+  /**
+   * @brief A verification, which may run on a worker thread and returns a verdict
+   */
+  typedef function<int()> Verification;
+
+  /**
+   * @brief Receive the verdict of a verification on the io_service thread
+   */
+  typedef function<void(int verdict)> VerdictCallback;
+
+  /**
+   * @param io the io_service the verdicts are delivered on
+   * @param nThreads the number of verification threads, 0 verifies inline in submit
+   */
+  VerificationQueue(boost::asio::io_service& io, size_t nThreads);
+
+  size_t
+  getNThreads() const
+  {
+    return m_pool.getNThreads();
+  }
+
+  /**
+   * @brief Get the number of verifications waiting for a thread
+   */
+  size_t
+  getQueueDepth() const
+  {
+    return m_pool.getQueueDepth();
+  }
+
+  /**
+   * @brief Get the number of verdicts waiting to be delivered, either for their turn or for
+   *        the io_service
+   */
+  size_t
+  getNUndelivered() const
+  {
+    return m_nCompleted;
+  }
+
+  void
+  submit(const Verification& verification, const VerdictCallback& callback);
+
+private:
+  /**
+   * @brief Record the verdict of submission @p ticket and deliver the verdicts now in order
+   */
+  void
+  complete(uint64_t ticket, int verdict);
+
+private:
+  struct Submission
+  {
+    VerdictCallback callback;
+    bool isCompleted;
+    int verdict;
+  };
+
+  boost::asio::io_service& m_io;
+
+  uint64_t m_nextTicket;
+  /// submissions by ticket, the first one is the next to be delivered
+  std::map<uint64_t, Submission> m_submissions;
+  std::atomic<size_t> m_nCompleted;
+
+  /// expires with the queue, so that the verdicts posted to the io_service can tell
+  shared_ptr<int> m_lifetime;
+
+  // destroyed first, while what its tasks use is still there
+  WorkerPool m_pool;
+};
+
+} // namespace delorean
+} // namespace ndn
+
+#endif // NDN_DELOREAN_CORE_VERIFICATION_QUEUE_HPP
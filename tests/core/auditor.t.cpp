@@ -43,14 +43,16 @@ printHex(const uint8_t* buf, size_t size)
 BOOST_AUTO_TEST_CASE(LoadProofTests)
 {
   std::vector<shared_ptr<Data>> proofs;
-  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32)->encode());
-  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(32, 5), 64)->encode());
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1)->encode());
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP),
+                                                   2 * N_LEAVES_1)->encode());
 
   std::map<Node::Index, ConstSubTreeBinaryPtr> tree1;
 
   BOOST_CHECK(Auditor::loadProof(tree1, proofs, TreeGenerator::LOGGER_NAME));
 
-  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(32, 5), 64)->encode());
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP),
+                                                   2 * N_LEAVES_1)->encode());
   std::map<Node::Index, ConstSubTreeBinaryPtr> tree2;
   BOOST_CHECK_EQUAL(Auditor::loadProof(tree2, proofs, TreeGenerator::LOGGER_NAME), false);
 }
@@ -74,7 +76,8 @@ public:
   void
   createProof()
   {
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32, true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1,
+                                                     true)->encode());
 
     leafHash = TreeGenerator::getHash(Node::Index(L, 0), L + 1, false);
     oldHash = TreeGenerator::getHash(Node::Index(0, getRootLevel(O - 1)), O, false);
@@ -83,11 +86,11 @@ public:
 
   std::vector<shared_ptr<Data>> proofs;
   const NonNegativeInteger leafSeqNo = L;
-  ndn::ConstBufferPtr leafHash;
+  Sha256Digest leafHash;
   const NonNegativeInteger oldNextSeqNo = O;
-  ndn::ConstBufferPtr oldHash;
+  Sha256Digest oldHash;
   const NonNegativeInteger newNextSeqNo = N;
-  ndn::ConstBufferPtr newHash;
+  Sha256Digest newHash;
 };
 
 template<NonNegativeInteger L, NonNegativeInteger O, NonNegativeInteger N>
@@ -97,9 +100,12 @@ public:
   void
   createProof()
   {
-    // proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(32, 5), 64, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 64, true)->encode());
+    // proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1,
+    //                                                  true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP), 2 * N_LEAVES_1,
+                                                     true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), 2 * N_LEAVES_1,
+                                                     true)->encode());
 
     leafHash = TreeGenerator::getHash(Node::Index(L, 0), L + 1, false);
     oldHash = TreeGenerator::getHash(Node::Index(0, getRootLevel(O - 1)), O, false);
@@ -108,11 +114,11 @@ public:
 
   std::vector<shared_ptr<Data>> proofs;
   const NonNegativeInteger leafSeqNo = L;
-  ndn::ConstBufferPtr leafHash;
+  Sha256Digest leafHash;
   const NonNegativeInteger oldNextSeqNo = O;
-  ndn::ConstBufferPtr oldHash;
+  Sha256Digest oldHash;
   const NonNegativeInteger newNextSeqNo = N;
-  ndn::ConstBufferPtr newHash;
+  Sha256Digest newHash;
 };
 
 template<NonNegativeInteger L, NonNegativeInteger O, NonNegativeInteger N>
@@ -122,9 +128,12 @@ public:
   void
   createProof()
   {
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(32, 5), 33, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 33, true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1,
+                                                     true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP), N_LEAVES_1 + 1,
+                                                     true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), N_LEAVES_1 + 1,
+                                                     true)->encode());
 
     leafHash = TreeGenerator::getHash(Node::Index(L, 0), L + 1, false);
     oldHash = TreeGenerator::getHash(Node::Index(0, getRootLevel(O - 1)), O, false);
@@ -133,11 +142,11 @@ public:
 
   std::vector<shared_ptr<Data>> proofs;
   const NonNegativeInteger leafSeqNo = L;
-  ndn::ConstBufferPtr leafHash;
+  Sha256Digest leafHash;
   const NonNegativeInteger oldNextSeqNo = O;
-  ndn::ConstBufferPtr oldHash;
+  Sha256Digest oldHash;
   const NonNegativeInteger newNextSeqNo = N;
-  ndn::ConstBufferPtr newHash;
+  Sha256Digest newHash;
 };
 
 typedef boost::mpl::list<AuditorProofParam1<0, 1, 1>,
@@ -148,10 +157,11 @@ typedef boost::mpl::list<AuditorProofParam1<0, 1, 1>,
                          AuditorProofParam1<2, 4, 4>,
                          AuditorProofParam1<3, 4, 4>,
                          AuditorProofParam1<4, 6, 6>,
-                         AuditorProofParam1<31, 32, 32>,
-                         AuditorProofParam3<0, 33, 33>,
-                         AuditorProofParam2<32, 33, 33>,
-                         AuditorProofParam2<48, 64, 64>> ExistenceProofTestParams;
+                         AuditorProofParam1<N_LEAVES_1 - 1, N_LEAVES_1, N_LEAVES_1>,
+                         AuditorProofParam3<0, N_LEAVES_1 + 1, N_LEAVES_1 + 1>,
+                         AuditorProofParam2<N_LEAVES_1, N_LEAVES_1 + 1, N_LEAVES_1 + 1>,
+                         AuditorProofParam2<N_LEAVES_1 * 3 / 2, 2 * N_LEAVES_1, 2 * N_LEAVES_1>>
+                         ExistenceProofTestParams;
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(ExistenceProof, P, ExistenceProofTestParams)
 {
@@ -170,9 +180,12 @@ public:
   void
   createProof()
   {
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(32, 5), 64, true)->encode());
-    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 64, true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1,
+                                                     true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP), 2 * N_LEAVES_1,
+                                                     true)->encode());
+    proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), 2 * N_LEAVES_1,
+                                                     true)->encode());
 
     leafHash = TreeGenerator::getHash(Node::Index(L, 0), L + 1, false);
     oldHash = TreeGenerator::getHash(Node::Index(0, getRootLevel(O - 1)), O, false);
@@ -181,22 +194,22 @@ public:
 
   std::vector<shared_ptr<Data>> proofs;
   const NonNegativeInteger leafSeqNo = L;
-  ndn::ConstBufferPtr leafHash;
+  Sha256Digest leafHash;
   const NonNegativeInteger oldNextSeqNo = O;
-  ndn::ConstBufferPtr oldHash;
+  Sha256Digest oldHash;
   const NonNegativeInteger newNextSeqNo = N;
-  ndn::ConstBufferPtr newHash;
+  Sha256Digest newHash;
 };
 
 typedef boost::mpl::list<AuditorProofParam1<0, 1, 1>,
                          AuditorProofParam1<0, 1, 2>,
-                         AuditorProofParam1<0, 1, 32>,
-                         AuditorProofParam1<0, 2, 32>,
-                         AuditorProofParam1<0, 31, 32>,
-                         AuditorProofParam4<0, 32, 64>,
-                         AuditorProofParam3<0, 1, 33>,
-                         AuditorProofParam3<0, 31, 33>,
-                         AuditorProofParam4<0, 1, 64>> ConsistencyProofTestParams;
+                         AuditorProofParam1<0, 1, N_LEAVES_1>,
+                         AuditorProofParam1<0, 2, N_LEAVES_1>,
+                         AuditorProofParam1<0, N_LEAVES_1 - 1, N_LEAVES_1>,
+                         AuditorProofParam4<0, N_LEAVES_1, 2 * N_LEAVES_1>,
+                         AuditorProofParam3<0, 1, N_LEAVES_1 + 1>,
+                         AuditorProofParam3<0, N_LEAVES_1 - 1, N_LEAVES_1 + 1>,
+                         AuditorProofParam4<0, 1, 2 * N_LEAVES_1>> ConsistencyProofTestParams;
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(ConsistencyProof, P, ConsistencyProofTestParams)
 {
@@ -208,6 +221,83 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(ConsistencyProof, P, ConsistencyProofTestParams)
                                     params.proofs, TreeGenerator::LOGGER_NAME));
 }
 
+BOOST_AUTO_TEST_CASE(ProofSetLoad)
+{
+  std::vector<shared_ptr<Data>> proofs;
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1,
+                                                   true)->encode());
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP), 2 * N_LEAVES_1,
+                                                   true)->encode());
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), 2 * N_LEAVES_1,
+                                                   true)->encode());
+
+  Auditor::ProofSet proofSet1;
+  BOOST_CHECK(proofSet1.load(proofs, TreeGenerator::LOGGER_NAME));
+  BOOST_CHECK_EQUAL(proofSet1.getTrees().size(), 3);
+
+  Auditor::ProofSet proofSet2;
+  BOOST_CHECK(proofSet2.load(proofs, TreeGenerator::LOGGER_NAME, 2));
+  BOOST_REQUIRE_EQUAL(proofSet2.getTrees().size(), 3);
+  for (const auto& tree : proofSet1.getTrees()) {
+    auto other = proofSet2.find(tree.first);
+    BOOST_REQUIRE(other != nullptr);
+    BOOST_CHECK(*other->encode() == *tree.second->encode());
+  }
+  BOOST_CHECK(proofSet2.find(Node::Index(2 * N_LEAVES_1, STEP)) == nullptr);
+
+  proofs.push_back(TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_1, STEP), 2 * N_LEAVES_1,
+                                                   true)->encode());
+  Auditor::ProofSet proofSet3;
+  BOOST_CHECK_EQUAL(proofSet3.load(proofs, TreeGenerator::LOGGER_NAME, 4), false);
+  BOOST_CHECK_EQUAL(proofSet3.getTrees().size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MultipleExistenceProof)
+{
+  AuditorProofParam4<0, 2 * N_LEAVES_1, 2 * N_LEAVES_1> params;
+  params.createProof();
+
+  Auditor::ProofSet proofSet;
+  BOOST_REQUIRE(proofSet.load(params.proofs, TreeGenerator::LOGGER_NAME, 2));
+
+  Sha256Digest badHash = params.leafHash;
+  badHash[0] ^= 0x01;
+
+  std::vector<Auditor::Claim> claims;
+  for (NonNegativeInteger seqNo = 0; seqNo < 2 * N_LEAVES_1; seqNo++)
+    claims.push_back(Auditor::Claim{seqNo, params.leafHash});
+  claims.push_back(Auditor::Claim{5, badHash});
+  claims.push_back(Auditor::Claim{N_LEAVES_1 + 8, badHash});
+  claims.push_back(Auditor::Claim{2 * N_LEAVES_1, params.leafHash});
+  claims.push_back(Auditor::Claim{17, params.leafHash});
+
+  std::vector<bool> results = Auditor::doExist(claims, params.newNextSeqNo, params.newHash,
+                                               proofSet);
+  BOOST_REQUIRE_EQUAL(results.size(), claims.size());
+  const size_t nLeaves = 2 * N_LEAVES_1;
+  for (size_t i = 0; i < nLeaves; i++)
+    BOOST_CHECK(results[i]);
+  BOOST_CHECK_EQUAL(results[nLeaves], false);
+  BOOST_CHECK_EQUAL(results[nLeaves + 1], false);
+  BOOST_CHECK_EQUAL(results[nLeaves + 2], false);
+  BOOST_CHECK(results[nLeaves + 3]);
+
+  // a single claim gives the same answer as the batch
+  for (size_t i = 0; i < claims.size(); i++) {
+    BOOST_CHECK_EQUAL(Auditor::doesExist(claims[i].seqNo, claims[i].hash,
+                                         params.newNextSeqNo, params.newHash, proofSet),
+                      results[i]);
+  }
+
+  // without the subtree of the right half, only the left half can be proven
+  std::vector<shared_ptr<Data>> leftProofs{params.proofs[0], params.proofs[2]};
+  Auditor::ProofSet leftProofSet;
+  BOOST_REQUIRE(leftProofSet.load(leftProofs, TreeGenerator::LOGGER_NAME));
+  results = Auditor::doExist(claims, params.newNextSeqNo, params.newHash, leftProofSet);
+  for (size_t i = 0; i < nLeaves; i++)
+    BOOST_CHECK_EQUAL(results[i], i < N_LEAVES_1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -37,6 +37,10 @@ BOOST_AUTO_TEST_CASE(Basic)
   const std::string CONFIG =
     "logger-name /test/logger                             \n"
     "db-dir /test/db                                      \n"
+    "db                                                   \n"
+    "{                                                    \n"
+    "  db-key db-value                                    \n"
+    "}                                                    \n"
     "policy                                               \n"
     "{                                                    \n"
     "  policy-key policy-value                            \n"
@@ -62,6 +66,8 @@ BOOST_AUTO_TEST_CASE(Basic)
   BOOST_CHECK_EQUAL(config.getConfFileName(), configPath.string());
   BOOST_CHECK_EQUAL(config.getLoggerName(), Name("/test/logger"));
   BOOST_CHECK_EQUAL(config.getDbDir(), "/test/db");
+  BOOST_CHECK_EQUAL(config.getDbConfig().begin()->first, "db-key");
+  BOOST_CHECK_EQUAL(config.getDbConfig().begin()->second.data(), "db-value");
   BOOST_CHECK_EQUAL(config.getPolicy().begin()->first, "policy-key");
   BOOST_CHECK_EQUAL(config.getPolicy().begin()->second.data(), "policy-value");
   BOOST_CHECK_EQUAL(config.getValidatorRule().begin()->first, "validator-key");
@@ -99,6 +105,7 @@ BOOST_AUTO_TEST_CASE(Basic2)
   BOOST_CHECK_EQUAL(config.getConfFileName(), configPath.string());
   BOOST_CHECK_EQUAL(config.getLoggerName(), Name("/test/logger"));
   BOOST_CHECK_EQUAL(config.getDbDir(), fs::path(TEST_LOGGER_PATH).string());
+  BOOST_CHECK(config.getDbConfig().empty());
   BOOST_CHECK_EQUAL(config.getPolicy().begin()->first, "policy-key");
   BOOST_CHECK_EQUAL(config.getPolicy().begin()->second.data(), "policy-value");
   BOOST_CHECK_EQUAL(config.getValidatorRule().begin()->first, "validator-key");
@@ -21,11 +21,17 @@
 
 #include "db.hpp"
 #include "db-fixture.hpp"
+#include "sub-tree-binary.hpp"
 
 #include <ndn-cxx/security/digest-sha256.hpp>
 #include <ndn-cxx/encoding/buffer-stream.hpp>
 #include "boost-test.hpp"
 
+#include <sqlite3.h>
+
+#include <atomic>
+#include <thread>
+
 namespace ndn {
 namespace delorean {
 namespace tests {
@@ -85,6 +91,24 @@ BOOST_AUTO_TEST_CASE(Basic2)
   BOOST_CHECK(subtrees[1]->wireEncode() == data2.wireEncode());
 }
 
+BOOST_AUTO_TEST_CASE(ReplaceCompleteSubTree)
+{
+  ndn::DigestSha256 digest;
+  ndn::ConstBufferPtr hash = make_shared<ndn::Buffer>(32);
+  Data data1(Name("/logger/name/5/0/abcdabcdabcdabcdabcd/complete"));
+  data1.setSignature(digest);
+  data1.setSignatureValue(Block(tlv::SignatureValue, hash));
+  Data data2(Name("/logger/name/5/0/dcbadcbadcbadcbadcba/complete"));
+  data2.setSignature(digest);
+  data2.setSignatureValue(Block(tlv::SignatureValue, hash));
+
+  // a rebuilt subtree takes the place of a corrupted one
+  db.insertSubTreeData(5, 0, data1);
+  db.insertSubTreeData(5, 0, data2);
+  BOOST_REQUIRE(db.getSubTreeData(5, 0) != nullptr);
+  BOOST_CHECK(db.getSubTreeData(5, 0)->wireEncode() == data2.wireEncode());
+}
+
 const uint8_t Data1[] = {
 0x06, 0xc5, // NDN Data
     0x07, 0x14, // Name
@@ -162,6 +186,520 @@ BOOST_AUTO_TEST_CASE(Basic3)
   BOOST_CHECK_EQUAL(db.insertLeafData(leaf3), false);
 }
 
+BOOST_AUTO_TEST_CASE(StatementReuse)
+{
+  ndn::DigestSha256 digest;
+  ndn::ConstBufferPtr hash = make_shared<ndn::Buffer>(32);
+  Data data1(Name("/logger/name/5/0/abcdabcdabcdabcdabcd/3"));
+  data1.setSignature(digest);
+  data1.setSignatureValue(Block(tlv::SignatureValue, hash));
+
+  Name dataName("/test/data");
+  for (NonNegativeInteger i = 0; i < 10; i++) {
+    BOOST_CHECK(db.getLeaf(i).first == nullptr);
+    BOOST_CHECK(db.insertLeafData(Leaf(dataName, i, i, 0)));
+    BOOST_REQUIRE(db.getLeaf(i).first != nullptr);
+    BOOST_CHECK_EQUAL(db.getLeaf(i).first->getTimestamp(), i);
+  }
+  BOOST_CHECK_EQUAL(db.getMaxLeafSeq(), 10);
+  BOOST_CHECK_EQUAL(db.getMaxLeafSeq(), 10);
+
+  BOOST_CHECK_EQUAL(db.getPendingSubTrees().size(), 0);
+  db.insertSubTreeData(5, 0, data1, false, 3);
+  BOOST_CHECK_EQUAL(db.getPendingSubTrees().size(), 1);
+  BOOST_CHECK_EQUAL(db.getPendingSubTrees().size(), 1);
+  BOOST_CHECK(db.getSubTreeData(5, 32) == nullptr);
+  BOOST_REQUIRE(db.getSubTreeData(5, 0) != nullptr);
+  BOOST_CHECK(db.getSubTreeData(5, 0)->wireEncode() == data1.wireEncode());
+}
+
+BOOST_AUTO_TEST_CASE(GroupCommit)
+{
+  conf::ConfigSection config;
+  config.put("group-commit-size", "3");
+
+  std::string groupDbDir = (m_dbTmpPath / "group").string();
+  Db groupDb;
+  groupDb.open(groupDbDir, config);
+  BOOST_CHECK_EQUAL(groupDb.getGroupCommitSize(), 3);
+  BOOST_CHECK(!groupDb.hasPendingCommit());
+
+  size_t nCommitted = 0;
+  groupDb.whenCommitted([&] { nCommitted++; });
+  BOOST_CHECK_EQUAL(nCommitted, 1);
+
+  Name dataName("/test/data");
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 0, 0, 0)));
+  groupDb.whenCommitted([&] { nCommitted++; });
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 1, 1, 0)));
+  BOOST_CHECK(groupDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(nCommitted, 1);
+
+  // appends in the open group are visible to the writer, but not to other connections
+  BOOST_CHECK(groupDb.getLeaf(1).first != nullptr);
+  {
+    Db reader;
+    reader.open(groupDbDir);
+    BOOST_CHECK_EQUAL(reader.getMaxLeafSeq(), 0);
+  }
+
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 2, 2, 0)));
+  BOOST_CHECK(!groupDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(nCommitted, 2);
+
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 3, 3, 0)));
+  groupDb.whenCommitted([&] { nCommitted++; });
+  BOOST_CHECK(groupDb.hasPendingCommit());
+  groupDb.commit();
+  BOOST_CHECK(!groupDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(nCommitted, 3);
+
+  Db reader;
+  reader.open(groupDbDir);
+  BOOST_CHECK_EQUAL(reader.getMaxLeafSeq(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(FailedCommit)
+{
+  conf::ConfigSection config;
+  config.put("group-commit-size", "2");
+
+  std::string groupDbDir = (m_dbTmpPath / "busy").string();
+  Db groupDb;
+  groupDb.open(groupDbDir, config);
+
+  // another connection in a read transaction keeps the writer from committing
+  sqlite3* reader = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open((m_dbTmpPath / "busy" / "sig-logger.db").c_str(), &reader),
+                      SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(reader, "BEGIN; SELECT count(*) FROM leaves",
+                                   nullptr, nullptr, nullptr), SQLITE_OK);
+
+  size_t nCommitted = 0;
+  Name dataName("/test/data");
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 0, 0, 0)));
+  groupDb.whenCommitted([&] { nCommitted++; });
+
+  // the full group cannot be committed, it stays open
+  BOOST_CHECK(groupDb.insertLeafData(Leaf(dataName, 1, 1, 0)));
+  BOOST_CHECK(groupDb.hasPendingCommit());
+  BOOST_CHECK_THROW(groupDb.commit(), Db::Error);
+  BOOST_CHECK(groupDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(nCommitted, 0);
+
+  sqlite3_exec(reader, "COMMIT", nullptr, nullptr, nullptr);
+  sqlite3_close(reader);
+
+  groupDb.commit();
+  BOOST_CHECK(!groupDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(nCommitted, 1);
+
+  Db db2;
+  db2.open(groupDbDir);
+  BOOST_CHECK_EQUAL(db2.getMaxLeafSeq(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidConfig)
+{
+  conf::ConfigSection config1;
+  config1.put("group-commit-size", "0");
+  Db db1;
+  BOOST_CHECK_THROW(db1.open((m_dbTmpPath / "invalid").string(), config1), Db::Error);
+
+  conf::ConfigSection config2;
+  config2.put("group-commit-window", "abc");
+  Db db2;
+  BOOST_CHECK_THROW(db2.open((m_dbTmpPath / "invalid").string(), config2), Db::Error);
+
+  conf::ConfigSection config3;
+  config3.put("unknown-option", "1");
+  Db db3;
+  BOOST_CHECK_THROW(db3.open((m_dbTmpPath / "invalid").string(), config3), Db::Error);
+
+  conf::ConfigSection config4;
+  config4.put("journal-mode", "fast");
+  Db db4;
+  BOOST_CHECK_THROW(db4.open((m_dbTmpPath / "invalid").string(), config4), Db::Error);
+
+  conf::ConfigSection config5;
+  config5.put("synchronous", "sometimes");
+  Db db5;
+  BOOST_CHECK_THROW(db5.open((m_dbTmpPath / "invalid").string(), config5), Db::Error);
+
+  conf::ConfigSection config6;
+  config6.put("page-size", "1000");
+  Db db6;
+  BOOST_CHECK_THROW(db6.open((m_dbTmpPath / "invalid").string(), config6), Db::Error);
+
+  conf::ConfigSection config7;
+  config7.put("mmap-size", "-1");
+  Db db7;
+  BOOST_CHECK_THROW(db7.open((m_dbTmpPath / "invalid").string(), config7), Db::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Pragmas)
+{
+  conf::ConfigSection config;
+  config.put("journal-mode", "WAL");
+  config.put("synchronous", "normal");
+  config.put("cache-size", "-2000");
+  config.put("mmap-size", "1048576");
+  config.put("page-size", "8192");
+
+  std::string walDbDir = (m_dbTmpPath / "wal").string();
+  {
+    Db walDb;
+    walDb.open(walDbDir, config);
+
+    Name dataName("/test/data");
+    BOOST_CHECK(walDb.insertLeafData(Leaf(dataName, 0, 0, 0)));
+    BOOST_CHECK(boost::filesystem::exists(m_dbTmpPath / "wal" / "sig-logger.db-wal"));
+
+    // readers are not blocked by the wal writer
+    Db reader;
+    reader.open(walDbDir, config);
+    BOOST_CHECK_EQUAL(reader.getMaxLeafSeq(), 1);
+    BOOST_CHECK(reader.getLeaf(0).first != nullptr);
+  }
+
+  // the journal mode is persistent
+  Db db;
+  db.open(walDbDir);
+  BOOST_CHECK_EQUAL(db.getMaxLeafSeq(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(LeafRange)
+{
+  Name dataName("/test/data");
+  Name certName("/test/cert");
+  Data cert(certName);
+  ndn::DigestSha256 sig;
+  cert.setSignature(sig);
+  cert.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  for (NonNegativeInteger i = 0; i < 10; i++) {
+    if (i == 4)
+      BOOST_CHECK(db.insertLeafData(Leaf(certName, i, i, i), cert));
+    else
+      BOOST_CHECK(db.insertLeafData(Leaf(dataName, i, i, i / 2)));
+  }
+
+  std::vector<NonNegativeInteger> seqNos;
+  size_t nCerts = 0;
+  size_t nVisited = db.getLeafRange(2, 7, [&] (const Leaf& leaf, const Block& certWire) {
+      seqNos.push_back(leaf.getDataSeqNo());
+      BOOST_CHECK_EQUAL(leaf.getTimestamp(), leaf.getDataSeqNo());
+      BOOST_CHECK(leaf.getHash() == db.getLeaf(leaf.getDataSeqNo()).first->getHash());
+      if (certWire.hasWire()) {
+        nCerts++;
+        BOOST_CHECK_EQUAL(leaf.getDataName(), certName);
+        BOOST_CHECK(certWire == cert.wireEncode());
+      }
+    });
+
+  BOOST_CHECK_EQUAL(nVisited, 5);
+  BOOST_CHECK_EQUAL(nCerts, 1);
+  std::vector<NonNegativeInteger> expected{2, 3, 4, 5, 6};
+  BOOST_CHECK_EQUAL_COLLECTIONS(seqNos.begin(), seqNos.end(), expected.begin(), expected.end());
+
+  // the encoded leaves are those of Leaf
+  seqNos.clear();
+  nVisited = db.getEncodedLeafRange(2, 7, [&] (const uint8_t* wire, size_t size) {
+      Leaf leaf;
+      leaf.wireDecode(Block(wire, size));
+      seqNos.push_back(leaf.getDataSeqNo());
+      const Block& expectedWire = db.getLeaf(leaf.getDataSeqNo()).first->wireEncode();
+      BOOST_CHECK_EQUAL_COLLECTIONS(wire, wire + size,
+                                    expectedWire.wire(), expectedWire.wire() + expectedWire.size());
+    });
+  BOOST_CHECK_EQUAL(nVisited, 5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(seqNos.begin(), seqNos.end(), expected.begin(), expected.end());
+
+  // the range is cut at the end of the log
+  BOOST_CHECK_EQUAL(db.getLeafRange(8, 100, [] (const Leaf&, const Block&) {}), 2);
+  BOOST_CHECK_EQUAL(db.getEncodedLeafRange(8, 100, [] (const uint8_t*, size_t) {}), 2);
+  BOOST_CHECK_EQUAL(db.getLeafRange(5, 5, [] (const Leaf&, const Block&) {}), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LargeSeqNo)
+{
+  const NonNegativeInteger firstSeqNo = static_cast<NonNegativeInteger>(1) << 31;
+  const Timestamp timestamp = static_cast<Timestamp>(1) << 32;
+  Name dataName("/test/data");
+
+  // leaves up to firstSeqNo, as written by an earlier logger
+  std::string largeDbDir = (m_dbTmpPath / "large").string();
+  {
+    Db largeDb;
+    largeDb.open(largeDbDir);
+  }
+  sqlite3* writer = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open((m_dbTmpPath / "large" / "sig-logger.db").c_str(), &writer),
+                      SQLITE_OK);
+  sqlite3_stmt* insertStmt = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(writer,
+                                         "INSERT INTO leaves (dataSeqNo, dataName, signerSeqNo,\
+                                          timestamp, isCert) VALUES (?, ?, 0, 0, 0)",
+                                         -1, &insertStmt, nullptr), SQLITE_OK);
+  sqlite3_bind_int64(insertStmt, 1, firstSeqNo - 1);
+  sqlite3_bind_blob(insertStmt, 2, dataName.wireEncode().wire(), dataName.wireEncode().size(),
+                    SQLITE_STATIC);
+  BOOST_CHECK_EQUAL(sqlite3_step(insertStmt), SQLITE_DONE);
+  sqlite3_finalize(insertStmt);
+  sqlite3_close(writer);
+
+  ndn::DigestSha256 digest;
+  Data subtree(Name("/logger/name/5").appendNumber(firstSeqNo).append("complete"));
+  subtree.setSignature(digest);
+  subtree.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  {
+    Db largeDb;
+    largeDb.open(largeDbDir);
+    BOOST_CHECK_EQUAL(largeDb.getMaxLeafSeq(), firstSeqNo);
+    BOOST_CHECK(largeDb.insertLeafData(Leaf(dataName, timestamp, firstSeqNo, firstSeqNo - 1)));
+    BOOST_CHECK(largeDb.insertSubTreeData(5, firstSeqNo, subtree));
+  }
+
+  // the values above 2^31 are read back as they were written
+  Db largeDb;
+  largeDb.open(largeDbDir);
+  BOOST_CHECK_EQUAL(largeDb.getMaxLeafSeq(), firstSeqNo + 1);
+  BOOST_CHECK(largeDb.insertLeafData(Leaf(dataName, timestamp, firstSeqNo + 1, firstSeqNo)));
+
+  auto leaf = largeDb.getLeaf(firstSeqNo).first;
+  BOOST_REQUIRE(leaf != nullptr);
+  BOOST_CHECK_EQUAL(leaf->getDataSeqNo(), firstSeqNo);
+  BOOST_CHECK_EQUAL(leaf->getSignerSeqNo(), firstSeqNo - 1);
+  BOOST_CHECK_EQUAL(leaf->getTimestamp(), timestamp);
+
+  auto subtree2 = largeDb.getSubTreeData(5, firstSeqNo);
+  BOOST_REQUIRE(subtree2 != nullptr);
+  BOOST_CHECK(subtree2->wireEncode() == subtree.wireEncode());
+
+  // and the ranges reach them
+  std::vector<NonNegativeInteger> seqNos;
+  BOOST_CHECK_EQUAL(largeDb.getLeafRange(firstSeqNo - 1, firstSeqNo + 2,
+                                         [&] (const Leaf& leaf, const Block&) {
+                                           seqNos.push_back(leaf.getDataSeqNo());
+                                           BOOST_CHECK(leaf.getHash() ==
+                                                       largeDb.getLeaf(leaf.getDataSeqNo())
+                                                         .first->getHash());
+                                         }), 3);
+  std::vector<NonNegativeInteger> expected{firstSeqNo - 1, firstSeqNo, firstSeqNo + 1};
+  BOOST_CHECK_EQUAL_COLLECTIONS(seqNos.begin(), seqNos.end(), expected.begin(), expected.end());
+
+  seqNos.clear();
+  BOOST_CHECK_EQUAL(largeDb.getEncodedLeafRange(firstSeqNo, firstSeqNo + 2,
+                                                [&] (const uint8_t* wire, size_t size) {
+                                                  Leaf leaf;
+                                                  leaf.wireDecode(Block(wire, size));
+                                                  seqNos.push_back(leaf.getDataSeqNo());
+                                                  BOOST_CHECK_EQUAL(leaf.getTimestamp(),
+                                                                    timestamp);
+                                                }), 2);
+  expected.erase(expected.begin());
+  BOOST_CHECK_EQUAL_COLLECTIONS(seqNos.begin(), seqNos.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(ReadConnections)
+{
+  conf::ConfigSection config;
+  config.put("journal-mode", "wal");
+  config.put("group-commit-size", "4");
+  config.put("read-connections", "3");
+
+  Db pooledDb;
+  pooledDb.open((m_dbTmpPath / "pooled").string(), config);
+  BOOST_CHECK_EQUAL(pooledDb.getNReadConnections(), 3);
+
+  ndn::DigestSha256 sig;
+  Data subtree(Name("/logger/tree/5/0/complete/digest"));
+  subtree.setSignature(sig);
+  subtree.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  const NonNegativeInteger nLeaves = 64;
+  Name dataName("/test/data");
+  for (NonNegativeInteger i = 0; i < nLeaves; i++)
+    BOOST_CHECK(pooledDb.insertLeafData(Leaf(dataName, i, i, 0)));
+  BOOST_CHECK(pooledDb.insertSubTreeData(5, 0, subtree));
+  pooledDb.commit();
+
+  // more threads than connections, so some of them wait for a connection to be released
+  std::atomic<size_t> nFound(0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 8; t++) {
+    threads.emplace_back([&] {
+      for (NonNegativeInteger i = 0; i < nLeaves; i++) {
+        auto result = pooledDb.getLeaf(i);
+        if (result.first != nullptr && result.first->getDataSeqNo() == i)
+          nFound++;
+      }
+      if (pooledDb.getSubTreeData(5, 0) != nullptr)
+        nFound++;
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  BOOST_CHECK_EQUAL(nFound, 8 * (nLeaves + 1));
+
+  // the writes of an open group are only visible through the writer
+  BOOST_CHECK(pooledDb.insertLeafData(Leaf(dataName, nLeaves, nLeaves, 0)));
+  BOOST_CHECK(pooledDb.hasPendingCommit());
+  BOOST_CHECK_EQUAL(pooledDb.getNextLeafSeqNo(), nLeaves + 1);
+  BOOST_CHECK_EQUAL(pooledDb.getNextCommittedLeafSeqNo(), nLeaves);
+  BOOST_CHECK(pooledDb.getLeaf(nLeaves).first == nullptr);
+  BOOST_CHECK(pooledDb.getLeaf(nLeaves, true).first != nullptr);
+  BOOST_CHECK_EQUAL(pooledDb.getLeafRange(0, nLeaves + 1, [] (const Leaf&, const Block&) {}),
+                    nLeaves);
+
+  pooledDb.commit();
+  BOOST_CHECK_EQUAL(pooledDb.getNextCommittedLeafSeqNo(), nLeaves + 1);
+  BOOST_CHECK(pooledDb.getLeaf(nLeaves).first != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(CachedSubTrees)
+{
+  conf::ConfigSection config;
+  config.put("subtree-cache-size", "1048576");
+
+  Db cachedDb;
+  cachedDb.open((m_dbTmpPath / "cached").string(), config);
+  const SubTreeCache& cache = cachedDb.getSubTreeCache();
+  BOOST_CHECK_EQUAL(cache.getCapacity(), 1048576);
+
+  ndn::DigestSha256 sig;
+  Data complete(Name("/logger/tree/5/0/complete/digest"));
+  complete.setSignature(sig);
+  complete.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+  Data pending(Name("/logger/tree/5/32/33/digest"));
+  pending.setSignature(sig);
+  pending.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  BOOST_CHECK(cachedDb.insertSubTreeData(5, 0, complete));
+  BOOST_CHECK(cachedDb.insertSubTreeData(5, 32, pending, false, 33));
+
+  BOOST_REQUIRE(cachedDb.getSubTreeData(5, 0) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 1);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 1);
+
+  auto data = cachedDb.getSubTreeData(5, 0);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK(data->wireEncode() == complete.wireEncode());
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+
+  // pending subtrees are not cached
+  BOOST_CHECK(cachedDb.getSubTreeData(5, 32) != nullptr);
+  BOOST_CHECK(cachedDb.getSubTreeData(5, 32) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 1);
+
+  // a complete subtree is only overwritten by a repair, which drops its cached copy on commit
+  Data repaired(Name("/logger/tree/5/0/complete/repaired"));
+  repaired.setSignature(sig);
+  repaired.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+  BOOST_CHECK(!cachedDb.insertSubTreeData(5, 0, repaired));
+  cachedDb.runInTransaction([&] {
+      BOOST_CHECK(cachedDb.replaceSubTreeData(5, 0, repaired));
+      BOOST_CHECK_EQUAL(cache.getNEntries(), 1);
+    });
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  data = cachedDb.getSubTreeData(5, 0);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK(data->wireEncode() == repaired.wireEncode());
+
+  conf::ConfigSection config2;
+  config2.put("subtree-cache-size", "large");
+  Db db2;
+  BOOST_CHECK_THROW(db2.open((m_dbTmpPath / "invalid").string(), config2), Db::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SavedFrontier)
+{
+  BOOST_CHECK(db.getFrontier() == nullptr);
+
+  for (NonNegativeInteger i = 0; i < 3; i++)
+    BOOST_REQUIRE(db.insertLeafData(Leaf(Name("/data").appendNumber(i), 0, i, 0)));
+
+  // a frontier which does not end at the last leaf is stale, but the leaves after it can be
+  // replayed
+  BOOST_CHECK(db.insertFrontier(Frontier(2, Node::getEmptyHash())));
+  BOOST_CHECK(db.getFrontier() == nullptr);
+  BOOST_REQUIRE(db.getLastFrontier() != nullptr);
+  BOOST_CHECK_EQUAL(db.getLastFrontier()->getNextLeafSeqNo(), 2);
+
+  Frontier frontier(3, Node::getEmptyHash());
+  frontier.addSubTree(Node::Index(0, SubTreeBinary::STEP),
+                      std::vector<Sha256Digest>(3, Node::getEmptyHash()));
+  BOOST_CHECK(db.insertFrontier(frontier));
+  auto frontier2 = db.getFrontier();
+  BOOST_REQUIRE(frontier2 != nullptr);
+  BOOST_CHECK(frontier2->wireEncode() == frontier.wireEncode());
+
+  {
+    Db db2;
+    db2.open(m_dbTmpPath.string());
+    BOOST_CHECK(db2.getFrontier() != nullptr);
+  }
+
+  // the frontier is stale once a leaf is appended after it
+  BOOST_REQUIRE(db.insertLeafData(Leaf(Name("/data").appendNumber(3), 0, 3, 0)));
+  BOOST_CHECK(db.getFrontier() == nullptr);
+
+  // so the next seqNo comes from the leaves on open
+  Db db3;
+  db3.open(m_dbTmpPath.string());
+  BOOST_CHECK(db3.getFrontier() == nullptr);
+  BOOST_CHECK(db3.getLastFrontier() != nullptr);
+  BOOST_CHECK(!db3.insertLeafData(Leaf(Name("/data").appendNumber(3), 0, 3, 0)));
+  BOOST_CHECK(db3.insertLeafData(Leaf(Name("/data").appendNumber(4), 0, 4, 0)));
+
+  // a frontier ahead of the leaves does not belong to them
+  BOOST_CHECK(db3.insertFrontier(Frontier(6, Node::getEmptyHash())));
+  BOOST_CHECK(db3.getLastFrontier() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(RunInTransaction)
+{
+  ndn::DigestSha256 sig;
+  Data pending1(Name("/logger/tree/5/0/1/digest"));
+  pending1.setSignature(sig);
+  pending1.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+  Data pending2(Name("/logger/tree/10/0/1/digest"));
+  pending2.setSignature(sig);
+  pending2.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  // the writes are committed together on return
+  db.runInTransaction([&] {
+      BOOST_CHECK(db.hasPendingCommit());
+      db.insertSubTreeData(5, 0, pending1, false, 1);
+      db.insertSubTreeData(10, 0, pending2, false, 1);
+    });
+  BOOST_CHECK(!db.hasPendingCommit());
+  BOOST_CHECK_EQUAL(db.getPendingSubTrees().size(), 2);
+
+  // or not at all
+  BOOST_CHECK_THROW(db.runInTransaction([&] {
+                        db.insertSubTreeData(5, 32, pending1, false, 33);
+                        throw Db::Error("failure");
+                      }),
+                    Db::Error);
+  BOOST_CHECK(!db.hasPendingCommit());
+  BOOST_CHECK(db.getSubTreeData(5, 32) == nullptr);
+
+  // the writes join an open group
+  conf::ConfigSection config;
+  config.put("group-commit-size", "4");
+  Db groupDb;
+  groupDb.open((m_dbTmpPath / "group").string(), config);
+  BOOST_REQUIRE(groupDb.insertLeafData(Leaf(Name("/data/0"), 0, 0, 0)));
+  BOOST_REQUIRE(groupDb.hasPendingCommit());
+  groupDb.runInTransaction([&] { groupDb.insertSubTreeData(5, 0, pending1, false, 1); });
+  BOOST_CHECK(groupDb.hasPendingCommit());
+  groupDb.commit();
+  BOOST_CHECK_EQUAL(groupDb.getPendingSubTrees().size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frontier.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestFrontier)
+
+static Sha256Digest
+makeHash(size_t i)
+{
+  Sha256Digest hash;
+  hash.fill(static_cast<uint8_t>(i));
+  return hash;
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  Frontier frontier1(1025, makeHash(1));
+  frontier1.addSubTree(Node::Index(0, 15), {makeHash(2)});
+  frontier1.addSubTree(Node::Index(1024, 10), {});
+  frontier1.addSubTree(Node::Index(1024, 5), {makeHash(3)});
+
+  Frontier frontier2;
+  frontier2.wireDecode(frontier1.wireEncode());
+  BOOST_CHECK_EQUAL(frontier2.getNextLeafSeqNo(), 1025);
+  BOOST_CHECK(frontier2.getRootHash() == makeHash(1));
+
+  const auto& subTrees = frontier2.getSubTrees();
+  BOOST_REQUIRE_EQUAL(subTrees.size(), 3);
+  BOOST_CHECK(subTrees[0].peakIndex == Node::Index(0, 15));
+  BOOST_REQUIRE_EQUAL(subTrees[0].leafHashes.size(), 1);
+  BOOST_CHECK(subTrees[0].leafHashes[0] == makeHash(2));
+  BOOST_CHECK(subTrees[1].peakIndex == Node::Index(1024, 10));
+  BOOST_CHECK(subTrees[1].leafHashes.empty());
+  BOOST_CHECK(subTrees[2].peakIndex == Node::Index(1024, 5));
+  BOOST_REQUIRE_EQUAL(subTrees[2].leafHashes.size(), 1);
+  BOOST_CHECK(subTrees[2].leafHashes[0] == makeHash(3));
+
+  BOOST_CHECK(frontier2.wireEncode() == frontier1.wireEncode());
+
+  // the wire format is cached until the frontier changes
+  frontier2.addSubTree(Node::Index(1024, 0), {});
+  Frontier frontier3;
+  frontier3.wireDecode(frontier2.wireEncode());
+  BOOST_CHECK_EQUAL(frontier3.getSubTrees().size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(Checksum)
+{
+  Frontier frontier1(33, makeHash(1));
+  frontier1.addSubTree(Node::Index(0, 10), {makeHash(2)});
+  frontier1.addSubTree(Node::Index(32, 5), {makeHash(3)});
+
+  const Block& wire = frontier1.wireEncode();
+
+  // flip one bit of the last leaf hash, the structure is still valid but the checksum is not
+  Buffer corrupted(wire.wire(), wire.size());
+  corrupted[corrupted.size() - 1] ^= 0x01;
+
+  Frontier frontier2;
+  BOOST_CHECK_THROW(frontier2.wireDecode(Block(corrupted.buf(), corrupted.size())),
+                    Frontier::Error);
+  BOOST_CHECK_THROW(frontier2.wireDecode(Block(tlv::Content)), Frontier::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -119,8 +119,8 @@ BOOST_AUTO_TEST_CASE(Encoding)
   BOOST_CHECK_EQUAL_COLLECTIONS(block.wire(), block.wire() + block.size(),
                                 LEAF_BLOCK, LEAF_BLOCK + sizeof(LEAF_BLOCK));
 
-  ndn::ConstBufferPtr hash = leaf.getHash();
-  BOOST_CHECK_EQUAL_COLLECTIONS(hash->begin(), hash->end(),
+  Sha256Digest hash = leaf.getHash();
+  BOOST_CHECK_EQUAL_COLLECTIONS(hash.begin(), hash.end(),
                                 LEAF_HASH, LEAF_HASH + sizeof(LEAF_HASH));
 
   auto data = leaf.encode();
@@ -147,12 +147,34 @@ BOOST_AUTO_TEST_CASE(Decoding)
   BOOST_CHECK_EQUAL(leaf.getDataSeqNo(), 2);
   BOOST_CHECK_EQUAL(leaf.getSignerSeqNo(), 1);
 
-  ndn::ConstBufferPtr hash = leaf.getHash();
-  BOOST_CHECK_EQUAL_COLLECTIONS(hash->begin(), hash->end(),
+  Sha256Digest hash = leaf.getHash();
+  BOOST_CHECK_EQUAL_COLLECTIONS(hash.begin(), hash.end(),
                                 LEAF_HASH, LEAF_HASH + sizeof(LEAF_HASH));
 }
 
 
+BOOST_AUTO_TEST_CASE(EncodingRow)
+{
+  Name dataName("/test/data");
+  const Block& dataNameWire = dataName.wireEncode();
+
+  // values on 1, 2, 4 and 8 bytes
+  std::vector<uint8_t> buffer;
+  for (NonNegativeInteger value : {0ULL, 0xFFULL, 0x100ULL, 0x10000ULL, 0x100000000ULL}) {
+    Leaf leaf(dataName, value + 1, value + 2, value);
+    Leaf::wireEncodeRow(buffer, dataNameWire.wire(), dataNameWire.size(),
+                        value + 1, value + 2, value);
+
+    const Block& wire = leaf.wireEncode();
+    BOOST_CHECK_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                  wire.wire(), wire.wire() + wire.size());
+  }
+
+  Leaf::wireEncodeRow(buffer, dataNameWire.wire(), dataNameWire.size(), 0, 2, 1);
+  BOOST_CHECK_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                LEAF_BLOCK, LEAF_BLOCK + sizeof(LEAF_BLOCK));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -22,6 +22,8 @@
 #include "logger-response.hpp"
 #include "cryptopp.hpp"
 
+#include <ndn-cxx/security/digest-sha256.hpp>
+
 #include "boost-test.hpp"
 
 namespace ndn {
@@ -97,6 +99,78 @@ BOOST_AUTO_TEST_CASE(Decoding)
   BOOST_CHECK_EQUAL(response2.getMsg(), "error");
 }
 
+uint8_t RESPONSE3[] = {
+  0x90, 0x10,
+    0x91, 0x01, 0x00,
+    0x82, 0x01, 0x05,
+    0x91, 0x01, 0x01,
+    0x92, 0x05, 0x65, 0x72, 0x72, 0x6f, 0x72
+};
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+  LoggerResponse response1;
+  BOOST_CHECK_EQUAL(response1.getNEntries(), 0);
+  BOOST_CHECK_THROW(response1.getCode(), LoggerResponse::Error);
+
+  response1.addEntry(5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(response1.wireEncode().wire(),
+                                response1.wireEncode().wire() + response1.wireEncode().size(),
+                                RESPONSE1, RESPONSE1 + sizeof(RESPONSE1));
+
+  response1.addEntry(1, "error");
+  BOOST_CHECK_EQUAL(response1.getNEntries(), 2);
+  BOOST_CHECK_EQUAL_COLLECTIONS(response1.wireEncode().wire(),
+                                response1.wireEncode().wire() + response1.wireEncode().size(),
+                                RESPONSE3, RESPONSE3 + sizeof(RESPONSE3));
+
+  LoggerResponse response2;
+  Block block(RESPONSE3, sizeof(RESPONSE3));
+  BOOST_REQUIRE_NO_THROW(response2.wireDecode(block));
+  BOOST_REQUIRE_EQUAL(response2.getNEntries(), 2);
+  BOOST_CHECK_EQUAL(response2.getCode(0), 0);
+  BOOST_CHECK_EQUAL(response2.getDataSeqNo(0), 5);
+  BOOST_CHECK_EQUAL(response2.getCode(1), 1);
+  BOOST_CHECK_EQUAL(response2.getMsg(1), "error");
+  BOOST_CHECK_THROW(response2.getDataSeqNo(1), LoggerResponse::Error);
+  BOOST_CHECK_THROW(response2.getCode(2), LoggerResponse::Error);
+}
+BOOST_AUTO_TEST_CASE(BatchProof)
+{
+  Sha256Digest rootHash;
+  rootHash.fill(1);
+  Data root(Name("/logger/batch").append(rootHash.data(), rootHash.size()));
+  root.setContent(rootHash.data(), rootHash.size());
+  ndn::DigestSha256 sig;
+  root.setSignature(sig);
+  root.setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+
+  std::vector<Sha256Digest> path(2);
+  path[0].fill(2);
+  path[1].fill(3);
+
+  LoggerResponse response1(5);
+  response1.addEntry(1, "error");
+  BOOST_CHECK(!response1.hasBatchProof());
+  Sha256Digest leafHash = response1.computeBatchLeafHash(Name("/logger/log/request"));
+  BOOST_CHECK(leafHash != response1.computeBatchLeafHash(Name("/logger/log/other")));
+
+  // the proof is not covered by the leaf hash
+  response1.setBatchProof(3, path, root);
+  BOOST_CHECK(response1.hasBatchProof());
+  BOOST_CHECK(response1.computeBatchLeafHash(Name("/logger/log/request")) == leafHash);
+
+  LoggerResponse response2;
+  BOOST_REQUIRE_NO_THROW(response2.wireDecode(response1.wireEncode()));
+  BOOST_REQUIRE_EQUAL(response2.getNEntries(), 2);
+  BOOST_CHECK_EQUAL(response2.getDataSeqNo(0), 5);
+  BOOST_CHECK_EQUAL(response2.getMsg(1), "error");
+  BOOST_REQUIRE(response2.hasBatchProof());
+  BOOST_CHECK_EQUAL(response2.getBatchIndex(), 3);
+  BOOST_CHECK(response2.getBatchPath() == path);
+  BOOST_CHECK(response2.getBatchRoot()->wireEncode() == root.wireEncode());
+  BOOST_CHECK(response2.computeBatchLeafHash(Name("/logger/log/request")) == leafHash);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -20,11 +20,17 @@
  */
 
 #include "logger.hpp"
+#include "auditor.hpp"
+#include "tlv.hpp"
 #include "identity-fixture.hpp"
 #include "db-fixture.hpp"
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <ndn-cxx/util/io.hpp>
 
+#include <sqlite3.h>
+
+#include <thread>
+
 #include "boost-test.hpp"
 
 namespace ndn {
@@ -271,6 +277,10 @@ BOOST_AUTO_TEST_CASE(Basic)
   BOOST_CHECK(leafResult1.first != nullptr);
   BOOST_CHECK(leafResult1.second != nullptr);
 
+  // the signer is looked up once per request
+  BOOST_CHECK_EQUAL(logger.getSignerCache().getNMisses(), 1);
+  BOOST_CHECK_EQUAL(logger.getSignerCache().getNHits(), 0);
+
 
 
   Name leafInterestName2("/test/logger/leaf");
@@ -326,6 +336,668 @@ BOOST_AUTO_TEST_CASE(Basic)
   BOOST_CHECK(leafResult2.first != nullptr);
   BOOST_CHECK(leafResult2.second == nullptr);
 
+  Name rangeInterestName("/test/logger/leaves");
+  rangeInterestName.appendNumber(0).appendNumber(3);
+  face1.receive(Interest(rangeInterestName));
+  advanceClocks(time::milliseconds(2), 100);
+
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 1);
+  const Data& rangeData = face1.sentData[0];
+  BOOST_CHECK_EQUAL(rangeData.getName(), Name(rangeInterestName).appendSegment(0));
+  BOOST_CHECK_EQUAL(rangeData.getFinalBlockId(), ndn::name::Component::fromSegment(0));
+
+  Block rangeContent = rangeData.getContent();
+  rangeContent.parse();
+  BOOST_REQUIRE_EQUAL(rangeContent.elements_size(), 3);
+  for (size_t i = 0; i < 3; i++) {
+    Leaf leaf;
+    leaf.wireDecode(rangeContent.elements()[i]);
+    BOOST_CHECK_EQUAL(leaf.getDataSeqNo(), i);
+    BOOST_CHECK(leaf.getHash() == logger.getDb().getLeaf(i).first->getHash());
+  }
+  clear();
+
+  // ranges beyond the log are not answered
+  Name rangeInterestName2("/test/logger/leaves");
+  rangeInterestName2.appendNumber(0).appendNumber(4);
+  face1.receive(Interest(rangeInterestName2));
+  advanceClocks(time::milliseconds(2), 100);
+
+  BOOST_CHECK_EQUAL(face1.sentData.size(), 0);
+  clear();
+
+  Name proofInterestName("/test/logger/proof/existence");
+  proofInterestName.appendNumber(1).appendNumber(3);
+  face1.receive(Interest(proofInterestName));
+  advanceClocks(time::milliseconds(2), 100);
+
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 1);
+  const Data& proofData = face1.sentData[0];
+  BOOST_CHECK_EQUAL(proofData.getName(), Name(proofInterestName).appendSegment(0));
+  BOOST_CHECK_EQUAL(proofData.getFinalBlockId(), ndn::name::Component::fromSegment(0));
+
+  std::vector<shared_ptr<Data>> proof;
+  BOOST_REQUIRE(Auditor::loadProofBundle(proofData.getContent(), proof));
+  BOOST_REQUIRE_EQUAL(proof.size(), 1);
+  BOOST_CHECK(logger.getTreePrefix().isPrefixOf(proof[0]->getName()));
+  BOOST_CHECK(Auditor::doesExist(1, logger.getDb().getLeaf(1).first->getHash(),
+                                 3, logger.getMerkleTree().getRootHash(),
+                                 proof, logger.getTreePrefix()));
+  clear();
+
+  // proofs for trees beyond the log are not answered
+  Name proofInterestName2("/test/logger/proof/consistency");
+  proofInterestName2.appendNumber(1).appendNumber(4);
+  face1.receive(Interest(proofInterestName2));
+  advanceClocks(time::milliseconds(2), 100);
+
+  BOOST_CHECK_EQUAL(face1.sentData.size(), 0);
+  clear();
+
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(Batch)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG;
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  Logger logger(face1, configPath.string());
+  advanceClocks(time::milliseconds(2), 100);
+
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 0);
+
+  Name tld("/ndn/tld");
+  Name tldKeyName = m_keyChain.generateRsaKeyPair(tld);
+  std::vector<ndn::CertificateSubjectDescription> subjectDescription;
+  auto tldCert =
+    m_keyChain.prepareUnsignedIdentityCertificate(tldKeyName, root,
+                                                  time::system_clock::now(),
+                                                  time::system_clock::now() + time::days(1),
+                                                  subjectDescription);
+  m_keyChain.signByIdentity(*tldCert, root);
+  m_keyChain.addCertificate(*tldCert);
+
+  auto data1 = make_shared<Data>(Name("/ndn/tld/data1"));
+  m_keyChain.sign(*data1, tldCert->getName());
+  auto data2 = make_shared<Data>(Name("/ndn/tld/data2"));
+  m_keyChain.sign(*data2, tldCert->getName());
+
+  auto serve = [this] (const Name& prefix, shared_ptr<Data> data) {
+    face2.setInterestFilter(prefix,
+      [this, data] (const ndn::InterestFilter&, const Interest&) { face2.put(*data); },
+      ndn::RegisterPrefixSuccessCallback(),
+      [] (const Name&, const std::string&) {});
+  };
+  serve(tldCert->getName().getPrefix(-1), tldCert);
+  serve(data1->getName(), data1);
+  serve(data2->getName(), data2);
+  advanceClocks(time::milliseconds(2), 100);
+  clear();
+
+  // a single Data name gets a single entry response
+  Name logInterestName("/test/logger/log");
+  logInterestName.append(tldCert->getFullName().wireEncode());
+  logInterestName.appendNumber(0);
+  auto logInterest = make_shared<Interest>(logInterestName);
+  m_keyChain.sign(*logInterest, tldCert->getName());
+
+  face1.receive(*logInterest);
+  do {
+    advanceClocks(time::milliseconds(2), 100);
+  } while (passPacket());
+
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 1);
+  LoggerResponse response1;
+  response1.wireDecode(face1.sentData[0].getContent().blockFromValue());
+  BOOST_REQUIRE_EQUAL(response1.getNEntries(), 1);
+  BOOST_CHECK_EQUAL(response1.getDataSeqNo(), 1);
+  clear();
+
+  // nobody serves the second Data of the batch
+  Block dataNameList(tlv::DataNameList);
+  dataNameList.push_back(data1->getName().wireEncode());
+  dataNameList.push_back(Name("/ndn/tld/missing").wireEncode());
+  dataNameList.push_back(data2->getName().wireEncode());
+  dataNameList.encode();
+
+  Name batchInterestName("/test/logger/log");
+  batchInterestName.append(dataNameList);
+  batchInterestName.appendNumber(1);
+  auto batchInterest = make_shared<Interest>(batchInterestName);
+  m_keyChain.sign(*batchInterest, tldCert->getName());
+
+  face1.receive(*batchInterest);
+  do {
+    advanceClocks(time::milliseconds(2), 100);
+  } while (passPacket());
+  BOOST_CHECK_EQUAL(face1.sentData.size(), 0);
+
+  // the batch is answered once the missing Data has timed out
+  advanceClocks(time::milliseconds(100), 200);
+  passPacket();
+
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face1.sentData[0].getName(), batchInterest->getName());
+  LoggerResponse response2;
+  response2.wireDecode(face1.sentData[0].getContent().blockFromValue());
+  BOOST_REQUIRE_EQUAL(response2.getNEntries(), 3);
+  BOOST_CHECK_EQUAL(response2.getCode(0), tlv::LogResponse_Accept);
+  BOOST_CHECK_EQUAL(response2.getCode(1), tlv::LogResponse_Error_Fetch);
+  BOOST_CHECK_EQUAL(response2.getCode(2), tlv::LogResponse_Accept);
+
+  // both Data are logged, under the seqNo their entries report
+  BOOST_CHECK_EQUAL(logger.getDb().getMaxLeafSeq(), 4);
+  std::set<NonNegativeInteger> seqNos{response2.getDataSeqNo(0), response2.getDataSeqNo(2)};
+  BOOST_CHECK(seqNos == (std::set<NonNegativeInteger>{2, 3}));
+  for (size_t i : {0, 2}) {
+    const Data& data = i == 0 ? *data1 : *data2;
+    auto leaf = logger.getDb().getLeaf(response2.getDataSeqNo(i)).first;
+    BOOST_REQUIRE(leaf != nullptr);
+    BOOST_CHECK_EQUAL(leaf->getDataName(), data.getFullName());
+  }
+  BOOST_CHECK_EQUAL(logger.getPipelineStatus().nPendingRequests, 0);
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(SignBatch)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG
+     << "pipeline                                             \n"
+     << "{                                                    \n"
+     << "  sign-batch-window 10                               \n"
+     << "}                                                    \n";
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  Logger logger(face1, configPath.string());
+  advanceClocks(time::milliseconds(2), 100);
+
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 0);
+
+  std::vector<shared_ptr<Interest>> logInterests;
+  for (const std::string& name : {"/ndn/data1", "/ndn/data2"}) {
+    auto data = make_shared<Data>(Name(name));
+    m_keyChain.sign(*data, rootCert->getName());
+    face2.setInterestFilter(data->getName(),
+      [this, data] (const ndn::InterestFilter&, const Interest&) { face2.put(*data); },
+      ndn::RegisterPrefixSuccessCallback(),
+      [] (const Name&, const std::string&) {});
+
+    Name logInterestName("/test/logger/log");
+    logInterestName.append(data->getFullName().wireEncode());
+    logInterestName.appendNumber(0);
+    auto logInterest = make_shared<Interest>(logInterestName);
+    m_keyChain.sign(*logInterest, rootCert->getName());
+    logInterests.push_back(logInterest);
+  }
+  advanceClocks(time::milliseconds(2), 100);
+  clear();
+
+  // both responses are ready within the window, and share the signed root of their batch
+  for (const auto& logInterest : logInterests)
+    face1.receive(*logInterest);
+  do {
+    advanceClocks(time::milliseconds(2), 100);
+  } while (passPacket());
+
+  BOOST_CHECK_EQUAL(logger.getDb().getMaxLeafSeq(), 3);
+  BOOST_CHECK_EQUAL(logger.getPipelineStatus().nBatchQueued, 0);
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 2);
+
+  const ndn::PublicKey& key = logger.getDskCertificate()->getPublicKeyInfo();
+  std::vector<LoggerResponse> responses(2);
+  for (size_t i = 0; i < 2; i++) {
+    BOOST_CHECK(Auditor::isResponseAuthentic(face1.sentData[i], key, responses[i]));
+    BOOST_REQUIRE(responses[i].hasBatchProof());
+    BOOST_CHECK_EQUAL(responses[i].getCode(), tlv::LogResponse_Accept);
+    BOOST_CHECK(logger.getLoggerName().isPrefixOf(responses[i].getBatchRoot()->getName()));
+  }
+  BOOST_CHECK_EQUAL(responses[0].getBatchRoot()->getName(),
+                    responses[1].getBatchRoot()->getName());
+  BOOST_CHECK_NE(responses[0].getBatchIndex(), responses[1].getBatchIndex());
+
+  // the proof of a response does not cover another one
+  Data forged(face1.sentData[0].getName());
+  forged.setContent(face1.sentData[1].getContent());
+  m_keyChain.signWithSha256(forged);
+  LoggerResponse forgedResponse;
+  BOOST_CHECK(!Auditor::isResponseAuthentic(forged, key, forgedResponse));
+
+  // the root is signed by the logger only
+  BOOST_CHECK(!Auditor::isResponseAuthentic(face1.sentData[0], rootCert->getPublicKeyInfo(),
+                                            forgedResponse));
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(Pipeline)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG
+     << "pipeline                                             \n"
+     << "{                                                    \n"
+     << "  verify-threads 2                                   \n"
+     << "  sign-threads 1                                     \n"
+     << "  max-pending-requests 1                             \n"
+     << "}                                                    \n";
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  Logger logger(face1, configPath.string());
+  advanceClocks(time::milliseconds(2), 100);
+
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 0);
+
+  Name tld("/ndn/tld");
+  Name tldKeyName = m_keyChain.generateRsaKeyPair(tld);
+  std::vector<ndn::CertificateSubjectDescription> subjectDescription;
+  auto tldCert =
+    m_keyChain.prepareUnsignedIdentityCertificate(tldKeyName, root,
+                                                  time::system_clock::now(),
+                                                  time::system_clock::now() + time::days(1),
+                                                  subjectDescription);
+  m_keyChain.signByIdentity(*tldCert, root);
+  m_keyChain.addCertificate(*tldCert);
+
+  face2.setInterestFilter(tldCert->getName().getPrefix(-1),
+    [&] (const ndn::InterestFilter&, const Interest&) { face2.put(*tldCert); },
+    ndn::RegisterPrefixSuccessCallback(),
+    [] (const Name&, const std::string&) {});
+  advanceClocks(time::milliseconds(2), 100);
+  clear();
+
+  // the pipeline threads post their results back to the face, which has to be polled meanwhile
+  auto pollUntil = [&] (const function<bool()>& isDone) {
+    for (size_t i = 0; i < 2000 && !isDone(); i++) {
+      advanceClocks(time::milliseconds(2), 1);
+      passPacket();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return isDone();
+  };
+
+  Name logInterestName("/test/logger/log");
+  logInterestName.append(tldCert->getFullName().wireEncode());
+  logInterestName.appendNumber(0);
+  auto logInterest = make_shared<Interest>(logInterestName);
+  m_keyChain.sign(*logInterest, tldCert->getName());
+
+  face1.receive(*logInterest);
+  BOOST_REQUIRE(pollUntil([&] {
+        for (const auto& data : face1.sentData) {
+          if (data.getName() == logInterest->getName())
+            return true;
+        }
+        return false;
+      }));
+  clear();
+
+  BOOST_CHECK_EQUAL(logger.getDb().getMaxLeafSeq(), 2);
+  BOOST_CHECK(logger.getDb().getLeaf(1).second != nullptr);
+
+  Logger::PipelineStatus status = logger.getPipelineStatus();
+  BOOST_CHECK_EQUAL(status.nPendingRequests, 0);
+  BOOST_CHECK_EQUAL(status.nVerifyQueued, 0);
+  BOOST_CHECK_EQUAL(status.nAppendQueued, 0);
+  BOOST_CHECK_EQUAL(status.nCommitQueued, 0);
+  BOOST_CHECK_EQUAL(status.nSignQueued, 0);
+  BOOST_CHECK_EQUAL(status.nRejectedRequests, 0);
+  BOOST_CHECK_EQUAL(status.nFailedCommits, 0);
+  BOOST_CHECK_EQUAL(status.nFailedCheckpoints, 0);
+
+  // nobody serves this Data, so the first request stays in the pipeline until it times out
+  Name logInterestName2("/test/logger/log");
+  logInterestName2.append(Name("/ndn/tld/data").wireEncode());
+  logInterestName2.appendNumber(1);
+  auto logInterest2 = make_shared<Interest>(logInterestName2);
+  m_keyChain.sign(*logInterest2, tldCert->getName());
+
+  face1.receive(*logInterest2);
+  BOOST_REQUIRE(pollUntil([&] { return logger.getPipelineStatus().nPendingRequests == 1; }));
+
+  auto logInterest3 = make_shared<Interest>(logInterestName2);
+  m_keyChain.sign(*logInterest3, tldCert->getName());
+
+  face1.receive(*logInterest3);
+  BOOST_CHECK(pollUntil([&] { return logger.getPipelineStatus().nRejectedRequests == 1; }));
+  BOOST_CHECK_EQUAL(logger.getPipelineStatus().nPendingRequests, 1);
+
+  // the rejected request is told to back off
+  BOOST_REQUIRE_EQUAL(face1.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face1.sentData[0].getName(), logInterest3->getName());
+  LoggerResponse busyResponse;
+  busyResponse.wireDecode(face1.sentData[0].getContent().blockFromValue());
+  BOOST_REQUIRE_EQUAL(busyResponse.getNEntries(), 1);
+  BOOST_CHECK_EQUAL(busyResponse.getCode(0), tlv::LogResponse_Error_Busy);
+  clear();
+
+  advanceClocks(time::milliseconds(100), 200);
+  BOOST_CHECK_EQUAL(logger.getPipelineStatus().nPendingRequests, 0);
+  BOOST_CHECK_EQUAL(logger.getDb().getMaxLeafSeq(), 2);
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentVerification)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG
+     << "pipeline                                             \n"
+     << "{                                                    \n"
+     << "  verify-threads 2                                   \n"
+     << "}                                                    \n";
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  Logger logger(face1, configPath.string());
+  advanceClocks(time::milliseconds(2), 100);
+
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 0);
+
+  Name tld("/ndn/tld");
+  Name tldKeyName = m_keyChain.generateRsaKeyPair(tld);
+  std::vector<ndn::CertificateSubjectDescription> subjectDescription;
+  auto tldCert =
+    m_keyChain.prepareUnsignedIdentityCertificate(tldKeyName, root,
+                                                  time::system_clock::now(),
+                                                  time::system_clock::now() + time::days(1),
+                                                  subjectDescription);
+  m_keyChain.signByIdentity(*tldCert, root);
+  m_keyChain.addCertificate(*tldCert);
+
+  // the signature of the third Data is broken, the last one is out of the namespace of its key
+  std::vector<shared_ptr<Data>> dataList;
+  for (const std::string& name : {"/ndn/tld/data1", "/ndn/tld/data2", "/ndn/tld/data3",
+                                  "/ndn/tld/data4", "/ndn/other/data5"}) {
+    auto data = make_shared<Data>(Name(name));
+    m_keyChain.sign(*data, tldCert->getName());
+    dataList.push_back(data);
+  }
+  dataList[2]->setContent(reinterpret_cast<const uint8_t*>("forged"), 6);
+
+  auto serve = [this] (const Name& prefix, shared_ptr<Data> data) {
+    face2.setInterestFilter(prefix,
+      [this, data] (const ndn::InterestFilter&, const Interest&) { face2.put(*data); },
+      ndn::RegisterPrefixSuccessCallback(),
+      [] (const Name&, const std::string&) {});
+  };
+  serve(tldCert->getName().getPrefix(-1), tldCert);
+
+  Block dataNameList(tlv::DataNameList);
+  for (const auto& data : dataList) {
+    serve(data->getName(), data);
+    dataNameList.push_back(data->getFullName().wireEncode());
+  }
+  dataNameList.encode();
+  advanceClocks(time::milliseconds(2), 100);
+  clear();
+
+  auto pollUntil = [&] (const function<bool()>& isDone) {
+    for (size_t i = 0; i < 2000 && !isDone(); i++) {
+      advanceClocks(time::milliseconds(2), 1);
+      passPacket();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return isDone();
+  };
+
+  auto findResponse = [&] (const Interest& interest) -> const Data* {
+    for (const auto& data : face1.sentData) {
+      if (data.getName() == interest.getName())
+        return &data;
+    }
+    return nullptr;
+  };
+
+  Name certInterestName("/test/logger/log");
+  certInterestName.append(tldCert->getFullName().wireEncode());
+  certInterestName.appendNumber(0);
+  auto certInterest = make_shared<Interest>(certInterestName);
+  m_keyChain.sign(*certInterest, tldCert->getName());
+
+  face1.receive(*certInterest);
+  BOOST_REQUIRE(pollUntil([&] { return findResponse(*certInterest) != nullptr; }));
+  clear();
+
+  // the Data are verified on both threads at once, while the rules are matched on the face
+  Name logInterestName("/test/logger/log");
+  logInterestName.append(dataNameList);
+  logInterestName.appendNumber(1);
+  auto logInterest = make_shared<Interest>(logInterestName);
+  m_keyChain.sign(*logInterest, tldCert->getName());
+
+  face1.receive(*logInterest);
+  BOOST_REQUIRE(pollUntil([&] { return findResponse(*logInterest) != nullptr; }));
+
+  const Data* responseData = findResponse(*logInterest);
+  LoggerResponse response;
+  response.wireDecode(responseData->getContent().blockFromValue());
+  BOOST_REQUIRE_EQUAL(response.getNEntries(), 5);
+  BOOST_CHECK_EQUAL(response.getCode(0), tlv::LogResponse_Accept);
+  BOOST_CHECK_EQUAL(response.getCode(1), tlv::LogResponse_Accept);
+  BOOST_CHECK_EQUAL(response.getCode(2), tlv::LogResponse_Error_Policy);
+  BOOST_CHECK_EQUAL(response.getCode(3), tlv::LogResponse_Accept);
+  BOOST_CHECK_EQUAL(response.getCode(4), tlv::LogResponse_Error_Policy);
+
+  // only the accepted Data are logged
+  BOOST_CHECK_EQUAL(logger.getDb().getMaxLeafSeq(), 5);
+  std::set<NonNegativeInteger> seqNos{response.getDataSeqNo(0), response.getDataSeqNo(1),
+                                      response.getDataSeqNo(3)};
+  BOOST_CHECK(seqNos == (std::set<NonNegativeInteger>{2, 3, 4}));
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(Checkpoint)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+
+  // leaves appended after the last checkpoint, as if the logger had crashed
+  std::vector<Sha256Digest> leafHashes;
+  {
+    Db crashedDb;
+    crashedDb.open(TEST_LOGGER_PATH);
+    for (NonNegativeInteger i = 0; i < 40; i++) {
+      Leaf leaf(Name("/ndn/data").appendNumber(i), 0, i, 0);
+      BOOST_REQUIRE(crashedDb.insertLeafData(leaf));
+      leafHashes.push_back(leaf.getHash());
+    }
+  }
+  MerkleTree expectedTree(Name("/test/logger/tree"), db);
+  BOOST_REQUIRE(expectedTree.addLeaves(0, leafHashes));
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG
+     << "pipeline                                             \n"
+     << "{                                                    \n"
+     << "  checkpoint-interval 2                              \n"
+     << "  checkpoint-period 100                              \n"
+     << "}                                                    \n";
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  // the leaves are replayed and saved on start
+  Logger logger(face1, configPath.string());
+  const MerkleTree& tree = logger.getMerkleTree();
+  BOOST_CHECK_EQUAL(tree.getNextLeafSeqNo(), 40);
+  BOOST_CHECK(tree.getRootHash() == expectedTree.getRootHash());
+  BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 0);
+  BOOST_CHECK(logger.getDb().getFrontier() != nullptr);
+
+  advanceClocks(time::milliseconds(2), 100);
+
+  // a single leaf is saved once the checkpoint period is over
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 40);
+  BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 1);
+  BOOST_CHECK(logger.getDb().getFrontier() == nullptr);
+
+  advanceClocks(time::milliseconds(10), 20);
+  BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 0);
+  BOOST_CHECK(logger.getDb().getFrontier() != nullptr);
+
+  // two leaves reach the checkpoint interval
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 41);
+  BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 1);
+  BOOST_CHECK_EQUAL(logger.addSelfSignedCert(*rootCert, rootTs), 42);
+  BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 0);
+  BOOST_CHECK(logger.getDb().getFrontier() != nullptr);
+
+  fs::remove_all(fs::path(TEST_LOGGER_PATH));
+}
+
+BOOST_AUTO_TEST_CASE(CrashAfterCheckpoint)
+{
+  namespace fs = boost::filesystem;
+
+  fs::create_directory(fs::path(TEST_LOGGER_PATH));
+  fs::path dbPath = fs::path(TEST_LOGGER_PATH) / "sig-logger.db";
+
+  // the checkpoint is taken past the first base subtree, and the leaves after it complete the
+  // second one
+  const NonNegativeInteger nBaseLeaves = static_cast<NonNegativeInteger>(1) << SubTreeBinary::STEP;
+  const NonNegativeInteger nCheckpointLeaves = nBaseLeaves + 8;
+  const NonNegativeInteger nLeaves = 2 * nBaseLeaves + 6;
+
+  std::vector<Sha256Digest> leafHashes;
+  for (NonNegativeInteger i = 0; i < nLeaves; i++)
+    leafHashes.push_back(Leaf(Name("/ndn/data").appendNumber(i), 0, i, 0).getHash());
+  MerkleTree expectedTree(Name("/test/logger/tree"), db);
+  BOOST_REQUIRE(expectedTree.addLeaves(0, leafHashes));
+
+  sqlite3* reader = nullptr;
+  {
+    Db crashedDb;
+    crashedDb.open(TEST_LOGGER_PATH);
+    std::unique_ptr<MerkleTree> crashedTree(new MerkleTree(Name("/test/logger/tree"), crashedDb));
+
+    auto append = [&] (NonNegativeInteger first, NonNegativeInteger last) {
+      for (NonNegativeInteger i = first; i < last; i++) {
+        BOOST_REQUIRE(crashedDb.insertLeafData(Leaf(Name("/ndn/data").appendNumber(i), 0, i, 0)));
+        BOOST_REQUIRE(crashedTree->addLeaf(i, leafHashes[i]));
+      }
+    };
+
+    // the checkpoint has a root subtree above the base one
+    append(0, nCheckpointLeaves);
+    crashedTree->savePendingTree();
+
+    // the base subtree of the checkpoint is completed, which moves it from pTrees to cTrees
+    append(nCheckpointLeaves, nLeaves);
+
+    // a reader keeps the dropped tree from being saved, as if the logger had crashed
+    BOOST_REQUIRE_EQUAL(sqlite3_open(dbPath.c_str(), &reader), SQLITE_OK);
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(reader, "BEGIN; SELECT count(*) FROM leaves",
+                                     nullptr, nullptr, nullptr), SQLITE_OK);
+    crashedTree.reset();
+  }
+  sqlite3_exec(reader, "COMMIT", nullptr, nullptr, nullptr);
+  sqlite3_close(reader);
+
+  {
+    Db crashedDb;
+    crashedDb.open(TEST_LOGGER_PATH);
+    BOOST_CHECK_EQUAL(crashedDb.getMaxLeafSeq(), nLeaves);
+    BOOST_CHECK(crashedDb.getFrontier() == nullptr);
+    BOOST_REQUIRE(crashedDb.getLastFrontier() != nullptr);
+    BOOST_CHECK_EQUAL(crashedDb.getLastFrontier()->getNextLeafSeqNo(), nCheckpointLeaves);
+    BOOST_CHECK_EQUAL(crashedDb.getPendingSubTrees().size(), 1);
+  }
+
+  fs::path configPath = fs::path(TEST_LOGGER_PATH) / "logger-test.conf";
+  std::ofstream os(configPath.c_str());
+  os << CONFIG;
+  os.close();
+
+  Name root("/ndn");
+  addIdentity(root);
+  auto rootCert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(root));
+  fs::path certPath = fs::path(TEST_LOGGER_PATH) / "trust-anchor.cert";
+  ndn::io::save(*rootCert, certPath.string());
+
+  // the leaves after the checkpoint are replayed on top of its frontier
+  {
+    Logger logger(face1, configPath.string());
+    const MerkleTree& tree = logger.getMerkleTree();
+    BOOST_CHECK_EQUAL(tree.getNextLeafSeqNo(), nLeaves);
+    BOOST_CHECK(tree.getRootHash() == expectedTree.getRootHash());
+    BOOST_CHECK_EQUAL(tree.getNUnsavedLeaves(), 0);
+    BOOST_CHECK(logger.getDb().getFrontier() != nullptr);
+  }
+
+  // without a usable frontier, pending subtrees which stop above the base one are dropped and
+  // the tree is rebuilt from all the leaves
+  BOOST_REQUIRE_EQUAL(sqlite3_open(dbPath.c_str(), &reader), SQLITE_OK);
+  std::string sql = "DELETE FROM frontier; DELETE FROM pTrees WHERE level=" +
+                    std::to_string(SubTreeBinary::STEP);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(reader, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+  sqlite3_close(reader);
+
+  {
+    Logger logger(face1, configPath.string());
+    const MerkleTree& tree = logger.getMerkleTree();
+    BOOST_CHECK_EQUAL(tree.getNextLeafSeqNo(), nLeaves);
+    BOOST_CHECK(tree.getRootHash() == expectedTree.getRootHash());
+    BOOST_CHECK(logger.getDb().getFrontier() != nullptr);
+  }
 
   fs::remove_all(fs::path(TEST_LOGGER_PATH));
 }
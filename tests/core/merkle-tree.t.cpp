@@ -20,6 +20,7 @@
  */
 
 #include "merkle-tree.hpp"
+#include "auditor.hpp"
 #include "../tree-generator.hpp"
 #include "db-fixture.hpp"
 
@@ -36,7 +37,7 @@ BOOST_AUTO_TEST_CASE(Basic)
 {
   MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
   BOOST_CHECK_EQUAL(merkleTree.getNextLeafSeqNo(), 0);
-  BOOST_CHECK(merkleTree.getRootHash() == nullptr);
+  BOOST_CHECK(merkleTree.getRootHash() == Node::getEmptyHash());
 }
 
 template<NonNegativeInteger N, size_t L>
@@ -47,10 +48,10 @@ struct MerkleTreeTestParam
 };
 
 typedef boost::mpl::list<MerkleTreeTestParam<5, 3>,
-                         MerkleTreeTestParam<32, 5>,
-                         MerkleTreeTestParam<33, 6>,
-                         MerkleTreeTestParam<1024, 10>,
-                         MerkleTreeTestParam<1025, 11>> AddLeafTestParams;
+                         MerkleTreeTestParam<N_LEAVES_1, STEP>,
+                         MerkleTreeTestParam<N_LEAVES_1 + 1, STEP + 1>,
+                         MerkleTreeTestParam<N_LEAVES_2, 2 * STEP>,
+                         MerkleTreeTestParam<N_LEAVES_2 + 1, 2 * STEP + 1>> AddLeafTestParams;
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(AddLeaf, T, AddLeafTestParams)
 {
@@ -67,10 +68,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(AddLeaf, T, AddLeafTestParams)
   auto hash1 = TreeGenerator::getHash(Node::Index(0, rootLevel), leafNo);
   auto hash2 = merkleTree.getRootHash();
 
-  BOOST_REQUIRE(hash1 != nullptr);
-  BOOST_REQUIRE(hash2 != nullptr);
-
-  BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
 }
 
 class MerkleTreeLoadTestParam1
@@ -80,8 +78,8 @@ public:
   insertData(Db& db)
   {
     // partial first sub-tree
-    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 5);
-    db.insertSubTreeData(5, 0, *subtree1->encode(), false, 5);
+    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), 5);
+    db.insertSubTreeData(STEP, 0, *subtree1->encode(), false, 5);
   }
 
   const NonNegativeInteger seqNo = 0;
@@ -96,28 +94,28 @@ public:
   insertData(Db& db)
   {
     // full first sub-tree
-    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32);
+    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1);
     auto subtree1Data = subtree1->encode();
-    db.insertSubTreeData(5, 0, *subtree1Data);
+    db.insertSubTreeData(STEP, 0, *subtree1Data);
 
-    auto subtree2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 32);
+    auto subtree2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), N_LEAVES_1);
     auto subtree2Data = subtree2->encode();
-    db.insertSubTreeData(10, 0, *subtree2Data, false, 32);
+    db.insertSubTreeData(2 * STEP, 0, *subtree2Data, false, N_LEAVES_1);
 
     auto subtree3 = make_shared<SubTreeBinary>(TreeGenerator::LOGGER_NAME,
-                                               Node::Index(32, 5),
+                                               Node::Index(N_LEAVES_1, STEP),
                                                [&] (const Node::Index&) {},
                                                [&] (const Node::Index&,
                                                     const NonNegativeInteger&,
-                                                    ndn::ConstBufferPtr) {});
+                                                    const Sha256Digest&) {});
     auto subtree3Data = subtree3->encode();
 
-    db.insertSubTreeData(5, 32, *subtree3Data, false, 32);
+    db.insertSubTreeData(STEP, N_LEAVES_1, *subtree3Data, false, N_LEAVES_1);
   }
 
   const NonNegativeInteger seqNo = 0;
-  const size_t level = 5;
-  const NonNegativeInteger nextLeafSeqNo = 32;
+  const size_t level = STEP;
+  const NonNegativeInteger nextLeafSeqNo = N_LEAVES_1;
 };
 
 class MerkleTreeLoadTestParam3
@@ -126,22 +124,24 @@ public:
   void
   insertData(Db& db)
   {
-    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, 15), 1025);
+    auto subtree1 = TreeGenerator::getSubTreeBinary(Node::Index(0, 3 * STEP), N_LEAVES_2 + 1);
     auto subtree1Data = subtree1->encode();
-    db.insertSubTreeData(15, 0, *subtree1Data, false, 1025);
+    db.insertSubTreeData(3 * STEP, 0, *subtree1Data, false, N_LEAVES_2 + 1);
 
-    auto subtree2 = TreeGenerator::getSubTreeBinary(Node::Index(1024, 10), 1025);
+    auto subtree2 = TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_2, 2 * STEP),
+                                                    N_LEAVES_2 + 1);
     auto subtree2Data = subtree2->encode();
-    db.insertSubTreeData(10, 1024, *subtree2Data, false, 1025);
+    db.insertSubTreeData(2 * STEP, N_LEAVES_2, *subtree2Data, false, N_LEAVES_2 + 1);
 
-    auto subtree3 = TreeGenerator::getSubTreeBinary(Node::Index(1024, 5), 1025);
+    auto subtree3 = TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_2, STEP),
+                                                    N_LEAVES_2 + 1);
     auto subtree3Data = subtree3->encode();
-    db.insertSubTreeData(5, 1024, *subtree3Data, false, 1025);
+    db.insertSubTreeData(STEP, N_LEAVES_2, *subtree3Data, false, N_LEAVES_2 + 1);
   }
 
   const NonNegativeInteger seqNo = 0;
-  const size_t level = 11;
-  const NonNegativeInteger nextLeafSeqNo = 1025;
+  const size_t level = 2 * STEP + 1;
+  const NonNegativeInteger nextLeafSeqNo = N_LEAVES_2 + 1;
 };
 
 
@@ -160,10 +160,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(DbLoad, T, DbLoadTestParams)
   auto hash1 = TreeGenerator::getHash(Node::Index(param.seqNo, param.level), param.nextLeafSeqNo);
   auto hash2 = merkleTree.getRootHash();
 
-  BOOST_REQUIRE(hash1 != nullptr);
-  BOOST_REQUIRE(hash2 != nullptr);
-
-  BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
 }
 
 BOOST_AUTO_TEST_CASE(DbSave1)
@@ -175,7 +172,7 @@ BOOST_AUTO_TEST_CASE(DbSave1)
 
   merkleTree.savePendingTree();
   auto data1 = db.getPendingSubTrees()[0];
-  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 5)->encode();
+  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), 5)->encode();
 
   BOOST_CHECK(data1->wireEncode() == data2->wireEncode());
 }
@@ -183,28 +180,28 @@ BOOST_AUTO_TEST_CASE(DbSave1)
 BOOST_AUTO_TEST_CASE(DbSave2)
 {
   MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
-  for (NonNegativeInteger i = 0; i < 32 ; i++) {
+  for (NonNegativeInteger i = 0; i < N_LEAVES_1 ; i++) {
     BOOST_REQUIRE(merkleTree.addLeaf(i, Node::getEmptyHash()));
   }
 
   merkleTree.savePendingTree();
   auto data1 = db.getPendingSubTrees()[0];
-  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 32)->encode();
+  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), N_LEAVES_1)->encode();
 
   auto data3 = db.getPendingSubTrees()[1];
   auto subtree = make_shared<SubTreeBinary>(TreeGenerator::LOGGER_NAME,
-                                            Node::Index(32, 5),
+                                            Node::Index(N_LEAVES_1, STEP),
                                             [&] (const Node::Index&) {},
                                             [&] (const Node::Index&,
                                                  const NonNegativeInteger&,
-                                                 ndn::ConstBufferPtr) {});
+                                                 const Sha256Digest&) {});
   auto data4 = subtree->encode();
 
   BOOST_CHECK(data1->wireEncode() == data2->wireEncode());
   BOOST_CHECK(data3->wireEncode() == data4->wireEncode());
 
-  auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(0, 5), 32)->encode();
-  auto dataB = db.getSubTreeData(5, 0);
+  auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(0, STEP), N_LEAVES_1)->encode();
+  auto dataB = db.getSubTreeData(STEP, 0);
 
   BOOST_CHECK(dataA->wireEncode() == dataB->wireEncode());
 }
@@ -212,38 +209,230 @@ BOOST_AUTO_TEST_CASE(DbSave2)
 BOOST_AUTO_TEST_CASE(DbSave3)
 {
   MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
-  for (NonNegativeInteger i = 0; i < 1025 ; i++) {
+  for (NonNegativeInteger i = 0; i < N_LEAVES_2 + 1 ; i++) {
     BOOST_REQUIRE(merkleTree.addLeaf(i, Node::getEmptyHash()));
   }
 
   merkleTree.savePendingTree();
 
   auto data1 = db.getPendingSubTrees()[0];
-  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 15), 1025)->encode();
+  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 3 * STEP),
+                                               N_LEAVES_2 + 1)->encode();
 
   auto data3 = db.getPendingSubTrees()[1];
-  auto data4 = TreeGenerator::getSubTreeBinary(Node::Index(1024, 10), 1025)->encode();
+  auto data4 = TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_2, 2 * STEP),
+                                               N_LEAVES_2 + 1)->encode();
 
   auto data5 = db.getPendingSubTrees()[2];
-  auto data6 = TreeGenerator::getSubTreeBinary(Node::Index(1024, 5), 1025)->encode();
+  auto data6 = TreeGenerator::getSubTreeBinary(Node::Index(N_LEAVES_2, STEP),
+                                               N_LEAVES_2 + 1)->encode();
 
   BOOST_CHECK(data1->wireEncode() == data2->wireEncode());
   BOOST_CHECK(data3->wireEncode() == data4->wireEncode());
   BOOST_CHECK(data5->wireEncode() == data6->wireEncode());
 
-  for (NonNegativeInteger i = 0; i < 1024 ; i += 32) {
-    auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(i, 5), i + 32)->encode();
-    auto dataB = db.getSubTreeData(5, i);
+  for (NonNegativeInteger i = 0; i < N_LEAVES_2; i += N_LEAVES_1) {
+    auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(i, STEP), i + N_LEAVES_1)->encode();
+    auto dataB = db.getSubTreeData(STEP, i);
 
     BOOST_CHECK(dataA->wireEncode() == dataB->wireEncode());
   }
 
-  auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(0, 10), 1024)->encode();
-  auto dataB = db.getSubTreeData(10, 0);
+  auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), N_LEAVES_2)->encode();
+  auto dataB = db.getSubTreeData(2 * STEP, 0);
 
   BOOST_CHECK(dataA->wireEncode() == dataB->wireEncode());
 }
 
+BOOST_AUTO_TEST_CASE(AddLeaves)
+{
+  MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
+
+  BOOST_CHECK(merkleTree.addLeaves(0, {}));
+  BOOST_CHECK(!merkleTree.addLeaves(1, {Node::getEmptyHash()}));
+
+  // batches across the boundaries of base subtrees and of the root subtree
+  NonNegativeInteger nextSeqNo = 0;
+  for (NonNegativeInteger batchSize :
+         std::vector<NonNegativeInteger>{1, 4, N_LEAVES_1 - 5, 3 * N_LEAVES_1 + 4,
+                                         N_LEAVES_2 - 4 * N_LEAVES_1 - 3}) {
+    std::vector<Sha256Digest> hashes(batchSize, Node::getEmptyHash());
+    BOOST_REQUIRE(merkleTree.addLeaves(nextSeqNo, hashes));
+    nextSeqNo += batchSize;
+    BOOST_CHECK_EQUAL(merkleTree.getNextLeafSeqNo(), nextSeqNo);
+  }
+
+  BOOST_CHECK(!merkleTree.addLeaves(nextSeqNo + 1, {Node::getEmptyHash()}));
+
+  auto hash = TreeGenerator::getHash(Node::Index(0, 2 * STEP + 1), N_LEAVES_2 + 1);
+  BOOST_CHECK(merkleTree.getRootHash() == hash);
+
+  merkleTree.savePendingTree();
+
+  auto data1 = db.getPendingSubTrees()[0];
+  auto data2 = TreeGenerator::getSubTreeBinary(Node::Index(0, 3 * STEP),
+                                               N_LEAVES_2 + 1)->encode();
+  BOOST_CHECK(data1->wireEncode() == data2->wireEncode());
+
+  for (NonNegativeInteger i = 0; i < N_LEAVES_2; i += N_LEAVES_1) {
+    auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(i, STEP), i + N_LEAVES_1)->encode();
+    auto dataB = db.getSubTreeData(STEP, i);
+
+    BOOST_CHECK(dataA->wireEncode() == dataB->wireEncode());
+  }
+
+  auto dataA = TreeGenerator::getSubTreeBinary(Node::Index(0, 2 * STEP), N_LEAVES_2)->encode();
+  auto dataB = db.getSubTreeData(2 * STEP, 0);
+
+  BOOST_CHECK(dataA->wireEncode() == dataB->wireEncode());
+}
+
+BOOST_AUTO_TEST_CASE(Proof)
+{
+  MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
+  const NonNegativeInteger nLeaves = N_LEAVES_2 + 76;
+
+  // distinct leaves, so that a proof taken from the wrong place cannot verify
+  std::vector<Sha256Digest> leafHashes;
+  std::vector<Sha256Digest> rootHashes(1, Node::getEmptyHash());
+  for (NonNegativeInteger i = 0; i < nLeaves; i++) {
+    leafHashes.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+    BOOST_REQUIRE(merkleTree.addLeaf(i, leafHashes.back()));
+    rootHashes.push_back(merkleTree.getRootHash());
+  }
+  merkleTree.savePendingTree();
+
+  BOOST_CHECK(merkleTree.getExistenceProof(5, 5).empty());
+  BOOST_CHECK(merkleTree.getExistenceProof(0, nLeaves + 1).empty());
+  BOOST_CHECK(merkleTree.getConsistencyProof(0, 5).empty());
+  BOOST_CHECK(merkleTree.getConsistencyProof(6, 5).empty());
+  BOOST_CHECK(merkleTree.getConsistencyProof(5, nLeaves + 1).empty());
+
+  std::vector<NonNegativeInteger> treeSizes{1, 2, 5, N_LEAVES_1, N_LEAVES_1 + 1, 100,
+                                            N_LEAVES_2 - 1, N_LEAVES_2, N_LEAVES_2 + 1, nLeaves};
+  std::vector<NonNegativeInteger> seqNos{0, 1, N_LEAVES_1 - 1, N_LEAVES_1, 99, N_LEAVES_2 - 24,
+                                         N_LEAVES_2, nLeaves - 1};
+
+  for (NonNegativeInteger treeSize : treeSizes) {
+    for (NonNegativeInteger seqNo : seqNos) {
+      if (seqNo >= treeSize)
+        continue;
+
+      auto proof = merkleTree.getExistenceProof(seqNo, treeSize);
+      BOOST_CHECK(Auditor::doesExist(seqNo, leafHashes[seqNo], treeSize, rootHashes[treeSize],
+                                     proof, TreeGenerator::LOGGER_NAME));
+      BOOST_CHECK(!Auditor::doesExist(seqNo, Node::getEmptyHash(), treeSize, rootHashes[treeSize],
+                                      proof, TreeGenerator::LOGGER_NAME));
+    }
+
+    for (NonNegativeInteger oldTreeSize : treeSizes) {
+      if (oldTreeSize > treeSize)
+        continue;
+
+      auto proof = merkleTree.getConsistencyProof(oldTreeSize, treeSize);
+      BOOST_CHECK(Auditor::isConsistent(oldTreeSize, rootHashes[oldTreeSize],
+                                        treeSize, rootHashes[treeSize],
+                                        proof, TreeGenerator::LOGGER_NAME));
+    }
+  }
+
+  // a proof for a tree size does not change as the tree grows
+  auto proof1 = merkleTree.getExistenceProof(N_LEAVES_2 - 24, N_LEAVES_2 + 1);
+  BOOST_REQUIRE(merkleTree.addLeaf(nLeaves, Node::getEmptyHash()));
+  auto proof2 = merkleTree.getExistenceProof(N_LEAVES_2 - 24, N_LEAVES_2 + 1);
+  BOOST_REQUIRE_EQUAL(proof1.size(), proof2.size());
+  for (size_t i = 0; i < proof1.size(); i++)
+    BOOST_CHECK(proof1[i]->wireEncode() == proof2[i]->wireEncode());
+}
+
+BOOST_AUTO_TEST_CASE(FrontierLoad)
+{
+  {
+    MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
+    for (NonNegativeInteger i = 0; i < N_LEAVES_2 + 1; i++) {
+      BOOST_REQUIRE(db.insertLeafData(Leaf(Name("/data").appendNumber(i), 0, i, 0)));
+      BOOST_REQUIRE(merkleTree.addLeaf(i, Node::getEmptyHash()));
+    }
+  } // the pending subtrees and the frontier are saved
+
+  auto frontier = db.getFrontier();
+  BOOST_REQUIRE(frontier != nullptr);
+  BOOST_CHECK_EQUAL(frontier->getNextLeafSeqNo(), N_LEAVES_2 + 1);
+  BOOST_REQUIRE_EQUAL(frontier->getSubTrees().size(), 3);
+  BOOST_CHECK(frontier->getSubTrees()[0].peakIndex == Node::Index(0, 3 * STEP));
+  BOOST_CHECK_EQUAL(frontier->getSubTrees()[0].leafHashes.size(), 1);
+  BOOST_CHECK(frontier->getSubTrees()[2].peakIndex == Node::Index(N_LEAVES_2, STEP));
+  BOOST_CHECK_EQUAL(frontier->getSubTrees()[2].leafHashes.size(), 1);
+
+  MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
+  BOOST_CHECK_EQUAL(merkleTree.getNextLeafSeqNo(), N_LEAVES_2 + 1);
+  BOOST_CHECK(merkleTree.getRootHash() ==
+              TreeGenerator::getHash(Node::Index(0, 2 * STEP + 1), N_LEAVES_2 + 1));
+
+  // the rebuilt pending subtrees are the same as the decoded ones
+  auto datas = db.getPendingSubTrees();
+  BOOST_REQUIRE_EQUAL(datas.size(), 3);
+  BOOST_CHECK(merkleTree.getPendingSubTreeData(3 * STEP)->wireEncode() == datas[0]->wireEncode());
+  BOOST_CHECK(merkleTree.getPendingSubTreeData(2 * STEP)->wireEncode() == datas[1]->wireEncode());
+  BOOST_CHECK(merkleTree.getPendingSubTreeData(STEP)->wireEncode() == datas[2]->wireEncode());
+
+  // a frontier which does not chain or does not match its root is rejected
+  Frontier badRoot(N_LEAVES_2 + 1, Node::getEmptyHash());
+  Frontier badChain(N_LEAVES_2 + 1, merkleTree.getRootHash());
+  for (const auto& subTree : frontier->getSubTrees()) {
+    badRoot.addSubTree(subTree.peakIndex, subTree.leafHashes);
+    if (subTree.peakIndex.level != 2 * STEP)
+      badChain.addSubTree(subTree.peakIndex, subTree.leafHashes);
+  }
+  BOOST_CHECK(!merkleTree.loadFrontier(badRoot));
+  BOOST_CHECK(!merkleTree.loadFrontier(badChain));
+  BOOST_CHECK(!merkleTree.loadFrontier(Frontier()));
+  BOOST_CHECK_EQUAL(merkleTree.getNextLeafSeqNo(), N_LEAVES_2 + 1);
+  BOOST_CHECK(merkleTree.getRootHash() ==
+              TreeGenerator::getHash(Node::Index(0, 2 * STEP + 1), N_LEAVES_2 + 1));
+
+  // the tree keeps growing from the frontier
+  for (NonNegativeInteger i = N_LEAVES_2 + 1; i < 2 * N_LEAVES_2 + 1; i++)
+    BOOST_REQUIRE(merkleTree.addLeaf(i, Node::getEmptyHash()));
+  BOOST_CHECK(merkleTree.getRootHash() ==
+              TreeGenerator::getHash(Node::Index(0, 2 * STEP + 2), 2 * N_LEAVES_2 + 1));
+}
+
+BOOST_AUTO_TEST_CASE(SaveChanged)
+{
+  MerkleTree merkleTree(TreeGenerator::LOGGER_NAME, db);
+  for (NonNegativeInteger i = 0; i < N_LEAVES_2 + 1; i++) {
+    BOOST_REQUIRE(db.insertLeafData(Leaf(Name("/data").appendNumber(i), 0, i, 0)));
+    BOOST_REQUIRE(merkleTree.addLeaf(i, Node::getEmptyHash()));
+  }
+  BOOST_CHECK_EQUAL(merkleTree.getNUnsavedLeaves(), N_LEAVES_2 + 1);
+
+  BOOST_CHECK_EQUAL(merkleTree.savePendingTree(), 3);
+  BOOST_CHECK_EQUAL(merkleTree.getNUnsavedLeaves(), 0);
+  BOOST_CHECK(db.getFrontier() != nullptr);
+
+  // nothing has changed since
+  BOOST_CHECK_EQUAL(merkleTree.savePendingTree(), 0);
+
+  // a new leaf changes its pending subtree and the ones above
+  BOOST_REQUIRE(db.insertLeafData(Leaf(Name("/data").appendNumber(N_LEAVES_2 + 1), 0,
+                                       N_LEAVES_2 + 1, 0)));
+  BOOST_REQUIRE(merkleTree.addLeaf(N_LEAVES_2 + 1, Node::getEmptyHash()));
+  BOOST_CHECK_EQUAL(merkleTree.getNUnsavedLeaves(), 1);
+  BOOST_CHECK(db.getFrontier() == nullptr);
+  BOOST_CHECK_EQUAL(merkleTree.savePendingTree(), 3);
+  BOOST_CHECK(db.getFrontier() != nullptr);
+
+  auto data = db.getSubTreeData(STEP, N_LEAVES_2);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK(data->wireEncode() == merkleTree.getPendingSubTreeData(STEP)->wireEncode());
+
+  // a loaded tree starts out saved
+  MerkleTree merkleTree2(TreeGenerator::LOGGER_NAME, db);
+  BOOST_CHECK_EQUAL(merkleTree2.getNUnsavedLeaves(), 0);
+  BOOST_CHECK_EQUAL(merkleTree2.savePendingTree(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
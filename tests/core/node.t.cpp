@@ -56,6 +56,13 @@ BOOST_AUTO_TEST_CASE(IndexTest1)
 
   BOOST_CHECK_THROW(Node::Index(1, 1), Node::Error);
   BOOST_CHECK_THROW(Node::Index(2, 2), Node::Error);
+
+  // ranges beyond 32 bits
+  NonNegativeInteger seqNo5 = static_cast<NonNegativeInteger>(1) << 40;
+  Node::Index idx5(seqNo5, 40);
+  BOOST_CHECK_EQUAL(idx5.range, seqNo5);
+
+  BOOST_CHECK_THROW(Node::Index(static_cast<NonNegativeInteger>(1) << 32, 35), Node::Error);
 }
 
 BOOST_AUTO_TEST_CASE(IndexTest2)
@@ -80,14 +87,16 @@ BOOST_AUTO_TEST_CASE(IndexTest2)
 
 BOOST_AUTO_TEST_CASE(NodeTest1)
 {
-  std::string hash("ABCDEFGHIJKLMNOPabcdefghijklmno");
-  auto buffer = make_shared<const ndn::Buffer>(hash.c_str(), hash.size());
+  std::string hashString("ABCDEFGHIJKLMNOPabcdefghijklmnop");
+  Sha256Digest hash;
+  BOOST_REQUIRE(toSha256Digest(reinterpret_cast<const uint8_t*>(hashString.c_str()),
+                               hashString.size(), hash));
 
   Node node(0, 0);
   BOOST_CHECK(node.getIndex() == Node::Index(0, 0));
   BOOST_CHECK(!node.isFull());
   BOOST_CHECK_EQUAL(node.getLeafSeqNo(), 0);
-  BOOST_CHECK(node.getHash() == nullptr);
+  BOOST_CHECK(!node.hasHash());
 
   node.setLeafSeqNo(1);
   BOOST_CHECK(node.isFull());
@@ -96,18 +105,22 @@ BOOST_AUTO_TEST_CASE(NodeTest1)
   Node node2(2, 1);
   BOOST_CHECK(!node2.isFull());
   BOOST_CHECK_EQUAL(node2.getLeafSeqNo(), 2);
-  BOOST_CHECK(node2.getHash() == nullptr);
+  BOOST_CHECK(!node2.hasHash());
 
   Node node3(2, 1, 4);
   BOOST_CHECK(node3.isFull());
   BOOST_CHECK_EQUAL(node3.getLeafSeqNo(), 4);
-  BOOST_CHECK(node3.getHash() == nullptr);
+  BOOST_CHECK(!node3.hasHash());
 
-  Node node4(2, 1, 3, buffer);
+  Node node4(2, 1, 3, hash);
   BOOST_CHECK(!node4.isFull());
   BOOST_CHECK_EQUAL(node4.getLeafSeqNo(), 3);
-  BOOST_CHECK_EQUAL_COLLECTIONS(node4.getHash()->begin(), node4.getHash()->end(),
-                                buffer->begin(), buffer->end());
+  BOOST_CHECK(node4.hasHash());
+  BOOST_CHECK_EQUAL_COLLECTIONS(node4.getHash().begin(), node4.getHash().end(),
+                                hash.begin(), hash.end());
+
+  BOOST_CHECK(!toSha256Digest(reinterpret_cast<const uint8_t*>(hashString.c_str()),
+                              hashString.size() - 1, hash));
 
 
   {
@@ -117,7 +130,7 @@ BOOST_AUTO_TEST_CASE(NodeTest1)
     std::string emptyHash("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
     StringSource ss(reinterpret_cast<const uint8_t*>(emptyHash.c_str()), emptyHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(Node::getEmptyHash()->begin(), Node::getEmptyHash()->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(Node::getEmptyHash().begin(), Node::getEmptyHash().end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "response-batch.hpp"
+#include "node.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestResponseBatch)
+
+static Sha256Digest
+makeLeafHash(size_t i)
+{
+  Sha256Digest hash;
+  hash.fill(static_cast<uint8_t>(i));
+  return hash;
+}
+
+BOOST_AUTO_TEST_CASE(Basic)
+{
+  BOOST_CHECK_THROW(ResponseBatch(std::vector<Sha256Digest>()), ResponseBatch::Error);
+
+  // a batch of one is its own root
+  ResponseBatch batch1({makeLeafHash(1)});
+  BOOST_CHECK(batch1.getRootHash() == makeLeafHash(1));
+  BOOST_CHECK(batch1.getPath(0).empty());
+  BOOST_CHECK_THROW(batch1.getPath(1), ResponseBatch::Error);
+
+  // the nodes are hashed like those of the log tree
+  ResponseBatch batch3({makeLeafHash(0), makeLeafHash(1), makeLeafHash(2)});
+  Sha256Digest left = Node::computeHash(Node::Index(0, 1), makeLeafHash(0), makeLeafHash(1));
+  Sha256Digest right = Node::computeHash(Node::Index(2, 1), makeLeafHash(2), Node::getEmptyHash());
+  BOOST_CHECK(batch3.getRootHash() == Node::computeHash(Node::Index(0, 2), left, right));
+
+  std::vector<Sha256Digest> path = batch3.getPath(2);
+  BOOST_REQUIRE_EQUAL(path.size(), 2);
+  BOOST_CHECK(path[0] == Node::getEmptyHash());
+  BOOST_CHECK(path[1] == left);
+}
+
+BOOST_AUTO_TEST_CASE(Path)
+{
+  for (size_t nLeaves = 1; nLeaves <= 17; nLeaves++) {
+    std::vector<Sha256Digest> leafHashes;
+    for (size_t i = 0; i < nLeaves; i++)
+      leafHashes.push_back(makeLeafHash(i));
+
+    ResponseBatch batch(leafHashes);
+    BOOST_CHECK_EQUAL(batch.getNLeaves(), nLeaves);
+
+    for (size_t i = 0; i < nLeaves; i++) {
+      std::vector<Sha256Digest> path = batch.getPath(i);
+      BOOST_CHECK(ResponseBatch::computeRootHash(leafHashes[i], i, path) == batch.getRootHash());
+
+      // another leaf, or the same leaf at another index, does not lead to the root
+      BOOST_CHECK(ResponseBatch::computeRootHash(makeLeafHash(nLeaves), i, path) !=
+                  batch.getRootHash());
+      if (!path.empty()) {
+        BOOST_CHECK(ResponseBatch::computeRootHash(leafHashes[i], i ^ 1, path) !=
+                    batch.getRootHash());
+      }
+    }
+  }
+
+  BOOST_CHECK_THROW(ResponseBatch::computeRootHash(makeLeafHash(0), 0,
+                                                   std::vector<Sha256Digest>(64)),
+                    ResponseBatch::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "signature-verifier.hpp"
+#include "identity-fixture.hpp"
+
+#include <thread>
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestSignatureVerifier, IdentityFixture)
+
+BOOST_AUTO_TEST_CASE(Verify)
+{
+  Name rsaIdentity("/ndn/rsa");
+  addIdentity(rsaIdentity, ndn::RsaKeyParams());
+  auto rsaCert =
+    m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(rsaIdentity));
+
+  Name ecdsaIdentity("/ndn/ecdsa");
+  addIdentity(ecdsaIdentity, ndn::EcdsaKeyParams());
+  auto ecdsaCert =
+    m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(ecdsaIdentity));
+
+  SignatureVerifier rsaVerifier(rsaCert->getPublicKeyInfo());
+  SignatureVerifier ecdsaVerifier(ecdsaCert->getPublicKeyInfo());
+
+  Data rsaData(Name("/ndn/rsa/data"));
+  m_keyChain.sign(rsaData, rsaCert->getName());
+  Data ecdsaData(Name("/ndn/ecdsa/data"));
+  m_keyChain.sign(ecdsaData, ecdsaCert->getName());
+
+  BOOST_CHECK(rsaVerifier.verify(rsaData));
+  BOOST_CHECK(ecdsaVerifier.verify(ecdsaData));
+
+  // the key has to match the signature
+  BOOST_CHECK(!rsaVerifier.verify(ecdsaData));
+  BOOST_CHECK(!ecdsaVerifier.verify(rsaData));
+
+  Data digestData(Name("/ndn/rsa/digest"));
+  m_keyChain.signWithSha256(digestData);
+  BOOST_CHECK(!rsaVerifier.verify(digestData));
+
+  // the content is covered by the signature
+  for (Data* data : {&rsaData, &ecdsaData}) {
+    data->setContent(reinterpret_cast<const uint8_t*>("forged"), 6);
+    BOOST_CHECK(!rsaVerifier.verify(*data));
+    BOOST_CHECK(!ecdsaVerifier.verify(*data));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Concurrent)
+{
+  Name identity("/ndn/ecdsa");
+  addIdentity(identity, ndn::EcdsaKeyParams());
+  auto cert = m_keyChain.getCertificate(m_keyChain.getDefaultCertificateNameForIdentity(identity));
+  SignatureVerifier verifier(cert->getPublicKeyInfo());
+
+  std::vector<Data> dataList;
+  for (size_t i = 0; i < 8; i++) {
+    dataList.push_back(Data(Name("/ndn/ecdsa/data").appendNumber(i)));
+    m_keyChain.sign(dataList.back(), cert->getName());
+    dataList.back().wireEncode();
+  }
+
+  // one verifier is shared by the threads, each verifies its own Data
+  std::vector<int> isVerified(dataList.size(), 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 2; t++) {
+    threads.emplace_back([&, t] {
+        for (size_t i = t; i < dataList.size(); i += 2) {
+          isVerified[i] = verifier.verify(dataList[i]);
+        }
+      });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (int result : isVerified)
+    BOOST_CHECK(result);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "signer-cache.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestSignerCache)
+
+static shared_ptr<const SignerCache::Signer>
+makeSigner(const Timestamp& timestamp)
+{
+  auto signer = make_shared<SignerCache::Signer>();
+  signer->timestamp = timestamp;
+  return signer;
+}
+
+BOOST_AUTO_TEST_CASE(Basic)
+{
+  auto signer1 = makeSigner(1);
+  auto signer2 = makeSigner(2);
+  auto signer3 = makeSigner(3);
+
+  // disabled
+  SignerCache cache;
+  cache.insert(1, signer1);
+  BOOST_CHECK(cache.find(1) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 0);
+
+  cache.setCapacity(2);
+  cache.insert(1, signer1);
+  cache.insert(2, signer2);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+
+  BOOST_CHECK(cache.find(1) == signer1);
+  BOOST_CHECK(cache.find(3) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 1);
+
+  // 2 is the least recently used
+  cache.insert(3, signer3);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK(cache.find(2) == nullptr);
+  BOOST_CHECK(cache.find(1) == signer1);
+  BOOST_CHECK(cache.find(3) == signer3);
+
+  // replacing does not duplicate
+  cache.insert(3, signer2);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK(cache.find(3) == signer2);
+
+  // shrinking evicts the least recently used
+  cache.setCapacity(1);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 1);
+  BOOST_CHECK(cache.find(1) == nullptr);
+  BOOST_CHECK(cache.find(3) == signer2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -29,6 +29,9 @@ namespace ndn {
 namespace delorean {
 namespace tests {
 
+// the cases below are written for subtrees of depth 6, whatever depth the build is configured with
+typedef BasicSubTreeBinary<6> SubTreeBinary;
+
 class SubTreeBinaryTestFixture
 {
 public:
@@ -38,12 +41,12 @@ public:
   size_t nCompleteCalls;
   size_t nUpdateCalls;
 
-  ndn::ConstBufferPtr eventualHash;
+  Sha256Digest eventualHash;
 };
 
 BOOST_FIXTURE_TEST_SUITE(TestSubTreeBinary, SubTreeBinaryTestFixture)
 
-ndn::ConstBufferPtr
+Sha256Digest
 getTestHashRoot(const Node::Index& idx)
 {
   if (idx.level == 0)
@@ -54,10 +57,13 @@ getTestHashRoot(const Node::Index& idx)
 
   ndn::util::Sha256 sha256;
   sha256 << idx.level << idx.seqNo;
-  sha256.update(hash1->buf(), hash1->size());
-  sha256.update(hash2->buf(), hash2->size());
+  sha256.update(hash1.data(), hash1.size());
+  sha256.update(hash2.data(), hash2.size());
 
-  return sha256.computeDigest();
+  ndn::ConstBufferPtr digest = sha256.computeDigest();
+  Sha256Digest hash;
+  BOOST_REQUIRE(toSha256Digest(digest->buf(), digest->size(), hash));
+  return hash;
 }
 
 void
@@ -103,7 +109,7 @@ BOOST_AUTO_TEST_CASE(BasicTest1)
                         },
                         [&] (const Node::Index&,
                              const NonNegativeInteger& seqNo,
-                             ndn::ConstBufferPtr hash) {
+                             const Sha256Digest& hash) {
                           BOOST_CHECK_EQUAL(this->nextSeqNo, seqNo);
                           this->nUpdateCalls++;
                           this->eventualHash = hash;
@@ -129,8 +135,8 @@ BOOST_AUTO_TEST_CASE(BasicTest1)
   BOOST_CHECK_EQUAL(nUpdateCalls, 32);
 
   auto actualHash = subTree.getRoot()->getHash();
-  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
-                                eventualHash->begin(), eventualHash->end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
+                                eventualHash.begin(), eventualHash.end());
 
   {
     using namespace CryptoPP;
@@ -139,7 +145,7 @@ BOOST_AUTO_TEST_CASE(BasicTest1)
     std::string rootHash("989551ef13ce660c1c5ccdda770f4769966a6faf83722c91dfeac597c6fa2782");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 
@@ -163,7 +169,7 @@ BOOST_AUTO_TEST_CASE(BasicTest2)
                         },
                         [&] (const Node::Index&,
                              const NonNegativeInteger& seqNo,
-                             ndn::ConstBufferPtr hash) {
+                             const Sha256Digest& hash) {
                           BOOST_CHECK(this->nextSeqNo >= (1 << (idx.level - 1)));
                           BOOST_CHECK_EQUAL(this->nextSeqNo, seqNo);
                           this->nUpdateCalls++;
@@ -190,8 +196,8 @@ BOOST_AUTO_TEST_CASE(BasicTest2)
   BOOST_CHECK_EQUAL(nUpdateCalls, 32);
 
   auto actualHash = subTree.getRoot()->getHash();
-  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
-                                eventualHash->begin(), eventualHash->end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
+                                eventualHash.begin(), eventualHash.end());
 
   {
     using namespace CryptoPP;
@@ -200,7 +206,7 @@ BOOST_AUTO_TEST_CASE(BasicTest2)
     std::string rootHash("2657cd81c3acb8eb4489f0a2559d42532644ce737ae494f49f30452f47bcff53");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
@@ -223,7 +229,7 @@ BOOST_AUTO_TEST_CASE(BasicTest3)
                         },
                         [&] (const Node::Index&,
                              const NonNegativeInteger& seqNo,
-                             ndn::ConstBufferPtr hash) {
+                             const Sha256Digest& hash) {
                           BOOST_CHECK_EQUAL(this->nextSeqNo, seqNo);
                           this->nUpdateCalls++;
                           this->eventualHash = hash;
@@ -249,8 +255,8 @@ BOOST_AUTO_TEST_CASE(BasicTest3)
   BOOST_CHECK_EQUAL(nUpdateCalls, 32);
 
   auto actualHash = subTree.getRoot()->getHash();
-  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
-                                eventualHash->begin(), eventualHash->end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
+                                eventualHash.begin(), eventualHash.end());
 
   {
     using namespace CryptoPP;
@@ -259,7 +265,7 @@ BOOST_AUTO_TEST_CASE(BasicTest3)
     std::string rootHash("dc138a319c197bc4ede89902ed9b46e4e17d732b5ace9fa3b8a398db5edb1e36");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
@@ -274,7 +280,7 @@ BOOST_AUTO_TEST_CASE(AddLeaf1)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   auto node_0_5 = make_shared<Node>(0, 5, 32, getTestHashRoot(Node::Index(0, 5)));
   auto node_32_5 = make_shared<Node>(32, 5, 64, getTestHashRoot(Node::Index(32, 5)));
@@ -286,14 +292,14 @@ BOOST_AUTO_TEST_CASE(AddLeaf1)
                          [&] (const Node::Index&) {},
                          [&] (const Node::Index&,
                               const NonNegativeInteger&,
-                              ndn::ConstBufferPtr) {});
+                              const Sha256Digest&) {});
 
   auto node_32_0 = make_shared<Node>(32, 0, 33, Node::getEmptyHash());
   auto node_33_0 = make_shared<Node>(33, 0, 34, Node::getEmptyHash());
   auto node_34_0 = make_shared<Node>(34, 0, 35, Node::getEmptyHash());
   BOOST_REQUIRE(subTree2.addLeaf(node_32_0));
   BOOST_REQUIRE(subTree2.getRoot() != nullptr);
-  BOOST_REQUIRE(subTree2.getRoot()->getHash() != nullptr);
+  BOOST_REQUIRE(subTree2.getRoot()->hasHash());
   auto node_32_5_33 = make_shared<Node>(32, 5, 33, subTree2.getRoot()->getHash());
   BOOST_REQUIRE(subTree2.addLeaf(node_33_0));
   auto node_32_5_34 = make_shared<Node>(32, 5, 34, subTree2.getRoot()->getHash());
@@ -325,7 +331,7 @@ BOOST_AUTO_TEST_CASE(AddLeaf1)
     std::string rootHash("dc138a319c197bc4ede89902ed9b46e4e17d732b5ace9fa3b8a398db5edb1e36");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
@@ -426,7 +432,7 @@ BOOST_AUTO_TEST_CASE(Encoding1)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   for (int i = 0; i < 32; i++) {
     auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
@@ -449,7 +455,7 @@ BOOST_AUTO_TEST_CASE(Decoding1)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   Block block(SUBTREE_DATA, sizeof(SUBTREE_DATA));
   Data data(block);
@@ -494,7 +500,7 @@ BOOST_AUTO_TEST_CASE(Encoding2)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   auto node_0_5 = make_shared<Node>(0, 5, 32, getTestHashRoot(Node::Index(0, 5)));
   auto node_32_5 = make_shared<Node>(32, 5, 64, getTestHashRoot(Node::Index(32, 5)));
@@ -506,14 +512,14 @@ BOOST_AUTO_TEST_CASE(Encoding2)
                          [&] (const Node::Index&) {},
                          [&] (const Node::Index&,
                               const NonNegativeInteger&,
-                              ndn::ConstBufferPtr) {});
+                              const Sha256Digest&) {});
 
   auto node_32_0 = make_shared<Node>(32, 0, 33, Node::getEmptyHash());
   auto node_33_0 = make_shared<Node>(33, 0, 34, Node::getEmptyHash());
   auto node_34_0 = make_shared<Node>(34, 0, 35, Node::getEmptyHash());
   BOOST_REQUIRE(subTree2.addLeaf(node_32_0));
   BOOST_REQUIRE(subTree2.getRoot() != nullptr);
-  BOOST_REQUIRE(subTree2.getRoot()->getHash() != nullptr);
+  BOOST_REQUIRE(subTree2.getRoot()->hasHash());
   auto node_32_5_33 = make_shared<Node>(32, 5, 33, subTree2.getRoot()->getHash());
   BOOST_REQUIRE(subTree2.addLeaf(node_33_0));
   auto node_32_5_34 = make_shared<Node>(32, 5, 34, subTree2.getRoot()->getHash());
@@ -546,7 +552,7 @@ BOOST_AUTO_TEST_CASE(Decoding2)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   Block block(SUBTREE_DATA2, sizeof(SUBTREE_DATA2));
   Data data(block);
@@ -571,7 +577,7 @@ BOOST_AUTO_TEST_CASE(Decoding2)
     std::string rootHash("dc138a319c197bc4ede89902ed9b46e4e17d732b5ace9fa3b8a398db5edb1e36");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
@@ -609,7 +615,7 @@ BOOST_AUTO_TEST_CASE(Encoding3)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   shared_ptr<Data> data = subTree.encode();
   BOOST_REQUIRE(data != nullptr);
@@ -631,7 +637,7 @@ BOOST_AUTO_TEST_CASE(Decoding3)
                         [&] (const Node::Index&) {},
                         [&] (const Node::Index&,
                              const NonNegativeInteger&,
-                             ndn::ConstBufferPtr) {});
+                             const Sha256Digest&) {});
 
   Block block(SUBTREE_DATA3, sizeof(SUBTREE_DATA3));
   Data data(block);
@@ -664,11 +670,164 @@ BOOST_AUTO_TEST_CASE(Decoding3)
     std::string rootHash("989551ef13ce660c1c5ccdda770f4769966a6faf83722c91dfeac597c6fa2782");
     StringSource ss(reinterpret_cast<const uint8_t*>(rootHash.c_str()), rootHash.size(),
                     true, new HexDecoder(new FileSink(os)));
-    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash->begin(), actualHash->end(),
+    BOOST_CHECK_EQUAL_COLLECTIONS(actualHash.begin(), actualHash.end(),
                                   os.buf()->begin(), os.buf()->end());
   }
 }
 
+BOOST_AUTO_TEST_CASE(GetNode)
+{
+  SubTreeBinary subTree(Name("/logger/name"), Node::Index(32, 5),
+                        [] (const Node::Index&) {},
+                        [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+
+  BOOST_CHECK(subTree.getNode(Node::Index(32, 0)) == nullptr);
+
+  for (int i = 32; i < 37; i++) {
+    auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
+    BOOST_REQUIRE(subTree.addLeaf(node));
+  }
+
+  // the peak exists before it is complete
+  auto root = subTree.getRoot();
+  BOOST_REQUIRE(root != nullptr);
+  BOOST_CHECK(root->getIndex() == Node::Index(32, 5));
+  BOOST_CHECK_EQUAL(root->getLeafSeqNo(), 37);
+
+  auto leaf = subTree.getNode(Node::Index(36, 0));
+  BOOST_REQUIRE(leaf != nullptr);
+  BOOST_CHECK_EQUAL(leaf->getLeafSeqNo(), 37);
+  BOOST_CHECK(leaf->getHash() == Node::getEmptyHash());
+
+  // a node with only a left child is hashed against the empty hash
+  auto node = subTree.getNode(Node::Index(36, 2));
+  BOOST_REQUIRE(node != nullptr);
+  BOOST_CHECK_EQUAL(node->getLeafSeqNo(), 37);
+  auto leftHash = subTree.getNode(Node::Index(36, 1))->getHash();
+  BOOST_CHECK(node->getHash() == Node::computeHash(node->getIndex(), leftHash,
+                                                   Node::getEmptyHash()));
+
+  BOOST_CHECK(subTree.getNode(Node::Index(37, 0)) == nullptr);
+  BOOST_CHECK(subTree.getNode(Node::Index(40, 3)) == nullptr);
+  BOOST_CHECK(subTree.getNode(Node::Index(0, 0)) == nullptr);
+  BOOST_CHECK(subTree.getNode(Node::Index(64, 0)) == nullptr);
+  BOOST_CHECK(subTree.getNode(Node::Index(0, 6)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(AddLeaves)
+{
+  std::vector<Sha256Digest> hashes;
+  for (uint64_t i = 32; i < 64; i++)
+    hashes.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+
+  SubTreeBinary expected(Name("/logger/name"), Node::Index(32, 5),
+                         [] (const Node::Index&) {},
+                         [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+  for (size_t i = 0; i < hashes.size(); i++)
+    BOOST_REQUIRE(expected.addLeaf(Node(32 + i, 0, 33 + i, hashes[i])));
+
+  size_t nCompleteCalls = 0;
+  size_t nUpdateCalls = 0;
+  NonNegativeInteger updatedSeqNo = 0;
+  SubTreeBinary subTree(Name("/logger/name"), Node::Index(32, 5),
+                        [&] (const Node::Index&) { nCompleteCalls++; },
+                        [&] (const Node::Index&, const NonNegativeInteger& seqNo,
+                             const Sha256Digest&) {
+                          nUpdateCalls++;
+                          updatedSeqNo = seqNo;
+                        });
+
+  BOOST_CHECK_EQUAL(subTree.addLeaves(33, hashes.data(), 3), 0);
+  BOOST_CHECK_EQUAL(subTree.addLeaves(32, hashes.data(), 0), 0);
+
+  BOOST_CHECK_EQUAL(subTree.addLeaves(32, hashes.data(), 3), 3);
+  BOOST_CHECK_EQUAL(subTree.getNextLeafSeqNo(), 35);
+  BOOST_CHECK_EQUAL(updatedSeqNo, 35);
+
+  // the last leaf can still be added one by one
+  BOOST_CHECK(subTree.addLeaf(Node(35, 0, 36, hashes[3])));
+
+  BOOST_CHECK_EQUAL(subTree.addLeaves(36, hashes.data() + 4, 12), 12);
+  BOOST_CHECK_EQUAL(subTree.getNextLeafSeqNo(), 48);
+  BOOST_CHECK_EQUAL(nCompleteCalls, 0);
+
+  // the batch stops when the subtree is full
+  BOOST_CHECK_EQUAL(subTree.addLeaves(48, hashes.data() + 16, 20), 16);
+  BOOST_CHECK(subTree.isFull());
+  BOOST_CHECK_EQUAL(nCompleteCalls, 1);
+  BOOST_CHECK_EQUAL(nUpdateCalls, 4);
+  BOOST_CHECK_EQUAL(updatedSeqNo, 64);
+
+  BOOST_CHECK(subTree.getRootHash() == expected.getRootHash());
+  BOOST_CHECK(subTree.encode()->wireEncode() == expected.encode()->wireEncode());
+  for (NonNegativeInteger seqNo = 32; seqNo < 64; seqNo += 4) {
+    auto node = subTree.getNode(Node::Index(seqNo, 2));
+    BOOST_REQUIRE(node != nullptr);
+    BOOST_CHECK(node->getHash() == expected.getNode(Node::Index(seqNo, 2))->getHash());
+  }
+
+  // in the root subtree, the first leaf is the actual root until the next one is added, the
+  // root is still reported once per batch
+  nUpdateCalls = 0;
+  auto onRootUpdate = [&] (const Node::Index&, const NonNegativeInteger& seqNo,
+                           const Sha256Digest&) {
+    nUpdateCalls++;
+    updatedSeqNo = seqNo;
+  };
+  SubTreeBinary rootTree1(Name("/logger/name"), Node::Index(0, 5),
+                          [] (const Node::Index&) {}, onRootUpdate);
+  BOOST_CHECK_EQUAL(rootTree1.addLeaves(0, hashes.data(), 3), 3);
+  BOOST_CHECK_EQUAL(nUpdateCalls, 1);
+  BOOST_CHECK_EQUAL(updatedSeqNo, 3);
+
+  nUpdateCalls = 0;
+  SubTreeBinary rootTree2(Name("/logger/name"), Node::Index(0, 5),
+                          [] (const Node::Index&) {}, onRootUpdate);
+  BOOST_CHECK_EQUAL(rootTree2.addLeaves(0, hashes.data(), 1), 1);
+  BOOST_CHECK_EQUAL(nUpdateCalls, 1);
+  BOOST_CHECK_EQUAL(updatedSeqNo, 1);
+  BOOST_CHECK_EQUAL(rootTree2.addLeaves(1, hashes.data() + 1, 2), 2);
+  BOOST_CHECK_EQUAL(nUpdateCalls, 2);
+  BOOST_CHECK_EQUAL(updatedSeqNo, 3);
+  BOOST_CHECK(rootTree2.getRootHash() == rootTree1.getRootHash());
+}
+
+BOOST_AUTO_TEST_CASE(EncodingCache)
+{
+  SubTreeBinary subTree(Name("/logger/name"), Node::Index(32, 10),
+                        [] (const Node::Index&) {},
+                        [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+
+  auto emptyData = subTree.encode();
+  BOOST_CHECK(subTree.encode() == emptyData);
+
+  uint64_t version = subTree.getVersion();
+  BOOST_REQUIRE(subTree.addLeaf(Node(32, 5, 33, Node::getEmptyHash())));
+  BOOST_CHECK_NE(subTree.getVersion(), version);
+
+  auto data1 = subTree.encode();
+  BOOST_CHECK(data1 != emptyData);
+  BOOST_CHECK(subTree.encode() == data1);
+
+  // a rejected leaf does not change the subtree
+  version = subTree.getVersion();
+  BOOST_CHECK(!subTree.addLeaf(Node(64, 5, 65, Node::getEmptyHash())));
+  BOOST_CHECK_EQUAL(subTree.getVersion(), version);
+  BOOST_CHECK(subTree.encode() == data1);
+
+  BOOST_REQUIRE(subTree.updateLeaf(34, Node::getEmptyHash()));
+  auto data2 = subTree.encode();
+  BOOST_CHECK(data2 != data1);
+  BOOST_CHECK_EQUAL(data2->getName().get(SubTreeBinary::OFFSET_COMPLETE).toNumber(), 34);
+
+  // the cached Data is what a fresh encoding would give
+  SubTreeBinary decoded(Name("/logger/name"),
+                        [] (const Node::Index&) {},
+                        [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+  decoded.decode(*data2);
+  BOOST_CHECK(decoded.encode()->wireEncode() == data2->wireEncode());
+}
+
 BOOST_AUTO_TEST_CASE(SubTreePeakIndexConvert)
 {
   BOOST_CHECK(SubTreeBinary::toSubTreePeakIndex(Node::Index(0, 0)) == Node::Index(0, 5));
@@ -686,6 +845,59 @@ BOOST_AUTO_TEST_CASE(SubTreePeakIndexConvert)
   BOOST_CHECK(SubTreeBinary::toSubTreePeakIndex(Node::Index(34, 1)) == Node::Index(32, 5));
 }
 
+template<size_t DEPTH>
+void
+checkDepth()
+{
+  typedef BasicSubTreeBinary<DEPTH> SubTree;
+  const size_t step = SubTree::STEP;
+  const NonNegativeInteger nLeaves = 1 << step;
+
+  BOOST_CHECK(SubTree::toSubTreePeakIndex(Node::Index(0, 0)) == Node::Index(0, step));
+  BOOST_CHECK(SubTree::toSubTreePeakIndex(Node::Index(0, step)) == Node::Index(0, 2 * step));
+  BOOST_CHECK(SubTree::toSubTreePeakIndex(Node::Index(0, step), false) == Node::Index(0, step));
+  BOOST_CHECK(SubTree::toSubTreePeakIndex(Node::Index(nLeaves + 1, 1)) ==
+              Node::Index(nLeaves, step));
+
+  std::vector<Sha256Digest> hashes;
+  for (uint64_t i = 0; i < nLeaves; i++)
+    hashes.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+
+  // the root of the second subtree, hashed level by level
+  std::vector<Sha256Digest> row = hashes;
+  for (size_t level = 1; level <= step; level++) {
+    std::vector<Sha256Digest> parents;
+    for (size_t i = 0; i < row.size(); i += 2)
+      parents.push_back(Node::computeHash(Node::Index(nLeaves + (i << (level - 1)), level),
+                                          row[i], row[i + 1]));
+    row = parents;
+  }
+
+  SubTree subTree(Name("/logger/name"), Node::Index(nLeaves, step),
+                  [] (const Node::Index&) {},
+                  [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+  BOOST_CHECK_EQUAL(subTree.getLeafLevel(), 0);
+  BOOST_CHECK_EQUAL(subTree.addLeaves(nLeaves, hashes.data(), hashes.size()), nLeaves);
+  BOOST_CHECK(subTree.isFull());
+  BOOST_CHECK(subTree.getRootHash() == row[0]);
+
+  auto data = subTree.encode();
+  BOOST_CHECK_EQUAL(data->getContent().value_size(), nLeaves * 32);
+
+  SubTree decoded(Name("/logger/name"),
+                  [] (const Node::Index&) {},
+                  [] (const Node::Index&, const NonNegativeInteger&, const Sha256Digest&) {});
+  decoded.decode(*data);
+  BOOST_CHECK(decoded.getPeakIndex() == Node::Index(nLeaves, step));
+  BOOST_CHECK(decoded.getRootHash() == row[0]);
+}
+
+BOOST_AUTO_TEST_CASE(Depths)
+{
+  checkDepth<6>();
+  checkDepth<8>();
+  checkDepth<10>();
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
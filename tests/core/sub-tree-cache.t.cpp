@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sub-tree-cache.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestSubTreeCache)
+
+static shared_ptr<Data>
+makeSubTree(size_t level, const NonNegativeInteger& seqNo)
+{
+  auto data = make_shared<Data>(Name("/logger/tree").appendNumber(level).appendNumber(seqNo));
+  ndn::DigestSha256 sig;
+  data->setSignature(sig);
+  data->setSignatureValue(Block(tlv::SignatureValue, make_shared<ndn::Buffer>(32)));
+  data->wireEncode();
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(Basic)
+{
+  auto data1 = makeSubTree(5, 0);
+  auto data2 = makeSubTree(5, 32);
+  auto data3 = makeSubTree(5, 64);
+  size_t size = data1->wireEncode().size();
+  BOOST_REQUIRE_EQUAL(data2->wireEncode().size(), size);
+  BOOST_REQUIRE_EQUAL(data3->wireEncode().size(), size);
+
+  // disabled
+  SubTreeCache cache;
+  cache.insert(5, 0, data1);
+  BOOST_CHECK(cache.find(5, 0) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 0);
+
+  cache.setCapacity(2 * size);
+  cache.insert(5, 0, data1);
+  cache.insert(5, 32, data2);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK_EQUAL(cache.getSize(), 2 * size);
+
+  BOOST_CHECK(cache.find(5, 0) == data1);
+  BOOST_CHECK(cache.find(10, 0) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 1);
+
+  // (5, 32) is the least recently used
+  cache.insert(5, 64, data3);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK(cache.find(5, 32) == nullptr);
+  BOOST_CHECK(cache.find(5, 0) == data1);
+  BOOST_CHECK(cache.find(5, 64) == data3);
+
+  // replacing does not duplicate
+  cache.insert(5, 64, data2);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK_EQUAL(cache.getSize(), 2 * size);
+  BOOST_CHECK(cache.find(5, 64) == data2);
+
+  cache.erase(5, 64);
+  BOOST_CHECK(cache.find(5, 64) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getSize(), size);
+
+  // too large to be cached
+  cache.setCapacity(size - 1);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  cache.insert(5, 0, data1);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  BOOST_CHECK_EQUAL(cache.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -37,13 +37,13 @@ BOOST_AUTO_TEST_CASE(HashGeneration)
                        [&] (const Node::Index&) {},
                        [&] (const Node::Index&,
                             const NonNegativeInteger&,
-                            ndn::ConstBufferPtr) {});
+                            const Sha256Digest&) {});
     for (size_t i = 0; i < n; i++) {
       auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
       tree.addLeaf(node);
     }
     auto hash2 = tree.getRoot()->getHash();
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 
   for (size_t n = 33; n <= 64; n++) {
@@ -52,13 +52,13 @@ BOOST_AUTO_TEST_CASE(HashGeneration)
                        [&] (const Node::Index&) {},
                        [&] (const Node::Index&,
                             const NonNegativeInteger&,
-                            ndn::ConstBufferPtr) {});
+                            const Sha256Digest&) {});
     for (size_t i = 32; i < n; i++) {
       auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
       tree.addLeaf(node);
     }
     auto hash2 = tree.getRoot()->getHash();
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 }
 
@@ -70,13 +70,13 @@ BOOST_AUTO_TEST_CASE(TreeGeneration)
                        [&] (const Node::Index&) {},
                        [&] (const Node::Index&,
                             const NonNegativeInteger&,
-                            ndn::ConstBufferPtr) {});
+                            const Sha256Digest&) {});
     for (size_t i = 0; i < n; i++) {
       auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
       tree.addLeaf(node);
     }
     auto hash2 = tree.getRoot()->getHash();
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 
   for (size_t n = 33; n <= 64; n++) {
@@ -85,25 +85,25 @@ BOOST_AUTO_TEST_CASE(TreeGeneration)
                        [&] (const Node::Index&) {},
                        [&] (const Node::Index&,
                             const NonNegativeInteger&,
-                            ndn::ConstBufferPtr) {});
+                            const Sha256Digest&) {});
     for (size_t i = 32; i < n; i++) {
       auto node = make_shared<Node>(i, 0, i + 1, Node::getEmptyHash());
       tree.addLeaf(node);
     }
     auto hash2 = tree.getRoot()->getHash();
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 
   for (size_t n = 513; n <= 1024; n++) {
     auto hash1 = TreeGenerator::getSubTreeBinary(Node::Index(0, 10), n)->getRoot()->getHash();
     auto hash2 = TreeGenerator::getHash(Node::Index(0, 10), n);
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 
   for (size_t n = 1025; n <= 2048; n++) {
     auto hash1 = TreeGenerator::getSubTreeBinary(Node::Index(1024, 10), n)->getRoot()->getHash();
     auto hash2 = TreeGenerator::getHash(Node::Index(1024, 10), n);
-    BOOST_CHECK_EQUAL_COLLECTIONS(hash1->begin(), hash1->end(), hash2->begin(), hash2->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash1.begin(), hash1.end(), hash2.begin(), hash2.end());
   }
 }
 
@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/lru-cache.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestLruCache)
+
+BOOST_AUTO_TEST_CASE(Cost)
+{
+  LruCache<int, int> cache(10);
+
+  cache.insert(1, 10, 4);
+  cache.insert(2, 20, 4);
+  BOOST_CHECK_EQUAL(cache.getSize(), 8);
+  BOOST_CHECK_EQUAL(cache.find(1), 10);
+
+  // 2 is the least recently used, and 1 and 3 fit
+  cache.insert(3, 30, 6);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 2);
+  BOOST_CHECK_EQUAL(cache.getSize(), 10);
+  BOOST_CHECK_EQUAL(cache.find(2), 0);
+
+  // a value which costs more than the capacity replaces nothing but the old value
+  cache.insert(1, 11, 11);
+  BOOST_CHECK_EQUAL(cache.find(1), 0);
+  BOOST_CHECK_EQUAL(cache.getSize(), 6);
+
+  cache.erase(3);
+  BOOST_CHECK_EQUAL(cache.getNEntries(), 0);
+  BOOST_CHECK_EQUAL(cache.getSize(), 0);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
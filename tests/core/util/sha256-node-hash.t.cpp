@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/sha256-node-hash.hpp"
+#include "node.hpp"
+
+#include <ndn-cxx/util/digest.hpp>
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestSha256NodeHash)
+
+/**
+ * @brief Hash a node the way the tree was originally hashed, with ndn::util::Sha256
+ */
+static Sha256Digest
+getExpectedHash(uint64_t level, uint64_t seqNo, const Sha256Digest& left, const Sha256Digest& right)
+{
+  ndn::util::Sha256 sha256;
+  sha256 << level << seqNo;
+  sha256.update(left.data(), left.size());
+  sha256.update(right.data(), right.size());
+  ndn::ConstBufferPtr buffer = sha256.computeDigest();
+
+  Sha256Digest digest;
+  BOOST_REQUIRE(toSha256Digest(buffer->buf(), buffer->size(), digest));
+  return digest;
+}
+
+class NodeHashFixture
+{
+public:
+  NodeHashFixture()
+  {
+    // children with distinct hashes, and levels/seqNos that use all 8 bytes
+    for (uint64_t i = 0; i < N_JOBS; i++) {
+      children.push_back(computeSha256Digest(reinterpret_cast<const uint8_t*>(&i), sizeof(i)));
+      levels.push_back(i % 64);
+      seqNos.push_back(0x0123456789abcdefULL * (i + 1));
+    }
+  }
+
+  std::vector<Sha256NodeHashJob>
+  makeJobs(size_t nJobs, std::vector<Sha256Digest>& results) const
+  {
+    results.assign(nJobs, Sha256Digest());
+
+    std::vector<Sha256NodeHashJob> jobs;
+    for (size_t i = 0; i < nJobs; i++)
+      jobs.push_back({levels[i], seqNos[i], &children[i], &children[N_JOBS - 1 - i], &results[i]});
+    return jobs;
+  }
+
+  void
+  checkResults(const std::vector<Sha256Digest>& results) const
+  {
+    for (size_t i = 0; i < results.size(); i++) {
+      BOOST_CHECK(results[i] == getExpectedHash(levels[i], seqNos[i],
+                                                children[i], children[N_JOBS - 1 - i]));
+    }
+  }
+
+public:
+  static const size_t N_JOBS = 50;
+
+  std::vector<Sha256Digest> children;
+  std::vector<uint64_t> levels;
+  std::vector<uint64_t> seqNos;
+};
+
+BOOST_FIXTURE_TEST_CASE(Kernels, NodeHashFixture)
+{
+  BOOST_CHECK(isSha256KernelSupported(Sha256Kernel::SCALAR));
+  BOOST_CHECK(isSha256KernelSupported(Sha256Kernel::LIBRARY));
+  BOOST_CHECK(isSha256KernelSupported(getDefaultSha256Kernel()));
+  BOOST_CHECK(getDefaultSha256Kernel() != Sha256Kernel::SCALAR);
+
+  for (auto kernel : {Sha256Kernel::SCALAR, Sha256Kernel::LIBRARY, Sha256Kernel::SHA_NI,
+                      Sha256Kernel::AVX2, Sha256Kernel::AVX512}) {
+    if (!isSha256KernelSupported(kernel)) {
+      BOOST_TEST_MESSAGE("kernel " << static_cast<int>(kernel) << " is not supported");
+      continue;
+    }
+
+    // batch sizes below, at and across the lane counts of all kernels
+    for (size_t nJobs : {0, 1, 3, 8, 9, 16, 17, 31, 50}) {
+      std::vector<Sha256Digest> results;
+      auto jobs = makeJobs(nJobs, results);
+      computeNodeHashes(jobs.data(), jobs.size(), kernel);
+      checkResults(results);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(DefaultKernel, NodeHashFixture)
+{
+  for (size_t nJobs = 0; nJobs <= N_JOBS; nJobs++) {
+    std::vector<Sha256Digest> results;
+    auto jobs = makeJobs(nJobs, results);
+    computeNodeHashes(jobs.data(), jobs.size());
+    checkResults(results);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NodeHash)
+{
+  Sha256Digest left = Node::getEmptyHash();
+  Sha256Digest right = computeSha256Digest(left.data(), left.size());
+
+  Node::Index index(1024, 10);
+  BOOST_CHECK(Node::computeHash(index, left, right) == getExpectedHash(10, 1024, left, right));
+  BOOST_CHECK(Node::computeHash(index, right, left) == getExpectedHash(10, 1024, right, left));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/worker-pool.hpp"
+
+#include "boost-test.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestWorkerPool)
+
+BOOST_AUTO_TEST_CASE(Inline)
+{
+  WorkerPool pool;
+  BOOST_CHECK_EQUAL(pool.getNThreads(), 0);
+
+  std::thread::id threadId;
+  pool.post([&] { threadId = std::this_thread::get_id(); });
+  BOOST_CHECK(threadId == std::this_thread::get_id());
+  BOOST_CHECK_EQUAL(pool.getQueueDepth(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Threads)
+{
+  std::atomic<size_t> nDone(0);
+  {
+    WorkerPool pool(4);
+    BOOST_CHECK_EQUAL(pool.getNThreads(), 4);
+
+    for (size_t i = 0; i < 1000; i++)
+      pool.post([&] { nDone++; });
+
+    for (size_t i = 0; i < 5000 && nDone < 1000; i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    BOOST_CHECK_EQUAL(nDone, 1000);
+    BOOST_CHECK_EQUAL(pool.getQueueDepth(), 0);
+  }
+
+  // the tasks which have not started are dropped with the pool
+  std::atomic<bool> isBlocked(true);
+  std::atomic<bool> hasStarted(false);
+  std::thread unblock;
+  {
+    WorkerPool pool(1);
+    pool.post([&] {
+        hasStarted = true;
+        while (isBlocked)
+          std::this_thread::yield();
+      });
+    pool.post([&] { nDone++; });
+
+    while (!hasStarted)
+      std::this_thread::yield();
+    BOOST_CHECK_EQUAL(pool.getQueueDepth(), 1);
+
+    unblock = std::thread([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        isBlocked = false;
+      });
+  }
+  unblock.join();
+  BOOST_CHECK_EQUAL(nDone, 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
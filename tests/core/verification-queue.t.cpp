@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "verification-queue.hpp"
+
+#include "boost-test.hpp"
+
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestVerificationQueue)
+
+BOOST_AUTO_TEST_CASE(Inline)
+{
+  boost::asio::io_service io;
+  VerificationQueue queue(io, 0);
+  BOOST_CHECK_EQUAL(queue.getNThreads(), 0);
+
+  std::vector<int> verdicts;
+  for (int i = 0; i < 3; i++)
+    queue.submit([i] { return i; }, [&] (int verdict) { verdicts.push_back(verdict); });
+
+  std::vector<int> expected{0, 1, 2};
+  BOOST_CHECK_EQUAL_COLLECTIONS(verdicts.begin(), verdicts.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(queue.getNUndelivered(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Ordering)
+{
+  boost::asio::io_service io;
+  VerificationQueue queue(io, 4);
+  BOOST_CHECK_EQUAL(queue.getNThreads(), 4);
+
+  // the early submissions take the longest, so they complete after the later ones
+  const int N_SUBMISSIONS = 40;
+  std::vector<int> verdicts;
+  for (int i = 0; i < N_SUBMISSIONS; i++) {
+    queue.submit([i] {
+        std::this_thread::sleep_for(std::chrono::microseconds(100 * (N_SUBMISSIONS - i)));
+        return i;
+      },
+      [&] (int verdict) { verdicts.push_back(verdict); });
+  }
+
+  for (int i = 0; i < 5000 && verdicts.size() < N_SUBMISSIONS; i++) {
+    io.poll();
+    io.reset();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  BOOST_REQUIRE_EQUAL(verdicts.size(), N_SUBMISSIONS);
+  for (int i = 0; i < N_SUBMISSIONS; i++)
+    BOOST_CHECK_EQUAL(verdicts[i], i);
+  BOOST_CHECK_EQUAL(queue.getNUndelivered(), 0);
+  BOOST_CHECK_EQUAL(queue.getQueueDepth(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(DroppedVerdicts)
+{
+  boost::asio::io_service io;
+  bool isDelivered = false;
+  {
+    VerificationQueue queue(io, 1);
+    queue.submit([] { return 0; }, [&] (int) { isDelivered = true; });
+  }
+
+  // the verdict was posted, but the queue is gone
+  io.poll();
+  BOOST_CHECK(!isDelivered);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace delorean
+} // namespace ndn
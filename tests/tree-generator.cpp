@@ -27,9 +27,22 @@ namespace delorean {
 namespace tests {
 
 const Name TreeGenerator::LOGGER_NAME("/logger/name");
-ndn::ConstBufferPtr TreeGenerator::LEAF_HASH;
 
-ndn::ConstBufferPtr
+/**
+ * The hashes are computed with ndn::util::Sha256 rather than Node::computeHash,
+ * so that the trees are checked against an independent implementation.
+ */
+static Sha256Digest
+computeDigest(ndn::util::Sha256& sha256)
+{
+  ndn::ConstBufferPtr buffer = sha256.computeDigest();
+
+  Sha256Digest digest;
+  BOOST_VERIFY(toSha256Digest(buffer->buf(), buffer->size(), digest));
+  return digest;
+}
+
+Sha256Digest
 TreeGenerator::getHash(const Node::Index& idx,
                        const NonNegativeInteger& nextLeafSeqNo,
                        bool useEmpty)
@@ -54,19 +67,19 @@ TreeGenerator::getHash(const Node::Index& idx,
   auto hash1 = getHash(Node::Index(leftChildSeqNo, idx.level - 1),
                        nextLeafSeqNo,
                        useEmpty);
-  sha256.update(hash1->buf(), hash1->size());
+  sha256.update(hash1.data(), hash1.size());
 
   if (nextLeafSeqNo > rightChildSeqNo) {
     auto hash2 = getHash(Node::Index(rightChildSeqNo, idx.level - 1),
                          nextLeafSeqNo,
                          useEmpty);
-    sha256.update(hash2->buf(), hash2->size());
+    sha256.update(hash2.data(), hash2.size());
   }
   else {
     auto hash2 = Node::getEmptyHash();
-    sha256.update(hash2->buf(), hash2->size());
+    sha256.update(hash2.data(), hash2.size());
   }
-  return sha256.computeDigest();
+  return computeDigest(sha256);
 }
 
 shared_ptr<SubTreeBinary>
@@ -78,10 +91,10 @@ TreeGenerator::getSubTreeBinary(const Node::Index& index,
                                             [&] (const Node::Index&) {},
                                             [&] (const Node::Index&,
                                                  const NonNegativeInteger&,
-                                                 ndn::ConstBufferPtr) {});
+                                                 const Sha256Digest&) {});
 
   size_t leafLevel = index.level + 1 - SubTreeBinary::SUB_TREE_DEPTH;
-  NonNegativeInteger step = 1 << leafLevel;
+  NonNegativeInteger step = static_cast<NonNegativeInteger>(1) << leafLevel;
 
   for (NonNegativeInteger i = index.seqNo; i < nextLeafSeqNo - step; i += step) {
     auto node = make_shared<Node>(i, leafLevel, i + step,
@@ -101,14 +114,14 @@ TreeGenerator::getSubTreeBinary(const Node::Index& index,
   return subtree;
 }
 
-ndn::ConstBufferPtr
+const Sha256Digest&
 TreeGenerator::getLeafHash()
 {
-  if (LEAF_HASH == nullptr) {
+  static const Sha256Digest LEAF_HASH = [] {
     ndn::util::Sha256 sha256;
     sha256 << 1;
-    LEAF_HASH = sha256.computeDigest();
-  }
+    return computeDigest(sha256);
+  }();
 
   return LEAF_HASH;
 }
@@ -28,10 +28,20 @@ namespace ndn {
 namespace delorean {
 namespace tests {
 
+/**
+ * @brief The levels and leaf counts of the test trees for the configured subtree depth
+ *
+ * A subtree spans STEP levels, so a subtree peaking at level STEP has N_LEAVES_1 leaves and one
+ * peaking at level 2 * STEP has N_LEAVES_2 leaves: 5, 32 and 1024 at the default depth.
+ */
+const size_t STEP = SubTreeBinary::STEP;
+const NonNegativeInteger N_LEAVES_1 = static_cast<NonNegativeInteger>(1) << STEP;
+const NonNegativeInteger N_LEAVES_2 = N_LEAVES_1 << STEP;
+
 class TreeGenerator
 {
 public:
-  static ndn::ConstBufferPtr
+  static Sha256Digest
   getHash(const Node::Index& idx,
           const NonNegativeInteger& nextLeafSeqNo,
           bool useEmpty = true);
@@ -41,14 +51,11 @@ public:
                    const NonNegativeInteger& nextLeafSeqNo,
                    bool useEmpty = true);
 
-  static ndn::ConstBufferPtr
+  static const Sha256Digest&
   getLeafHash();
 
 public:
   static const Name LOGGER_NAME;
-
-private:
-  static ndn::ConstBufferPtr LEAF_HASH;
 };
 
 } // namespace tests
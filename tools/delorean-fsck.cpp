@@ -0,0 +1,531 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.hpp"
+#include "../core/conf/config-file.hpp"
+#include "../core/db.hpp"
+#include "../core/sub-tree-binary.hpp"
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief Rebuild the subtrees of a log from its leaves and compare them with the stored ones
+ *
+ * The leaves are streamed with one cursor, in batches of complete base subtrees.  A batch is
+ * hashed and its base subtrees are rebuilt on all threads while the next batch is read.  The
+ * upper levels are then rebuilt bottom-up from the root hashes of the level below, each level
+ * in parallel, and the pending subtrees last, as MerkleTree::loadFrontier chains them.
+ *
+ * The root hashes of the complete subtrees are kept in memory, which takes one byte per leaf
+ * for the level above the leaves.
+ */
+class TreeChecker : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @brief A subtree whose stored Data is missing or differs from the rebuilt one
+   */
+  struct Mismatch
+  {
+    Node::Index peakIndex;
+    bool isComplete;
+    bool isMissing;
+    NonNegativeInteger nextLeafSeqNo;
+    shared_ptr<Data> data;
+  };
+
+public:
+  TreeChecker(Db& db, const Name& treeName, size_t nThreads);
+
+  /**
+   * @brief Rebuild and check the complete base subtrees, and keep the hashes of the leaves
+   *        after the last one
+   *
+   * @return the number of leaves
+   */
+  NonNegativeInteger
+  checkLeaves();
+
+  /**
+   * @brief Rebuild and check the complete subtrees above the base level
+   *
+   * @pre checkLeaves() has been called
+   */
+  void
+  checkUpperLevels();
+
+  /**
+   * @brief Rebuild and check the pending subtrees, from the root subtree down
+   *
+   * @pre checkUpperLevels() has been called
+   */
+  void
+  checkPendingSubTrees();
+
+  /**
+   * @brief Write the rebuilt Data of the mismatched subtrees, and the frontier, in one
+   *        transaction
+   */
+  void
+  repair();
+
+  const std::vector<Mismatch>&
+  getMismatches() const
+  {
+    return m_mismatches;
+  }
+
+  uint64_t
+  getNCheckedSubTrees() const
+  {
+    return m_nCheckedSubTrees;
+  }
+
+private:
+  /**
+   * @brief Run @p job on [0, @p n) split into one contiguous range per thread
+   */
+  void
+  runInParallel(size_t n, const function<void(size_t first, size_t last)>& job) const;
+
+  /**
+   * @brief Hash a batch of leaves and rebuild the complete base subtrees it contains
+   */
+  void
+  processBatch(const std::vector<Leaf>& leaves, const NonNegativeInteger& firstSeqNo);
+
+  /**
+   * @brief Rebuild @p nSubTrees adjacent complete subtrees peaking at @p level, from the
+   *        hashes of their leaves, and write their root hashes to @p rootHashes
+   */
+  void
+  checkSubTrees(size_t level, const NonNegativeInteger& firstSeqNo, size_t nSubTrees,
+                const Sha256Digest* leafHashes, Sha256Digest* rootHashes);
+
+  void
+  compare(const SubTreeBinary& subtree, bool isComplete);
+
+private:
+  static const size_t BATCH_SIZE;
+  static const NonNegativeInteger PROGRESS_INTERVAL;
+
+  Db& m_db;
+  Name m_treeName;
+  size_t m_nThreads;
+
+  NonNegativeInteger m_nLeaves;
+  /// the root hashes of the complete subtrees, by peak level / STEP from 1 up
+  std::vector<std::vector<Sha256Digest>> m_rootHashes;
+  /// the leaves after the last complete base subtree
+  std::vector<Sha256Digest> m_tailLeafHashes;
+
+  shared_ptr<Frontier> m_frontier;
+
+  std::atomic<uint64_t> m_nCheckedSubTrees;
+  std::mutex m_mismatchesMutex;
+  std::vector<Mismatch> m_mismatches;
+};
+
+const size_t TreeChecker::BATCH_SIZE = 2048 << SubTreeBinary::STEP;
+const NonNegativeInteger TreeChecker::PROGRESS_INTERVAL = 1 << 24;
+
+TreeChecker::TreeChecker(Db& db, const Name& treeName, size_t nThreads)
+  : m_db(db)
+  , m_treeName(treeName)
+  , m_nThreads(std::max<size_t>(nThreads, 1))
+  , m_nLeaves(0)
+  , m_nCheckedSubTrees(0)
+{
+}
+
+NonNegativeInteger
+TreeChecker::checkLeaves()
+{
+  typedef time::steady_clock Clock;
+
+  NonNegativeInteger nLeaves = m_db.getNextLeafSeqNo();
+  m_rootHashes.assign(2, std::vector<Sha256Digest>());
+  m_rootHashes[1].resize(nLeaves >> SubTreeBinary::STEP);
+
+  std::vector<Leaf> batch;
+  batch.reserve(BATCH_SIZE);
+  NonNegativeInteger batchSeqNo = 0;
+  NonNegativeInteger nextSeqNo = 0;
+  std::future<void> pending;
+
+  Clock::TimePoint start = Clock::now();
+  NonNegativeInteger nextProgress = PROGRESS_INTERVAL;
+
+  // the next batch is read while the previous one is processed
+  auto dispatch = [&] {
+    if (pending.valid())
+      pending.get();
+
+    auto leaves = make_shared<std::vector<Leaf>>();
+    leaves->swap(batch);
+    batch.reserve(BATCH_SIZE);
+
+    NonNegativeInteger firstSeqNo = batchSeqNo;
+    batchSeqNo = nextSeqNo;
+    pending = std::async(std::launch::async, [this, leaves, firstSeqNo] {
+        processBatch(*leaves, firstSeqNo);
+      });
+
+    if (nextSeqNo >= nextProgress) {
+      double seconds = time::duration_cast<time::milliseconds>(Clock::now() - start).count() /
+                       1000.0;
+      std::cerr << "  " << nextSeqNo << " leaves read, "
+                << static_cast<uint64_t>(nextSeqNo / std::max(seconds, 0.001))
+                << " leaves/sec" << std::endl;
+      nextProgress += PROGRESS_INTERVAL;
+    }
+  };
+
+  m_db.getLeafRange(0, nLeaves, [&] (const Leaf& leaf, const Block&) {
+      if (leaf.getDataSeqNo() != nextSeqNo)
+        throw Error("leaf " + boost::lexical_cast<std::string>(nextSeqNo) + " is missing");
+
+      batch.push_back(leaf);
+      nextSeqNo++;
+
+      if (batch.size() == BATCH_SIZE)
+        dispatch();
+    });
+
+  if (nextSeqNo != nLeaves)
+    throw Error("leaf " + boost::lexical_cast<std::string>(nextSeqNo) + " is missing");
+
+  if (!batch.empty())
+    dispatch();
+  if (pending.valid())
+    pending.get();
+
+  m_nLeaves = nLeaves;
+  return nLeaves;
+}
+
+void
+TreeChecker::checkUpperLevels()
+{
+  for (size_t level = 2 * SubTreeBinary::STEP; ; level += SubTreeBinary::STEP) {
+    size_t nSubTrees = level < 64 ? static_cast<size_t>(m_nLeaves >> level) : 0;
+    if (nSubTrees == 0)
+      break;
+
+    const std::vector<Sha256Digest>& leafHashes = m_rootHashes.back();
+    std::vector<Sha256Digest> rootHashes(nSubTrees);
+    checkSubTrees(level, 0, nSubTrees, leafHashes.data(), rootHashes.data());
+    m_rootHashes.push_back(std::move(rootHashes));
+  }
+}
+
+void
+TreeChecker::checkPendingSubTrees()
+{
+  const size_t step = SubTreeBinary::STEP;
+
+  // the root subtree is the lowest one which cannot be complete yet
+  size_t rootLevel = step;
+  while (rootLevel < 64 && (m_nLeaves >> rootLevel) != 0)
+    rootLevel += step;
+
+  NonNegativeInteger nextLeafSeqNo = 0;
+  Sha256Digest rootHash = Node::getEmptyHash();
+
+  std::vector<shared_ptr<SubTreeBinary>> subtrees;
+  std::vector<std::vector<Sha256Digest>> subtreeLeafHashes;
+  for (size_t level = rootLevel; level >= step; level -= step) {
+    size_t leafLevel = level - step;
+    NonNegativeInteger peakSeqNo = (m_nLeaves >> level) << level;
+    size_t nLeaves = static_cast<size_t>((m_nLeaves - peakSeqNo) >> leafLevel);
+
+    const Sha256Digest* first = leafLevel == 0 ?
+      m_tailLeafHashes.data() :
+      m_rootHashes[leafLevel / step].data() + static_cast<size_t>(peakSeqNo >> leafLevel);
+    subtreeLeafHashes.push_back(std::vector<Sha256Digest>(first, first + nLeaves));
+
+    shared_ptr<SubTreeBinary> subtree;
+    if (subtrees.empty()) {
+      subtree = make_shared<SubTreeBinary>(m_treeName, Node::Index(peakSeqNo, level),
+        [] (const Node::Index&) {},
+        [&nextLeafSeqNo, &rootHash] (const Node::Index&,
+                                     const NonNegativeInteger& seqNo,
+                                     const Sha256Digest& hash) {
+          nextLeafSeqNo = seqNo;
+          rootHash = hash;
+        });
+    }
+    else {
+      shared_ptr<SubTreeBinary> parentTree = subtrees.back();
+      subtree = make_shared<SubTreeBinary>(m_treeName, Node::Index(peakSeqNo, level),
+        [] (const Node::Index&) {},
+        [parentTree] (const Node::Index&,
+                      const NonNegativeInteger& seqNo,
+                      const Sha256Digest& hash) {
+          parentTree->updateLeaf(seqNo, hash);
+        });
+    }
+    subtrees.push_back(subtree);
+  }
+
+  // from the root subtree down, the root of each subtree is propagated up
+  for (size_t i = 0; i < subtrees.size(); i++) {
+    const auto& leafHashes = subtreeLeafHashes[i];
+    if (!leafHashes.empty())
+      subtrees[i]->addLeaves(subtrees[i]->getPeakIndex().seqNo, leafHashes.data(),
+                             leafHashes.size());
+  }
+
+  if (nextLeafSeqNo != m_nLeaves)
+    throw Error("the rebuilt tree does not cover all the leaves");
+
+  m_frontier = make_shared<Frontier>(nextLeafSeqNo, rootHash);
+  for (size_t i = 0; i < subtrees.size(); i++) {
+    m_frontier->addSubTree(subtrees[i]->getPeakIndex(), subtreeLeafHashes[i]);
+    compare(*subtrees[i], false);
+  }
+}
+
+void
+TreeChecker::repair()
+{
+  m_db.runInTransaction([this] {
+      for (const auto& mismatch : m_mismatches) {
+        m_db.replaceSubTreeData(mismatch.peakIndex.level, mismatch.peakIndex.seqNo,
+                                *mismatch.data, mismatch.isComplete, mismatch.nextLeafSeqNo);
+      }
+
+      if (m_frontier != nullptr)
+        m_db.insertFrontier(*m_frontier);
+    });
+}
+
+void
+TreeChecker::runInParallel(size_t n, const function<void(size_t first, size_t last)>& job) const
+{
+  size_t nThreads = std::min(m_nThreads, n);
+  if (nThreads <= 1) {
+    job(0, n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < nThreads; i++)
+    threads.emplace_back(job, n * i / nThreads, n * (i + 1) / nThreads);
+  for (auto& thread : threads)
+    thread.join();
+}
+
+void
+TreeChecker::processBatch(const std::vector<Leaf>& leaves, const NonNegativeInteger& firstSeqNo)
+{
+  std::vector<Sha256Digest> leafHashes(leaves.size());
+  runInParallel(leaves.size(), [&] (size_t first, size_t last) {
+      for (size_t i = first; i < last; i++)
+        leafHashes[i] = leaves[i].getHash();
+    });
+
+  // batches are made of complete base subtrees, except the last one
+  size_t nSubTrees = leaves.size() >> SubTreeBinary::STEP;
+  if (nSubTrees > 0)
+    checkSubTrees(SubTreeBinary::STEP, firstSeqNo, nSubTrees, leafHashes.data(),
+                  m_rootHashes[1].data() + static_cast<size_t>(firstSeqNo >> SubTreeBinary::STEP));
+
+  m_tailLeafHashes.assign(leafHashes.begin() + (nSubTrees << SubTreeBinary::STEP),
+                          leafHashes.end());
+}
+
+void
+TreeChecker::checkSubTrees(size_t level, const NonNegativeInteger& firstSeqNo, size_t nSubTrees,
+                           const Sha256Digest* leafHashes, Sha256Digest* rootHashes)
+{
+  const size_t nLeavesPerSubTree = static_cast<size_t>(1) << SubTreeBinary::STEP;
+  const NonNegativeInteger range = static_cast<NonNegativeInteger>(1) << level;
+
+  runInParallel(nSubTrees, [&] (size_t first, size_t last) {
+      for (size_t i = first; i < last; i++) {
+        NonNegativeInteger peakSeqNo = firstSeqNo + i * range;
+        SubTreeBinary subtree(m_treeName, Node::Index(peakSeqNo, level),
+                              [] (const Node::Index&) {},
+                              [] (const Node::Index&,
+                                  const NonNegativeInteger&,
+                                  const Sha256Digest&) {});
+        subtree.addLeaves(peakSeqNo, leafHashes + i * nLeavesPerSubTree, nLeavesPerSubTree);
+
+        rootHashes[i] = subtree.getRootHash();
+        compare(subtree, true);
+      }
+    });
+}
+
+void
+TreeChecker::compare(const SubTreeBinary& subtree, bool isComplete)
+{
+  const Node::Index& peakIndex = subtree.getPeakIndex();
+  auto data = subtree.encode();
+  auto stored = m_db.getSubTreeData(peakIndex.level, peakIndex.seqNo);
+  m_nCheckedSubTrees++;
+
+  if (stored != nullptr && stored->wireEncode() == data->wireEncode())
+    return;
+
+  Mismatch mismatch;
+  mismatch.peakIndex = peakIndex;
+  mismatch.isComplete = isComplete;
+  mismatch.isMissing = stored == nullptr;
+  mismatch.nextLeafSeqNo = subtree.getNextLeafSeqNo();
+  mismatch.data = data;
+
+  std::lock_guard<std::mutex> lock(m_mismatchesMutex);
+  m_mismatches.push_back(mismatch);
+}
+
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  namespace po = boost::program_options;
+  using namespace ndn::delorean;
+  typedef ndn::time::steady_clock Clock;
+
+  std::string configFile;
+  size_t nThreads = std::thread::hardware_concurrency();
+
+  po::options_description description("General Usage\n"
+                                      "  delorean-fsck [-h] [-j threads] [--repair] -c config\n"
+                                      "Rebuild the log tree from the leaves and check the stored "
+                                      "subtrees, the exit status is 2 if any does not match\n"
+                                      "General options");
+  description.add_options()
+    ("help,h", "produce help message")
+    ("config,c", po::value<std::string>(&configFile), "the logger config file")
+    ("threads,j", po::value<size_t>(&nThreads), "number of hashing threads, "
+                                                "all the cores by default")
+    ("repair", "write the rebuilt subtrees in place of the ones which do not match")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, description), vm);
+    po::notify(vm);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    std::cerr << description << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help") != 0) {
+    std::cerr << description << std::endl;
+    return 0;
+  }
+
+  if (vm.count("config") == 0) {
+    std::cerr << "ERROR: config file is not specified" << std::endl;
+    std::cerr << description << std::endl;
+    return 1;
+  }
+
+  nThreads = std::max<size_t>(nThreads, 1);
+
+  try {
+    conf::ConfigFile conf(configFile);
+    conf.parse();
+
+    // the cursor and each checking thread get their own read connection
+    conf::ConfigSection dbConfig = conf.getDbConfig();
+    dbConfig.put("read-connections", nThreads + 1);
+
+    Db db;
+    db.open(conf.getDbDir(), dbConfig);
+
+    ndn::Name treeName = conf.getLoggerName();
+    treeName.append("tree");
+    TreeChecker checker(db, treeName, nThreads);
+
+    Clock::TimePoint start = Clock::now();
+    NonNegativeInteger nLeaves = checker.checkLeaves();
+    Clock::TimePoint leavesDone = Clock::now();
+    checker.checkUpperLevels();
+    checker.checkPendingSubTrees();
+    Clock::TimePoint end = Clock::now();
+
+    double leafSeconds =
+      ndn::time::duration_cast<ndn::time::milliseconds>(leavesDone - start).count() / 1000.0;
+    double totalSeconds =
+      ndn::time::duration_cast<ndn::time::milliseconds>(end - start).count() / 1000.0;
+
+    std::cout << nLeaves << " leaves, " << checker.getNCheckedSubTrees() << " subtrees checked in "
+              << totalSeconds << " s, "
+              << static_cast<uint64_t>(nLeaves / std::max(leafSeconds, 0.001))
+              << " leaves/sec" << std::endl;
+
+    const auto& mismatches = checker.getMismatches();
+    for (const auto& mismatch : mismatches) {
+      std::cout << (mismatch.isComplete ? "complete" : "pending") << " subtree "
+                << mismatch.peakIndex.level << "/" << mismatch.peakIndex.seqNo
+                << (mismatch.isMissing ? " is missing" : " does not match") << std::endl;
+    }
+
+    if (mismatches.empty())
+      return 0;
+
+    if (vm.count("repair") == 0) {
+      // pending subtrees lag behind the leaves appended after the last checkpoint, which the
+      // logger replays when it starts
+      std::cout << mismatches.size() << " subtrees to repair" << std::endl;
+      return 2;
+    }
+
+    checker.repair();
+    std::cout << mismatches.size() << " subtrees repaired" << std::endl;
+  }
+  catch (const std::runtime_error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
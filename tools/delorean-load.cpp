@@ -0,0 +1,678 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2017, Regents of the University of California
+ *
+ * This file is part of NDN DeLorean, An Authentication System for Data Archives in
+ * Named Data Networking.  See AUTHORS.md for complete list of NDN DeLorean authors
+ * and contributors.
+ *
+ * NDN DeLorean is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * NDN DeLorean is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with NDN
+ * DeLorean, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.hpp"
+#include "../core/logger.hpp"
+#include "../core/logger-response.hpp"
+#include "../core/sub-tree-binary.hpp"
+#include "../core/tlv.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/io.hpp>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/property_tree/info_parser.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace ndn {
+namespace delorean {
+
+/**
+ * @brief Drive a Logger in-process with a mix of log requests, subtree and leaf Interests
+ *
+ * The logger and the generator talk through a pair of DummyClientFace, so no forwarder is
+ * needed.  The generator plays both the requester and the producer of the logged Data, and
+ * keeps a fixed number of requests outstanding.  The signed requests and Data are prepared
+ * before the run, so that signing does not count towards the latency of the logger.
+ */
+class LoadGenerator : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  enum RequestKind {
+    LOG_REQUEST,
+    SUBTREE_REQUEST,
+    LEAF_REQUEST,
+    N_REQUEST_KINDS
+  };
+
+  struct Options
+  {
+    size_t nRequests;
+    size_t nWarmUpRequests;
+    size_t window;
+    /// relative weights of the request kinds, in RequestKind order
+    std::vector<double> weights;
+    size_t dataSize;
+    time::milliseconds timeout;
+    uint32_t seed;
+  };
+
+public:
+  LoadGenerator(const std::string& workDir, const Options& options);
+
+  /**
+   * @brief Write the logger config, create the identities and start the logger
+   *
+   * @p dbConfig and @p pipelineConfig are the db and pipeline sections of the logger config.
+   */
+  void
+  setUp(const conf::ConfigSection& dbConfig, const conf::ConfigSection& pipelineConfig);
+
+  /**
+   * @brief Run the warm-up log requests, then the measured mix
+   */
+  void
+  run();
+
+  void
+  printReport(std::ostream& os) const;
+
+private:
+  struct Outstanding
+  {
+    RequestKind kind;
+    time::steady_clock::TimePoint start;
+  };
+
+  struct Stats
+  {
+    std::vector<double> latencies;
+    uint64_t nTimeouts;
+  };
+
+  void
+  writeConfig(const std::string& configFile,
+              const conf::ConfigSection& dbConfig, const conf::ConfigSection& pipelineConfig);
+
+  /**
+   * @brief Prepare @p nRequests signed log requests, each for one signed Data
+   */
+  void
+  makeLogRequests(size_t nRequests);
+
+  Interest
+  makeLogRequest(const Name& dataName, const NonNegativeInteger& signerSeqNo);
+
+  void
+  runRequests(const std::vector<RequestKind>& kinds, bool isMeasured);
+
+  void
+  sendRequest(RequestKind kind);
+
+  /**
+   * @brief Run the ready handlers of both faces and pass the packets between them
+   *
+   * @return whether anything happened
+   */
+  bool
+  processEvents();
+
+  void
+  onResponse(const Data& data);
+
+  void
+  expireRequests();
+
+private:
+  std::string m_workDir;
+  Options m_options;
+  std::mt19937 m_random;
+
+  boost::asio::io_service m_io;
+  ndn::util::DummyClientFace m_loggerFace;
+  ndn::util::DummyClientFace m_clientFace;
+  std::unique_ptr<ndn::KeyChain> m_keyChain;
+  std::unique_ptr<Logger> m_logger;
+
+  Name m_loggerName;
+  Name m_producerName;
+  shared_ptr<ndn::IdentityCertificate> m_producerCert;
+  NonNegativeInteger m_producerSeqNo;
+  std::map<Name, shared_ptr<Data>> m_producedData;
+
+  std::vector<Interest> m_logRequests;
+  size_t m_nextLogRequest;
+  NonNegativeInteger m_nLeaves;
+
+  std::multimap<Name, Outstanding> m_outstanding;
+  bool m_isMeasured;
+  std::vector<Stats> m_stats;
+  uint64_t m_nAppends;
+  time::steady_clock::Duration m_duration;
+};
+
+LoadGenerator::LoadGenerator(const std::string& workDir, const Options& options)
+  : m_workDir(workDir)
+  , m_options(options)
+  , m_random(options.seed)
+  , m_loggerFace(m_io, {true, true})
+  , m_clientFace(m_io, {true, true})
+  , m_loggerName("/delorean-load/logger")
+  , m_producerName("/delorean-load/producer")
+  , m_producerSeqNo(0)
+  , m_nextLogRequest(0)
+  , m_nLeaves(0)
+  , m_isMeasured(false)
+  , m_stats(N_REQUEST_KINDS, Stats{std::vector<double>(), 0})
+  , m_nAppends(0)
+  , m_duration(0)
+{
+  m_options.weights.resize(N_REQUEST_KINDS, 0);
+}
+
+void
+LoadGenerator::setUp(const conf::ConfigSection& dbConfig,
+                     const conf::ConfigSection& pipelineConfig)
+{
+  namespace fs = boost::filesystem;
+
+  fs::path keysPath = fs::path(m_workDir) / "keys";
+  m_keyChain.reset(new ndn::KeyChain(std::string("pib-sqlite3:").append(keysPath.string()),
+                                     std::string("tpm-file:").append(keysPath.string())));
+
+  Name root("/delorean-load");
+  Name rootCertName = m_keyChain->createIdentity(root);
+  auto rootCert = m_keyChain->getCertificate(rootCertName);
+  ndn::io::save(*rootCert, (fs::path(m_workDir) / "trust-anchor.cert").string());
+
+  std::string configFile = (fs::path(m_workDir) / "delorean-load.conf").string();
+  writeConfig(configFile, dbConfig, pipelineConfig);
+
+  m_logger.reset(new Logger(m_loggerFace, configFile));
+  processEvents();
+
+  Timestamp rootTs = time::toUnixTimestamp(time::system_clock::now()).count() / 1000;
+  NonNegativeInteger rootSeqNo = m_logger->addSelfSignedCert(*rootCert, rootTs);
+
+  // the producer certificate is logged first, it is the signer of all the logged Data
+  Name producerKeyName = m_keyChain->generateRsaKeyPair(m_producerName);
+  std::vector<ndn::CertificateSubjectDescription> subjectDescription;
+  m_producerCert =
+    m_keyChain->prepareUnsignedIdentityCertificate(producerKeyName, root,
+                                                   time::system_clock::now(),
+                                                   time::system_clock::now() + time::days(1),
+                                                   subjectDescription);
+  m_keyChain->signByIdentity(*m_producerCert, root);
+  m_keyChain->addCertificate(*m_producerCert);
+
+  m_clientFace.setInterestFilter(m_producerCert->getName().getPrefix(-1),
+    [this] (const ndn::InterestFilter&, const Interest&) { m_clientFace.put(*m_producerCert); },
+    ndn::RegisterPrefixSuccessCallback(),
+    [] (const Name&, const std::string&) {});
+
+  m_clientFace.setInterestFilter(Name(m_producerName).append("data"),
+    [this] (const ndn::InterestFilter&, const Interest& interest) {
+      Name dataName = interest.getName();
+      if (!dataName.empty() && dataName.get(-1).isImplicitSha256Digest())
+        dataName = dataName.getPrefix(-1);
+
+      auto it = m_producedData.find(dataName);
+      if (it != m_producedData.end())
+        m_clientFace.put(*it->second);
+    },
+    ndn::RegisterPrefixSuccessCallback(),
+    [] (const Name&, const std::string&) {});
+  processEvents();
+
+  m_nLeaves = rootSeqNo + 1;
+  m_logRequests.push_back(makeLogRequest(m_producerCert->getFullName(), rootSeqNo));
+  runRequests(std::vector<RequestKind>(1, LOG_REQUEST), false);
+  if (m_nLeaves != rootSeqNo + 2)
+    throw Error("the producer certificate cannot be logged");
+
+  m_producerSeqNo = rootSeqNo + 1;
+}
+
+void
+LoadGenerator::run()
+{
+  std::vector<RequestKind> kinds(m_options.nRequests);
+  std::discrete_distribution<int> kindDistribution(m_options.weights.begin(),
+                                                   m_options.weights.end());
+  for (auto& kind : kinds)
+    kind = static_cast<RequestKind>(kindDistribution(m_random));
+
+  size_t nLogRequests = m_options.nWarmUpRequests +
+                        std::count(kinds.begin(), kinds.end(), LOG_REQUEST);
+  std::cerr << "preparing " << nLogRequests << " log requests" << std::endl;
+  makeLogRequests(nLogRequests);
+
+  // the warm-up completes some subtrees, so that every kind of request can be answered
+  std::cerr << "warming up" << std::endl;
+  runRequests(std::vector<RequestKind>(m_options.nWarmUpRequests, LOG_REQUEST), false);
+
+  std::cerr << "running " << kinds.size() << " requests" << std::endl;
+  time::steady_clock::TimePoint start = time::steady_clock::now();
+  runRequests(kinds, true);
+  m_duration = time::steady_clock::now() - start;
+}
+
+void
+LoadGenerator::printReport(std::ostream& os) const
+{
+  static const char* KIND_NAMES[] = {"log", "subtree", "leaf"};
+
+  double seconds = time::duration_cast<time::microseconds>(m_duration).count() / 1000000.0;
+  seconds = std::max(seconds, 0.000001);
+
+  os << std::left << std::setw(10) << "request" << std::right
+     << std::setw(10) << "count" << std::setw(10) << "timeouts"
+     << std::setw(12) << "p50 (ms)" << std::setw(12) << "p99 (ms)" << std::setw(12) << "p999 (ms)"
+     << std::endl;
+
+  uint64_t nResponses = 0;
+  for (size_t kind = 0; kind < N_REQUEST_KINDS; kind++) {
+    std::vector<double> latencies = m_stats[kind].latencies;
+    std::sort(latencies.begin(), latencies.end());
+    nResponses += latencies.size();
+
+    auto percentile = [&latencies] (double p) {
+      if (latencies.empty())
+        return 0.0;
+      size_t rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+      return latencies[std::min(std::max<size_t>(rank, 1), latencies.size()) - 1];
+    };
+
+    os << std::left << std::setw(10) << KIND_NAMES[kind] << std::right
+       << std::setw(10) << latencies.size() << std::setw(10) << m_stats[kind].nTimeouts
+       << std::fixed << std::setprecision(3)
+       << std::setw(12) << percentile(0.5) << std::setw(12) << percentile(0.99)
+       << std::setw(12) << percentile(0.999) << std::endl;
+  }
+
+  os << std::setprecision(1)
+     << "appends/sec:   " << m_nAppends / seconds << std::endl
+     << "responses/sec: " << nResponses / seconds << std::endl;
+}
+
+void
+LoadGenerator::writeConfig(const std::string& configFile,
+                           const conf::ConfigSection& dbConfig,
+                           const conf::ConfigSection& pipelineConfig)
+{
+  std::ofstream os(configFile.c_str());
+  os << "logger-name " << m_loggerName << "\n"
+     << "db-dir db\n"
+     // the producer Data must be signed by a key of a prefix of its name
+     << "policy\n"
+     << "{\n"
+     << "  rule\n"
+     << "  {\n"
+     << "    id \"Producer Rule\"\n"
+     << "    for data\n"
+     << "    checker\n"
+     << "    {\n"
+     << "      type customized\n"
+     << "      sig-type rsa-sha256\n"
+     << "      key-locator\n"
+     << "      {\n"
+     << "        type name\n"
+     << "        hyper-relation\n"
+     << "        {\n"
+     << "          k-regex ^([^<KEY>]*)<KEY>(<>*)<><ID-CERT>$\n"
+     << "          k-expand \\\\1\\\\2\n"
+     << "          h-relation is-strict-prefix-of\n"
+     << "          p-regex ^(<>*)$\n"
+     << "          p-expand \\\\1\n"
+     << "        }\n"
+     << "      }\n"
+     << "    }\n"
+     << "  }\n"
+     << "}\n"
+     // any certificate may sign a log request
+     << "validator\n"
+     << "{\n"
+     << "  rule\n"
+     << "  {\n"
+     << "    id \"Request Rule\"\n"
+     << "    for interest\n"
+     << "    filter\n"
+     << "    {\n"
+     << "      type name\n"
+     << "      name " << Name(m_loggerName).append("log") << "\n"
+     << "      relation is-strict-prefix-of\n"
+     << "    }\n"
+     << "    checker\n"
+     << "    {\n"
+     << "      type customized\n"
+     << "      sig-type rsa-sha256\n"
+     << "      key-locator\n"
+     << "      {\n"
+     << "        type name\n"
+     << "        regex ^[^<KEY>]*<KEY><>*<><ID-CERT>$\n"
+     << "      }\n"
+     << "    }\n"
+     << "  }\n"
+     << "  trust-anchor\n"
+     << "  {\n"
+     << "    type file\n"
+     << "    file-name \"trust-anchor.cert\"\n"
+     << "  }\n"
+     << "}\n";
+
+  conf::ConfigSection sections;
+  if (!dbConfig.empty())
+    sections.add_child("db", dbConfig);
+  if (!pipelineConfig.empty())
+    sections.add_child("pipeline", pipelineConfig);
+  boost::property_tree::write_info(os, sections);
+}
+
+void
+LoadGenerator::makeLogRequests(size_t nRequests)
+{
+  std::uniform_int_distribution<int> byteDistribution(0, 255);
+  std::vector<uint8_t> content(m_options.dataSize);
+
+  for (size_t i = 0; i < nRequests; i++) {
+    auto data = make_shared<Data>(Name(m_producerName).append("data").appendNumber(i));
+    for (auto& byte : content)
+      byte = static_cast<uint8_t>(byteDistribution(m_random));
+    data->setContent(content.data(), content.size());
+    m_keyChain->sign(*data, m_producerCert->getName());
+
+    m_producedData[data->getName()] = data;
+    m_logRequests.push_back(makeLogRequest(data->getFullName(), m_producerSeqNo));
+  }
+}
+
+Interest
+LoadGenerator::makeLogRequest(const Name& dataName, const NonNegativeInteger& signerSeqNo)
+{
+  Name requestName(m_loggerName);
+  requestName.append("log").append(dataName.wireEncode()).appendNumber(signerSeqNo);
+
+  // the signature timestamps keep increasing, so the requests must be sent in this order
+  Interest request(requestName);
+  m_keyChain->sign(request, m_producerCert->getName());
+  return request;
+}
+
+void
+LoadGenerator::runRequests(const std::vector<RequestKind>& kinds, bool isMeasured)
+{
+  m_isMeasured = isMeasured;
+
+  size_t nSent = 0;
+  time::steady_clock::TimePoint lastExpiry = time::steady_clock::now();
+  while (nSent < kinds.size() || !m_outstanding.empty()) {
+    while (nSent < kinds.size() && m_outstanding.size() < m_options.window)
+      sendRequest(kinds[nSent++]);
+
+    if (!processEvents())
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+
+    if (time::steady_clock::now() - lastExpiry > time::milliseconds(10)) {
+      expireRequests();
+      lastExpiry = time::steady_clock::now();
+    }
+  }
+}
+
+void
+LoadGenerator::sendRequest(RequestKind kind)
+{
+  Name name;
+  switch (kind) {
+  case LOG_REQUEST: {
+    BOOST_ASSERT(m_nextLogRequest < m_logRequests.size());
+    const Interest& request = m_logRequests[m_nextLogRequest++];
+    m_outstanding.insert(std::make_pair(request.getName(),
+                                        Outstanding{kind, time::steady_clock::now()}));
+    m_loggerFace.receive(request);
+    return;
+  }
+  case SUBTREE_REQUEST: {
+    // the first leaf of a base subtree, which the logger maps to that subtree
+    NonNegativeInteger nSubTrees = std::max<NonNegativeInteger>(m_nLeaves >> SubTreeBinary::STEP,
+                                                                1);
+    std::uniform_int_distribution<NonNegativeInteger> distribution(0, nSubTrees - 1);
+    name = Name(m_loggerName).append("tree").appendNumber(0)
+      .appendNumber(distribution(m_random) << SubTreeBinary::STEP);
+    break;
+  }
+  default: {
+    std::uniform_int_distribution<NonNegativeInteger> distribution(0, m_nLeaves - 1);
+    name = Name(m_loggerName).append("leaf").appendNumber(distribution(m_random));
+    break;
+  }
+  }
+
+  m_outstanding.insert(std::make_pair(name, Outstanding{kind, time::steady_clock::now()}));
+  m_loggerFace.receive(Interest(name));
+}
+
+bool
+LoadGenerator::processEvents()
+{
+  bool hasProcessed = m_io.poll() > 0;
+  m_io.reset();
+
+  std::vector<Interest> interests;
+  interests.swap(m_loggerFace.sentInterests);
+  for (const auto& interest : interests)
+    m_clientFace.receive(interest);
+
+  std::vector<Data> datas;
+  datas.swap(m_clientFace.sentData);
+  for (const auto& data : datas)
+    m_loggerFace.receive(data);
+
+  std::vector<Data> responses;
+  responses.swap(m_loggerFace.sentData);
+  for (const auto& response : responses)
+    onResponse(response);
+
+  m_clientFace.sentInterests.clear();
+  return hasProcessed || !interests.empty() || !datas.empty() || !responses.empty();
+}
+
+void
+LoadGenerator::onResponse(const Data& data)
+{
+  // the response is named after the request, possibly followed by more components
+  const Name& name = data.getName();
+  for (size_t length = name.size(); length > 0; length--) {
+    auto it = m_outstanding.find(name.getPrefix(length));
+    if (it == m_outstanding.end())
+      continue;
+
+    const Outstanding& request = it->second;
+    if (request.kind == LOG_REQUEST) {
+      LoggerResponse response;
+      response.wireDecode(data.getContent().blockFromValue());
+      for (size_t i = 0; i < response.getNEntries(); i++) {
+        if (response.getCode(i) == tlv::LogResponse_Accept) {
+          m_nLeaves = std::max(m_nLeaves, response.getDataSeqNo(i) + 1);
+          if (m_isMeasured)
+            m_nAppends++;
+        }
+      }
+    }
+
+    if (m_isMeasured) {
+      auto latency = time::steady_clock::now() - request.start;
+      m_stats[request.kind].latencies.push_back(
+        time::duration_cast<time::microseconds>(latency).count() / 1000.0);
+    }
+
+    m_outstanding.erase(it);
+    return;
+  }
+}
+
+void
+LoadGenerator::expireRequests()
+{
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  for (auto it = m_outstanding.begin(); it != m_outstanding.end(); ) {
+    if (now - it->second.start < m_options.timeout) {
+      it++;
+      continue;
+    }
+
+    if (m_isMeasured)
+      m_stats[it->second.kind].nTimeouts++;
+    it = m_outstanding.erase(it);
+  }
+}
+
+} // namespace delorean
+} // namespace ndn
+
+int
+main(int argc, char** argv)
+{
+  namespace po = boost::program_options;
+  namespace fs = boost::filesystem;
+  using namespace ndn::delorean;
+
+  std::string configFile;
+  std::string workDir;
+  size_t timeout = 4000;
+
+  LoadGenerator::Options options;
+  options.nRequests = 10000;
+  options.nWarmUpRequests = 2 << SubTreeBinary::STEP;
+  options.window = 64;
+  options.weights = {8, 1, 1};
+  options.dataSize = 256;
+  options.seed = 0;
+
+  po::options_description description("General Usage\n"
+                                      "  delorean-load [-h] [-c config] [options]\n"
+                                      "Run a logger in-process under a synthetic load and report "
+                                      "its latency and throughput\n"
+                                      "General options");
+  description.add_options()
+    ("help,h", "produce help message")
+    ("config,c", po::value<std::string>(&configFile),
+     "a logger config file, whose db and pipeline sections are used")
+    ("work-dir,d", po::value<std::string>(&workDir),
+     "a directory to create for the db and the keys, a temporary one by default")
+    ("requests,n", po::value<size_t>(&options.nRequests), "number of measured requests")
+    ("warm-up", po::value<size_t>(&options.nWarmUpRequests), "number of log requests before "
+                                                             "the measured ones")
+    ("window,w", po::value<size_t>(&options.window), "number of outstanding requests")
+    ("log", po::value<double>(&options.weights[LoadGenerator::LOG_REQUEST]),
+     "weight of log requests in the mix")
+    ("subtree", po::value<double>(&options.weights[LoadGenerator::SUBTREE_REQUEST]),
+     "weight of subtree Interests in the mix")
+    ("leaf", po::value<double>(&options.weights[LoadGenerator::LEAF_REQUEST]),
+     "weight of leaf Interests in the mix")
+    ("data-size", po::value<size_t>(&options.dataSize), "content size of the logged Data")
+    ("timeout", po::value<size_t>(&timeout), "milliseconds before a request is given up")
+    ("seed", po::value<uint32_t>(&options.seed), "seed of the request mix")
+    ;
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, description), vm);
+    po::notify(vm);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    std::cerr << description << std::endl;
+    return 1;
+  }
+
+  if (vm.count("help") != 0) {
+    std::cerr << description << std::endl;
+    return 0;
+  }
+
+  if (options.window == 0 ||
+      std::accumulate(options.weights.begin(), options.weights.end(), 0.0) <= 0) {
+    std::cerr << "ERROR: the window and the total weight must be positive" << std::endl;
+    return 1;
+  }
+  options.timeout = ndn::time::milliseconds(timeout);
+
+  ndn::delorean::conf::ConfigSection dbConfig;
+  ndn::delorean::conf::ConfigSection pipelineConfig;
+  if (!configFile.empty()) {
+    try {
+      ndn::delorean::conf::ConfigSection config;
+      boost::property_tree::read_info(configFile, config);
+      dbConfig = config.get_child("db", dbConfig);
+      pipelineConfig = config.get_child("pipeline", pipelineConfig);
+    }
+    catch (const boost::property_tree::info_parser_error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  bool isTemporary = workDir.empty();
+  if (isTemporary)
+    workDir = (fs::temp_directory_path() / fs::unique_path("delorean-load-%%%%-%%%%")).string();
+
+  if (!fs::create_directories(workDir)) {
+    std::cerr << "ERROR: work directory already exists: " << workDir << std::endl;
+    return 1;
+  }
+
+  // the logger keys go to the work directory rather than to the keychain of the user
+  fs::path home = fs::path(workDir) / "home";
+  fs::create_directories(home);
+  setenv("HOME", home.string().c_str(), 1);
+  setenv("NDN_CLIENT_PIB", "pib-sqlite3", 1);
+  setenv("NDN_CLIENT_TPM", "tpm-file", 1);
+
+  int status = 0;
+  try {
+    LoadGenerator generator(workDir, options);
+    generator.setUp(dbConfig, pipelineConfig);
+    generator.run();
+    generator.printReport(std::cout);
+  }
+  catch (const std::runtime_error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    status = 1;
+  }
+
+  if (isTemporary)
+    fs::remove_all(workDir);
+
+  return status;
+}